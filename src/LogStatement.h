@@ -53,6 +53,13 @@ public:
         return line.str();
     }
 
+    static const std::string mRelation(const std::string& relationName, const SrcLocation& srcLocation) {
+        const char* messageType = "@m-relation";
+        std::stringstream line;
+        line << messageType << ";" << relationName << ";" << srcLocation << ";";
+        return line.str();
+    }
+
     static const std::string tNonrecursiveRule(
             const std::string& relationName, const SrcLocation& srcLocation, const std::string& datalogText) {
         const char* messageType = "@t-nonrecursive-rule";
@@ -25,15 +25,15 @@
 
 namespace souffle::ast {
 
-enum class DirectiveType { input, output, printsize, limitsize };
+enum class DirectiveType { input, output, printsize, limitsize, query };
 
 // FIXME: I'm going crazy defining these. There has to be a library that does this boilerplate for us.
 std::ostream& operator<<(std::ostream& os, DirectiveType e);
 
 /**
  * @class Directive
- * @brief a directive has a type (e.g. input/output/printsize/limitsize), qualified relation name, and a key
- * value map for storing parameters of the directive.
+ * @brief a directive has a type (e.g. input/output/printsize/limitsize/query), qualified relation name, and a
+ * key value map for storing parameters of the directive.
  */
 class Directive : public Node {
 public:
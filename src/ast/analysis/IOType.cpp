@@ -23,6 +23,7 @@
 #include "ast/utility/Utils.h"
 #include "ast/utility/Visitor.h"
 #include "souffle/utility/StreamUtil.h"
+#include "souffle/utility/StringUtil.h"
 #include <cassert>
 #include <ostream>
 #include <vector>
@@ -48,6 +49,16 @@ void IOTypeAnalysis::run(const TranslationUnit& translationUnit) {
                 assert(directive.hasParameter("n") && "limitsize has no n directive");
                 limitSize[relation] = stoi(directive.getParameter("n"));
                 break;
+            case ast::DirectiveType::query:
+                queryRelations.insert(relation);
+                if (directive.hasParameter("seed")) {
+                    auto* seed = getRelation(
+                            program, QualifiedName(splitString(directive.getParameter("seed"), '.')));
+                    if (seed != nullptr) {
+                        querySeedRelations.insert(seed);
+                    }
+                }
+                break;
         }
     });
 }
@@ -58,6 +69,7 @@ void IOTypeAnalysis::print(std::ostream& os) const {
     os << "output relations: {" << join(outputRelations, ", ", show) << "}\n";
     os << "printsize relations: {" << join(printSizeRelations, ", ", show) << "}\n";
     os << "limitsize relations: {" << join(limitSizeRelations, ", ", show) << "}\n";
+    os << "query relations: {" << join(queryRelations, ", ", show) << "}\n";
 }
 
 }  // namespace souffle::ast::analysis
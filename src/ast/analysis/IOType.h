@@ -64,8 +64,19 @@ public:
             return 0;
     }
 
+    /** Relation answering a query entry point */
+    bool isQuery(const Relation* relation) const {
+        return queryRelations.count(relation) != 0;
+    }
+
+    /** Relation receiving the bound arguments of a query entry point */
+    bool isQuerySeed(const Relation* relation) const {
+        return querySeedRelations.count(relation) != 0;
+    }
+
     bool isIO(const Relation* relation) const {
-        return isInput(relation) || isOutput(relation) || isPrintSize(relation);
+        return isInput(relation) || isOutput(relation) || isPrintSize(relation) || isQuery(relation) ||
+               isQuerySeed(relation);
     }
 
 private:
@@ -73,6 +84,8 @@ private:
     std::set<const Relation*> outputRelations;
     std::set<const Relation*> printSizeRelations;
     std::set<const Relation*> limitSizeRelations;
+    std::set<const Relation*> queryRelations;
+    std::set<const Relation*> querySeedRelations;
     std::map<const Relation*, std::size_t> limitSize;
 };
 
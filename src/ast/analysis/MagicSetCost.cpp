@@ -0,0 +1,261 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file MagicSetCost.cpp
+ *
+ * Implements the cost model for the magic set transformation
+ *
+ ***********************************************************************/
+
+#include "ast/analysis/MagicSetCost.h"
+#include "ast/Atom.h"
+#include "ast/Clause.h"
+#include "ast/Program.h"
+#include "ast/QualifiedName.h"
+#include "ast/Relation.h"
+#include "ast/TranslationUnit.h"
+#include "ast/Variable.h"
+#include "ast/analysis/IOType.h"
+#include "ast/analysis/PrecedenceGraph.h"
+#include "ast/analysis/ProfileUse.h"
+#include "ast/utility/BindingStore.h"
+#include "ast/utility/Utils.h"
+#include "ast/utility/Visitor.h"
+#include "souffle/utility/StreamUtil.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace souffle::ast::analysis {
+
+namespace {
+
+/** Assumed number of tuples of relations without a profile */
+constexpr double defaultRelationSize = 1000.0;
+
+/** Factor by which the demand-driven cost has to undercut the bottom-up cost */
+constexpr double magicSetOverhead = 2.0;
+
+/** Bound on the number of rounds propagating demand through recursive relations */
+constexpr std::size_t maxDemandRounds = 64;
+
+/** Get the name of a relation as found in the profile, i.e. without internal prefixes */
+QualifiedName getProfileName(const QualifiedName& name) {
+    const auto& qualifiers = name.getQualifiers();
+    auto first = std::find_if(qualifiers.begin(), qualifiers.end(),
+            [](const std::string& qualifier) { return qualifier.empty() || qualifier[0] != '@'; });
+    if (first == qualifiers.end()) {
+        return name;
+    }
+    return QualifiedName(std::vector<std::string>(first, qualifiers.end()));
+}
+
+/** Estimated number of distinct keys of a relation with the given number of bound columns */
+double getDistinctKeys(double size, std::size_t bound, std::size_t arity) {
+    if (arity == 0) {
+        return 1.0;
+    }
+    return std::max(1.0, std::pow(size, static_cast<double>(bound) / arity));
+}
+
+/** Estimated number of tuples of a relation matching a key of the given number of bound columns */
+double getTuplesPerKey(double size, std::size_t bound, std::size_t arity) {
+    if (arity == 0) {
+        return std::min(size, 1.0);
+    }
+    return std::pow(size, static_cast<double>(arity - bound) / arity);
+}
+
+}  // namespace
+
+void MagicSetCostAnalysis::run(const TranslationUnit& translationUnit) {
+    const Program& program = translationUnit.getProgram();
+    const auto& ioTypes = *translationUnit.getAnalysis<IOTypeAnalysis>();
+    const auto& precedenceGraph = translationUnit.getAnalysis<PrecedenceGraphAnalysis>()->graph();
+    const auto& profileUse = *translationUnit.getAnalysis<ProfileUseAnalysis>();
+
+    for (const auto* rel : program.getRelations()) {
+        const QualifiedName profileName = getProfileName(rel->getQualifiedName());
+        double size = defaultRelationSize;
+        if (profileUse.hasRelationSize(profileName)) {
+            size = static_cast<double>(profileUse.getRelationSize(profileName));
+        }
+        sizes[rel] = std::max(1.0, size);
+    }
+
+    for (const auto* output : program.getRelations()) {
+        if (!ioTypes.isOutput(output) && !ioTypes.isPrintSize(output)) {
+            continue;
+        }
+
+        // Collect the output relation and all relations it depends on
+        std::set<const Relation*> dependencies;
+        std::vector<const Relation*> work = {output};
+        while (!work.empty()) {
+            const Relation* rel = work.back();
+            work.pop_back();
+            if (!dependencies.insert(rel).second) {
+                continue;
+            }
+            for (const auto* predecessor : precedenceGraph.predecessors(rel)) {
+                work.push_back(predecessor);
+            }
+        }
+
+        // Bottom-up evaluation computes every tuple of every dependency; the output relation
+        // itself is computed entirely either way
+        double bottomUpCost = 0;
+        for (const auto* rel : dependencies) {
+            if (rel != output && !ioTypes.isInput(rel)) {
+                bottomUpCost += getSize(rel);
+            }
+        }
+
+        double demandDrivenCost = estimateDemandDrivenCost(translationUnit, output);
+        bool selected = demandDrivenCost * magicSetOverhead < bottomUpCost;
+        if (selected) {
+            for (const auto* rel : dependencies) {
+                selectedRelations.insert(rel->getQualifiedName());
+            }
+        }
+        estimates.push_back({output->getQualifiedName(), bottomUpCost, demandDrivenCost, selected});
+    }
+}
+
+double MagicSetCostAnalysis::getSize(const Relation* rel) const {
+    auto it = sizes.find(rel);
+    return it != sizes.end() ? it->second : defaultRelationSize;
+}
+
+double MagicSetCostAnalysis::estimateDemandDrivenCost(
+        const TranslationUnit& translationUnit, const Relation* output) const {
+    const Program& program = translationUnit.getProgram();
+    const auto& ioTypes = *translationUnit.getAnalysis<IOTypeAnalysis>();
+
+    // Relations computed by rules may be adorned; others are evaluated as they are
+    auto isAdornable = [&](const Relation* rel) {
+        return rel != nullptr && !ioTypes.isInput(rel) && !getClauses(program, *rel).empty();
+    };
+
+    // Number of keys demanded from each adorned relation, per call site
+    using CallSite = std::pair<const Clause*, std::size_t>;
+    std::map<AdornedRelation, std::map<CallSite, double>> demand;
+    std::map<AdornedRelation, double> keys;
+    keys[{output, std::string(output->getArity(), 'f')}] = 1.0;
+
+    // Propagate demand until the number of keys stabilises
+    for (std::size_t round = 0; round < maxDemandRounds; round++) {
+        bool changed = false;
+        const auto currentKeys = keys;
+        for (const auto& [adornedRel, numKeys] : currentKeys) {
+            const auto& [rel, adornment] = adornedRel;
+            for (const auto* clause : getClauses(program, *rel)) {
+                // Bound arguments of the head are bound for the body
+                BindingStore bindings(clause);
+                const auto& headArgs = clause->getHead()->getArguments();
+                for (std::size_t i = 0; i < headArgs.size() && i < adornment.size(); i++) {
+                    const auto* var = as<ast::Variable>(headArgs[i]);
+                    if (var != nullptr && adornment[i] == 'b') {
+                        bindings.bindVariableWeakly(var->getName());
+                    }
+                }
+
+                // Follow the bindings through the body from left to right
+                double bindingsSoFar = numKeys;
+                const auto& literals = clause->getBodyLiterals();
+                for (std::size_t i = 0; i < literals.size(); i++) {
+                    const auto* atom = as<Atom>(literals[i]);
+                    if (atom == nullptr) {
+                        // Atoms nested in negations and aggregates are demanded entirely
+                        visit(*literals[i], [&](const Atom& nested) {
+                            const auto* nestedRel = getRelation(program, nested.getQualifiedName());
+                            if (isAdornable(nestedRel)) {
+                                std::string allFree(nested.getArity(), 'f');
+                                changed |= demand[{nestedRel, allFree}].insert({{clause, i}, 1.0}).second;
+                            }
+                        });
+                        continue;
+                    }
+
+                    const auto* atomRel = getRelation(program, atom->getQualifiedName());
+                    std::string atomAdornment;
+                    for (const auto* arg : atom->getArguments()) {
+                        atomAdornment += bindings.isBound(arg) ? 'b' : 'f';
+                    }
+                    const std::size_t arity = atomAdornment.size();
+                    const std::size_t bound = std::count(atomAdornment.begin(), atomAdornment.end(), 'b');
+                    const double size = getSize(atomRel);
+
+                    if (isAdornable(atomRel)) {
+                        double callKeys = 1.0;
+                        if (bound > 0) {
+                            callKeys = std::min(bindingsSoFar, getDistinctKeys(size, bound, arity));
+                        }
+                        double& siteKeys = demand[{atomRel, atomAdornment}][{clause, i}];
+                        if (callKeys > siteKeys * 1.001) {
+                            siteKeys = callKeys;
+                            changed = true;
+                        }
+                    }
+
+                    // Each binding so far joins with the matching tuples of the atom
+                    bindingsSoFar *= getTuplesPerKey(size, bound, arity);
+                    visit(*atom, [&](const ast::Variable& var) {
+                        bindings.bindVariableStrongly(var.getName());
+                    });
+                }
+            }
+        }
+
+        // Sum up the demand of all call sites
+        for (const auto& [adornedRel, sites] : demand) {
+            const auto& [rel, adornment] = adornedRel;
+            const std::size_t bound = std::count(adornment.begin(), adornment.end(), 'b');
+            double total = 0;
+            for (const auto& site : sites) {
+                total += site.second;
+            }
+            keys[adornedRel] = std::min(total, getDistinctKeys(getSize(rel), bound, adornment.size()));
+        }
+
+        if (!changed) {
+            break;
+        }
+    }
+
+    // Each adorned relation computes the tuples of the demanded keys and its magic relation
+    double cost = 0;
+    for (const auto& [adornedRel, numKeys] : keys) {
+        const auto& [rel, adornment] = adornedRel;
+        const std::size_t bound = std::count(adornment.begin(), adornment.end(), 'b');
+        const double size = getSize(rel);
+        if (rel == output) {
+            continue;
+        } else if (bound == 0) {
+            cost += size;
+        } else {
+            cost += std::min(size, numKeys * getTuplesPerKey(size, bound, adornment.size())) + numKeys;
+        }
+    }
+    return cost;
+}
+
+void MagicSetCostAnalysis::print(std::ostream& os) const {
+    os << "Magic set decisions:\n";
+    for (const auto& estimate : estimates) {
+        os << "  " << estimate.relation << ": bottom-up cost " << std::setprecision(6)
+           << estimate.bottomUpCost << ", demand-driven cost " << estimate.demandDrivenCost << " -> "
+           << (estimate.selected ? "magic set" : "bottom-up") << "\n";
+    }
+    os << "Relations selected for the magic set transformation:\n  ";
+    os << join(selectedRelations, ", ") << "\n";
+}
+
+}  // namespace souffle::ast::analysis
@@ -0,0 +1,98 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file MagicSetCost.h
+ *
+ * Cost model deciding which parts of a program benefit from the
+ * magic set transformation
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ast/QualifiedName.h"
+#include "ast/analysis/Analysis.h"
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::ast {
+class Relation;
+class TranslationUnit;
+
+namespace analysis {
+
+/**
+ * Analysis estimating, for each output relation, the cost of evaluating it bottom-up and
+ * the cost of evaluating it demand-driven after the magic set transformation.
+ *
+ * The bottom-up cost is the number of tuples computed for all relations the output relation
+ * depends on. The demand-driven cost follows the bindings (constants and variables bound in
+ * a sideways fashion) from the output relation down to its dependencies. Every relation
+ * reached with some bound arguments is estimated to compute only the tuples matching the
+ * demanded keys, plus the tuples of its magic relation. Relation sizes are taken from the
+ * profile given with `--profile-use`; relations without a profile are assumed to have a
+ * default size.
+ *
+ * An output relation is selected for the magic set transformation if its demand-driven cost
+ * is clearly lower than its bottom-up cost. The selection comprises the output relation and
+ * every relation it depends on.
+ */
+class MagicSetCostAnalysis : public Analysis {
+public:
+    /** Name of analysis */
+    static constexpr const char* name = "magic-set-cost";
+
+    MagicSetCostAnalysis() : Analysis(name) {}
+
+    void run(const TranslationUnit& translationUnit) override;
+
+    /** Output the cost estimates and decisions */
+    void print(std::ostream& os) const override;
+
+    /** Get the relations selected for the magic set transformation */
+    const std::set<QualifiedName>& getSelectedRelations() const {
+        return selectedRelations;
+    }
+
+private:
+    /** Relation with a binding pattern, e.g. (path, "bf") */
+    using AdornedRelation = std::pair<const Relation*, std::string>;
+
+    /** Estimated costs of an output relation */
+    struct Estimate {
+        QualifiedName relation;
+        double bottomUpCost;
+        double demandDrivenCost;
+        bool selected;
+    };
+
+    /** Estimated number of tuples of a relation */
+    double getSize(const Relation* rel) const;
+
+    /** Estimate the demand-driven cost of computing the given output relation */
+    double estimateDemandDrivenCost(const TranslationUnit& translationUnit, const Relation* output) const;
+
+    /** Relation sizes of the profile */
+    std::map<const Relation*, double> sizes;
+
+    /** Cost estimates of all output relations */
+    std::vector<Estimate> estimates;
+
+    /** Relations selected for the magic set transformation */
+    std::set<QualifiedName> selectedRelations;
+};
+
+}  // namespace analysis
+}  // namespace souffle::ast
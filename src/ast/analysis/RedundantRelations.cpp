@@ -39,15 +39,15 @@ void RedundantRelationsAnalysis::run(const TranslationUnit& translationUnit) {
     Program& program = translationUnit.getProgram();
 
     const std::vector<Relation*>& relations = program.getRelations();
-    /* Add all output relations to the work set */
+    /* Add all output and query relations to the work set */
     for (const Relation* r : relations) {
-        if (ioType->isOutput(r)) {
+        if (ioType->isOutput(r) || ioType->isQuery(r)) {
             work.insert(r);
         }
     }
 
     /* Find all relations which are not redundant for the computations of the
-       output relations. */
+       output and query relations. */
     while (!work.empty()) {
         /* Chose one element in the work set and add it to notRedundant */
         const Relation* u = *(work.begin());
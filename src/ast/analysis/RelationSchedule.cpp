@@ -18,9 +18,11 @@
 
 #include "ast/analysis/RelationSchedule.h"
 #include "GraphUtils.h"
+#include "ast/Program.h"
 #include "ast/QualifiedName.h"
 #include "ast/Relation.h"
 #include "ast/TranslationUnit.h"
+#include "ast/analysis/IOType.h"
 #include "ast/analysis/PrecedenceGraph.h"
 #include "ast/analysis/SCCGraph.h"
 #include "ast/analysis/TopologicallySortedSCCGraph.h"
@@ -29,6 +31,7 @@
 #include <iterator>
 #include <memory>
 #include <set>
+#include <vector>
 
 namespace souffle::ast::analysis {
 
@@ -81,6 +84,26 @@ std::vector<std::set<const Relation*>> RelationScheduleAnalysis::computeRelation
     relationExpirySchedule.resize(numSCCs);
     const auto& sccGraph = translationUnit.getAnalysis<SCCGraphAnalysis>();
 
+    /* Relations needed by query entry points are re-evaluated after the last step, so they never expire */
+    if (numSCCs > 0) {
+        const auto& ioType = *translationUnit.getAnalysis<IOTypeAnalysis>();
+        std::vector<const Relation*> queryDependencies;
+        for (const Relation* r : translationUnit.getProgram().getRelations()) {
+            if (ioType.isQuery(r)) {
+                queryDependencies.push_back(r);
+            }
+        }
+        while (!queryDependencies.empty()) {
+            const Relation* r = queryDependencies.back();
+            queryDependencies.pop_back();
+            if (alive[0].insert(r).second) {
+                for (const Relation* predecessor : precedenceGraph->graph().predecessors(r)) {
+                    queryDependencies.push_back(predecessor);
+                }
+            }
+        }
+    }
+
     /* Compute all alive relations by iterating over all steps in reverse order
        determine the dependencies */
     for (std::size_t orderedSCC = 1; orderedSCC < numSCCs; orderedSCC++) {
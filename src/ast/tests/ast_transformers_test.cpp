@@ -16,6 +16,7 @@
 
 #include "tests/test.h"
 
+#include "Global.h"
 #include "ast/Clause.h"
 #include "ast/Node.h"
 #include "ast/Program.h"
@@ -23,6 +24,7 @@
 #include "ast/Relation.h"
 #include "ast/TranslationUnit.h"
 #include "ast/analysis/ClauseNormalisation.h"
+#include "ast/analysis/MagicSetCost.h"
 #include "ast/transform/MagicSet.h"
 #include "ast/transform/MinimiseProgram.h"
 #include "ast/transform/RemoveRedundantRelations.h"
@@ -785,4 +787,54 @@ TEST(Transformers, MagicSetComprehensive) {
     });
     checkRelMapEq(finalProgram, mappifyRelations(program));
 }
+
+/**
+ * Test the selection of relations for the magic-set transformation by the cost model: only
+ * the relations needed for the demanded tuples of FromOne are transformed, while the full
+ * closure is computed bottom-up. The closure is named auto, which must not be taken for a
+ * relation given to --magic-transform.
+ */
+TEST(Transformers, MagicSetAuto) {
+    ErrorReport e;
+    DebugReport d;
+
+    Own<TranslationUnit> tu = ParserDriver::parseTranslationUnit(
+            R"(
+                .decl Edge(X:number, Y:number)
+                .input Edge
+
+                .decl TwoStep(X:number, Y:number)
+                TwoStep(X, Y) :- Edge(X, Z), Edge(Z, Y).
+
+                .decl FromOne(X:number)
+                .output FromOne
+                FromOne(X) :- TwoStep(1, X).
+
+                .decl auto(X:number, Y:number)
+                auto(X, Y) :- Edge(X, Y).
+                auto(X, Z) :- Edge(X, Y), auto(Y, Z).
+
+                .decl Reach(X:number, Y:number)
+                .output Reach
+                Reach(X, Y) :- auto(X, Y), X < Y.
+            )",
+            e, d);
+
+    Global::config().set("magic-transform", "auto");
+
+    // FromOne and its dependencies are selected, Reach and its dependencies are not
+    const auto& selected = tu->getAnalysis<MagicSetCostAnalysis>()->getSelectedRelations();
+    EXPECT_EQ((std::set<QualifiedName>{"Edge", "FromOne", "TwoStep"}), selected);
+
+    // Only TwoStep is evaluated with a magic relation
+    mk<MagicSetTransformer>()->apply(*tu);
+    Global::config().unset("magic-transform");
+    std::set<std::string> relations;
+    for (const auto* rel : tu->getProgram().getRelations()) {
+        relations.insert(toString(rel->getQualifiedName()));
+    }
+    EXPECT_EQ((std::set<std::string>{"Edge", "FromOne", "auto", "Reach", "TwoStep.{bf}",
+                      "@magic.TwoStep.{bf}"}),
+            relations);
+}
 }  // namespace souffle::ast::transform::test
@@ -103,7 +103,8 @@ struct ComponentContent {
         // if yes, add error
         if (foundItem != directives.end()) {
             auto type = (*foundItem)->getType();
-            if (type == newDirective->getType() && newDirective->getType() != ast::DirectiveType::output) {
+            if (type == newDirective->getType() && type != ast::DirectiveType::output &&
+                    type != ast::DirectiveType::query) {
                 Diagnostic err(Diagnostic::Type::ERROR,
                         DiagnosticMessage(
                                 "Redefinition I/O operation " + toString(newDirective->getQualifiedName()),
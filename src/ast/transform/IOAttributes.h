@@ -75,7 +75,8 @@ private:
         Program& program = translationUnit.getProgram();
 
         for (Directive* io : program.getDirectives()) {
-            if (io->getType() == ast::DirectiveType::limitsize) {
+            if (io->getType() == ast::DirectiveType::limitsize ||
+                    io->getType() == ast::DirectiveType::query) {
                 continue;
             }
             Relation* rel = getRelation(program, io->getQualifiedName());
@@ -105,7 +106,8 @@ private:
         bool changed = false;
         Program& program = translationUnit.getProgram();
         for (Directive* io : program.getDirectives()) {
-            if (io->getType() == ast::DirectiveType::limitsize) {
+            if (io->getType() == ast::DirectiveType::limitsize ||
+                    io->getType() == ast::DirectiveType::query) {
                 continue;
             }
             if (io->hasParameter("attributeNames")) {
@@ -73,6 +73,15 @@ private:
             // is not an I/O directive
             if (io->getType() == ast::DirectiveType::limitsize) continue;
 
+            // Query entry points are named after their relation, but perform no I/O
+            if (io->getType() == ast::DirectiveType::query) {
+                if (!io->hasParameter("name")) {
+                    io->addParameter("name", getRelationName(io));
+                    changed = true;
+                }
+                continue;
+            }
+
             // Set a default IO of file
             if (!io->hasParameter("IO")) {
                 io->addParameter("IO", "file");
@@ -32,6 +32,7 @@
 #include "ast/TranslationUnit.h"
 #include "ast/UnnamedVariable.h"
 #include "ast/analysis/IOType.h"
+#include "ast/analysis/MagicSetCost.h"
 #include "ast/analysis/PolymorphicObjects.h"
 #include "ast/analysis/PrecedenceGraph.h"
 #include "ast/analysis/RelationDetailCache.h"
@@ -45,6 +46,7 @@
 #include "souffle/RamTypes.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/StreamUtil.h"
 #include "souffle/utility/StringUtil.h"
 #include <algorithm>
 #include <optional>
@@ -99,10 +101,20 @@ std::set<QualifiedName> MagicSetTransformer::getWeaklyIgnoredRelations(const Tra
     // Pick up specified relations from config
     std::vector<std::string> configRels = splitString(Global::config().get("magic-transform"), ',');
     for (const auto& relStr : configRels) {
+        // The cost model picks the relations for "auto" below
+        if (relStr == "auto") continue;
         std::vector<std::string> qualifiers = splitString(relStr, '.');
         specifiedRelations.push_back(QualifiedName(qualifiers));
     }
 
+    // Pick up relations selected by the cost model
+    if (contains(configRels, "auto")) {
+        const auto& costAnalysis = *tu.getAnalysis<analysis::MagicSetCostAnalysis>();
+        for (const auto& relName : costAnalysis.getSelectedRelations()) {
+            specifiedRelations.push_back(relName);
+        }
+    }
+
     // Pick up specified relations from relation tags
     for (const auto* rel : program.getRelations()) {
         if (rel->hasQualifier(RelationQualifier::MAGIC)) {
@@ -110,6 +122,25 @@ std::set<QualifiedName> MagicSetTransformer::getWeaklyIgnoredRelations(const Tra
         }
     }
 
+    // Pick up query relations along with every relation they depend on
+    std::vector<const Relation*> queryRelations;
+    for (const auto* directive : program.getDirectives()) {
+        if (directive->getType() == ast::DirectiveType::query) {
+            if (const auto* rel = getRelation(program, directive->getQualifiedName())) {
+                queryRelations.push_back(rel);
+            }
+        }
+    }
+    while (!queryRelations.empty()) {
+        const auto* rel = queryRelations.back();
+        queryRelations.pop_back();
+        if (contains(specifiedRelations, rel->getQualifiedName())) continue;
+        specifiedRelations.push_back(rel->getQualifiedName());
+        for (const auto* predecessor : precedenceGraph.predecessors(rel)) {
+            queryRelations.push_back(predecessor);
+        }
+    }
+
     // Get the complement if not everything is magic'd
     if (!contains(configRels, "*")) {
         for (const Relation* rel : program.getRelations()) {
@@ -155,9 +186,10 @@ std::set<QualifiedName> MagicSetTransformer::getWeaklyIgnoredRelations(const Tra
         });
     }
 
-    // - Any eqrel relation
+    // - Any eqrel or min relation
     for (auto* rel : program.getRelations()) {
-        if (rel->getRepresentation() == RelationRepresentation::EQREL) {
+        if (rel->getRepresentation() == RelationRepresentation::EQREL ||
+                rel->getRepresentation() == RelationRepresentation::MIN) {
             weaklyIgnoredRelations.insert(rel->getQualifiedName());
         }
     }
@@ -283,6 +315,9 @@ bool MagicSetTransformer::shouldRun(const TranslationUnit& tu) {
     for (const auto* rel : program.getRelations()) {
         if (rel->hasQualifier(RelationQualifier::MAGIC)) return true;
     }
+    for (const auto* directive : program.getDirectives()) {
+        if (directive->getType() == ast::DirectiveType::query) return true;
+    }
     return false;
 }
 
@@ -728,6 +763,20 @@ bool AdornDatabaseTransformer::transform(TranslationUnit& translationUnit) {
         }
     }
 
+    // Query relations trigger the adornment process with their binding pattern
+    for (auto* directive : program.getDirectives()) {
+        if (directive->getType() != ast::DirectiveType::query) continue;
+        const QualifiedName relName = directive->getQualifiedName();
+        std::string adornmentMarker;
+        if (!contains(weaklyIgnoredRelations, relName)) {
+            adornmentMarker = directive->getParameter("adornment");
+        }
+        queueAdornment(relName, adornmentMarker);
+
+        // The query is now answered by the adorned relation
+        directive->setQualifiedName(getAdornmentID(relName, adornmentMarker));
+    }
+
     // Keep going while there's things to adorn
     while (hasAdornmentToProcess()) {
         // Pop off the next head adornment to do
@@ -1200,6 +1249,15 @@ bool MagicSetCoreTransformer::transform(TranslationUnit& translationUnit) {
         changed = true;
         program.addRelation(std::move(magicRelation));
     }
+
+    // The magic relation of a query relation receives the bound arguments of the query
+    for (auto* directive : program.getDirectives()) {
+        const auto& relName = directive->getQualifiedName();
+        if (directive->getType() == ast::DirectiveType::query && isAdorned(relName)) {
+            directive->addParameter("seed", toString(join(getMagicName(relName).getQualifiers(), ".")));
+            changed = true;
+        }
+    }
     return changed;
 }
 
@@ -39,7 +39,7 @@ bool RemoveEmptyRelationsTransformer::removeEmptyRelations(TranslationUnit& tran
     bool changed = false;
     for (auto rel : program.getRelations()) {
         auto* ioTypes = translationUnit.getAnalysis<analysis::IOTypeAnalysis>();
-        if (!getClauses(program, *rel).empty() || ioTypes->isInput(rel)) {
+        if (!getClauses(program, *rel).empty() || ioTypes->isInput(rel) || ioTypes->isQuerySeed(rel)) {
             continue;
         }
         emptyRelations.insert(rel->getQualifiedName());
@@ -55,7 +55,7 @@ bool RemoveEmptyRelationsTransformer::removeEmptyRelations(TranslationUnit& tran
             }
         });
 
-        if (!usedInAggregate && !ioTypes->isOutput(rel)) {
+        if (!usedInAggregate && !ioTypes->isOutput(rel) && !ioTypes->isQuery(rel)) {
             removeRelation(translationUnit, rel->getQualifiedName());
             changed = true;
         }
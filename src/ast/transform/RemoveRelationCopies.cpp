@@ -13,6 +13,7 @@
  ***********************************************************************/
 
 #include "ast/transform/RemoveRelationCopies.h"
+#include "RelationTag.h"
 #include "ast/Argument.h"
 #include "ast/Atom.h"
 #include "ast/Clause.h"
@@ -47,8 +48,9 @@ bool RemoveRelationCopiesTransformer::removeRelationCopies(TranslationUnit& tran
 
     // search for relations only defined by a single rule ..
     for (Relation* rel : program.getRelations()) {
-        // skip relations with functional dependencies
-        if (!rel->getFunctionalDependencies().empty()) {
+        // skip relations with functional dependencies or retaining only minima
+        if (!rel->getFunctionalDependencies().empty() ||
+                rel->getRepresentation() == RelationRepresentation::MIN) {
             continue;
         }
         const auto& clauses = getClauses(program, *rel);
@@ -635,6 +635,41 @@ void SemanticCheckerImpl::checkRelation(const Relation& relation) {
         }
     }
 
+    if (relation.getRepresentation() == RelationRepresentation::MIN) {
+        const std::string name = toString(relation.getQualifiedName());
+        const auto& attributes = relation.getAttributes();
+        if (attributes.size() < 2) {
+            report.addError(
+                    "Min relation " + name + " requires at least two attributes", relation.getSrcLoc());
+        } else {
+            // tuples are compared on their raw representation, hence only signed numbers are ordered
+            const QualifiedName& typeName = attributes.back()->getTypeName();
+            if (typeEnv.isType(typeName) && !isOfKind(typeEnv.getType(typeName), TypeAttribute::Signed)) {
+                report.addError("Last attribute of min relation " + name + " must be a number",
+                        attributes.back()->getSrcLoc());
+            }
+        }
+        if (Global::config().has("provenance")) {
+            report.addError("Min relation " + name + " cannot be used with provenance", relation.getSrcLoc());
+        }
+        if (!relation.getFunctionalDependencies().empty()) {
+            report.addError("Min relation " + name + " cannot have a choice-domain", relation.getSrcLoc());
+        }
+        if (relation.hasQualifier(RelationQualifier::INLINE)) {
+            report.addError("Min relation " + name + " cannot be inlined", relation.getSrcLoc());
+        }
+
+        // a negation tests for a key, the retained minimum cannot be matched exactly
+        visit(program, [&](const Negation& negation) {
+            const Atom* atom = negation.getAtom();
+            if (atom->getQualifiedName() == relation.getQualifiedName() && atom->getArity() > 0 &&
+                    !isA<UnnamedVariable>(atom->getArguments().back())) {
+                report.addError("Last argument of negated min relation " + name + " must be '_'",
+                        atom->getSrcLoc());
+            }
+        });
+    }
+
     // start with declaration
     checkRelationDeclaration(relation);
 
@@ -655,6 +690,16 @@ void SemanticCheckerImpl::checkIO() {
         if (r == nullptr) {
             report.addError(
                     "Undefined relation " + toString(directive->getQualifiedName()), directive->getSrcLoc());
+        } else if (directive->getType() == DirectiveType::query &&
+                   directive->getParameter("adornment").size() != r->getArity()) {
+            report.addError("Binding pattern of query " + toString(directive->getQualifiedName()) +
+                                    " does not match the arity of the relation",
+                    directive->getSrcLoc());
+        } else if (directive->hasParameter("classes") && directive->getParameter("classes") == "true" &&
+                   r->getRepresentation() != RelationRepresentation::EQREL) {
+            report.addError("Class-based IO of relation " + toString(directive->getQualifiedName()) +
+                                    " requires an equivalence relation",
+                    directive->getSrcLoc());
         }
     };
     for (const auto* directive : program.getDirectives()) {
@@ -15,8 +15,10 @@
  ***********************************************************************/
 
 #include "ast2ram/seminaive/ClauseTranslator.h"
+#include "AggregateOp.h"
 #include "Global.h"
 #include "LogStatement.h"
+#include "RelationTag.h"
 #include "ast/Aggregator.h"
 #include "ast/BranchInit.h"
 #include "ast/Clause.h"
@@ -464,6 +466,23 @@ Own<ram::Operation> ClauseTranslator::addNegatedAtom(
     for (std::size_t i = 0; i < arity; i++) {
         values.push_back(context.translateValue(*valueIndex, args[i]));
     }
+
+    // a tuple of a min relation is dominated if the retained tuple of its key has a less or equal
+    // last attribute, hence count these tuples on a new level rather than checking for the tuple
+    if (context.getRelation(atom->getQualifiedName())->getRepresentation() == RelationRepresentation::MIN) {
+        int level = operators.size() + generators.size();
+        Own<ram::Condition> dominating;
+        for (std::size_t i = 0; i < arity; i++) {
+            auto cmp = i + 1 < arity ? BinaryConstraintOp::EQ : BinaryConstraintOp::LE;
+            dominating = addConjunctiveTerm(std::move(dominating),
+                    mk<ram::Constraint>(cmp, mk<ram::TupleElement>(level, i), std::move(values[i])));
+        }
+        auto none = mk<ram::Constraint>(
+                BinaryConstraintOp::EQ, mk<ram::TupleElement>(level, 0), mk<ram::SignedConstant>(0));
+        return mk<ram::Aggregate>(mk<ram::Filter>(std::move(none), std::move(op)), AggregateOp::COUNT, name,
+                mk<ram::UndefValue>(), std::move(dominating), level);
+    }
+
     return mk<ram::Filter>(
             mk<ram::Negation>(mk<ram::ExistenceCheck>(name, std::move(values))), std::move(op));
 }
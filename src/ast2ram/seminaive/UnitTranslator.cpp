@@ -19,6 +19,7 @@
 #include "ast/Directive.h"
 #include "ast/Relation.h"
 #include "ast/TranslationUnit.h"
+#include "ast/analysis/PrecedenceGraph.h"
 #include "ast/analysis/TopologicallySortedSCCGraph.h"
 #include "ast/utility/Utils.h"
 #include "ast/utility/Visitor.h"
@@ -37,6 +38,7 @@
 #include "ram/Filter.h"
 #include "ram/IO.h"
 #include "ram/Insert.h"
+#include "ram/LogMemory.h"
 #include "ram/LogRelationTimer.h"
 #include "ram/LogSize.h"
 #include "ram/LogTimer.h"
@@ -51,6 +53,8 @@
 #include "ram/Sequence.h"
 #include "ram/SignedConstant.h"
 #include "ram/Statement.h"
+#include "ram/SubroutineArgument.h"
+#include "ram/SubroutineReturn.h"
 #include "ram/Swap.h"
 #include "ram/TranslationUnit.h"
 #include "ram/TupleElement.h"
@@ -95,9 +99,11 @@ Own<ram::Statement> UnitTranslator::generateNonRecursiveRelation(const ast::Rela
     std::string relName = getConcreteRelationName(rel.getQualifiedName());
 
     // Iterate over all non-recursive clauses that belong to the relation
+    bool isRecursive = false;
     for (const auto* clause : context->getClauses(rel.getQualifiedName())) {
         // Skip recursive rules
         if (context->isRecursiveClause(clause)) {
+            isRecursive = true;
             continue;
         }
 
@@ -142,6 +148,12 @@ Own<ram::Statement> UnitTranslator::generateNonRecursiveRelation(const ast::Rela
             // Add table size printer
             appendStmt(result, mk<ram::LogSize>(relName, logSizeStatement));
         }
+
+        // Add memory usage of the indexes, which is measured after the fixpoint for recursive relations
+        if (!isRecursive) {
+            appendStmt(result,
+                    mk<ram::LogMemory>(relName, LogStatement::mRelation(relationName, srcLocation)));
+        }
     }
 
     return mk<ram::Sequence>(std::move(result));
@@ -174,6 +186,94 @@ Own<ram::Statement> UnitTranslator::generateStratum(std::size_t scc) const {
     return mk<ram::Sequence>(std::move(current));
 }
 
+Own<ram::Statement> UnitTranslator::generateQuerySubroutine(
+        const ast::TranslationUnit& translationUnit, const ast::Directive& query) const {
+    const auto& precedenceGraph =
+            translationUnit.getAnalysis<ast::analysis::PrecedenceGraphAnalysis>()->graph();
+    const auto& sccOrdering =
+            translationUnit.getAnalysis<ast::analysis::TopologicallySortedSCCGraphAnalysis>()->order();
+    const auto* relation = context->getRelation(query.getQualifiedName());
+    assert(relation != nullptr && "query relation should exist");
+    VecOwn<ram::Statement> result;
+
+    if (query.hasParameter("seed")) {
+        ast::QualifiedName seedName(splitString(query.getParameter("seed"), '.'));
+        const auto* seed = context->getRelation(seedName);
+        assert(seed != nullptr && "query seed relation should exist");
+
+        // Seed the magic relation with the bound arguments
+        VecOwn<ram::Expression> arguments;
+        for (std::size_t i = 0; i < seed->getArity(); i++) {
+            arguments.push_back(mk<ram::SubroutineArgument>(i));
+        }
+        auto insertion = mk<ram::Insert>(getConcreteRelationName(seedName), std::move(arguments));
+        appendStmt(result, mk<ram::Query>(std::move(insertion)));
+
+        // Collect the relations between the seed and the query relation
+        auto closure = [](const ast::Relation* start, auto next) {
+            std::set<const ast::Relation*> reached;
+            std::vector<const ast::Relation*> work = {start};
+            while (!work.empty()) {
+                const auto* cur = work.back();
+                work.pop_back();
+                if (reached.insert(cur).second) {
+                    for (const auto* rel : next(cur)) {
+                        work.push_back(rel);
+                    }
+                }
+            }
+            return reached;
+        };
+        auto dependencies = closure(relation, [&](const ast::Relation* rel) {
+            return precedenceGraph.predecessors(rel);
+        });
+        auto dependents = closure(seed, [&](const ast::Relation* rel) {
+            return precedenceGraph.successors(rel);
+        });
+
+        // Re-evaluate the rules of the affected strata, which only derive the slice demanded by the new
+        // seed; unlike the strata of the main program, inputs are not reloaded, outputs are not stored,
+        // and expired relations are not cleared. A recursive stratum starts from its whole relations,
+        // since relations of lower strata may have gained tuples joining with the existing ones.
+        for (std::size_t scc : sccOrdering) {
+            const auto& sccRelations = context->getRelationsInSCC(scc);
+            if (none_of(sccRelations, [&](const ast::Relation* rel) {
+                    return contains(dependencies, rel) && contains(dependents, rel);
+                })) {
+                continue;
+            }
+            if (context->isRecursiveSCC(scc)) {
+                appendStmt(result, generateRecursiveStratum(sccRelations));
+            } else {
+                appendStmt(result, generateNonRecursiveRelation(**sccRelations.begin()));
+            }
+        }
+    }
+
+    // Return all tuples of the query relation matching the bound arguments
+    const std::string& adornment = query.getParameter("adornment");
+    VecOwn<ram::Condition> bindings;
+    std::size_t argument = 0;
+    for (std::size_t i = 0; i < adornment.size(); i++) {
+        if (adornment[i] == 'b') {
+            bindings.push_back(mk<ram::Constraint>(BinaryConstraintOp::EQ, mk<ram::TupleElement>(0, i),
+                    mk<ram::SubroutineArgument>(argument++)));
+        }
+    }
+    VecOwn<ram::Expression> values;
+    for (std::size_t i = 0; i < relation->getArity(); i++) {
+        values.push_back(mk<ram::TupleElement>(0, i));
+    }
+    Own<ram::Operation> operation = mk<ram::SubroutineReturn>(std::move(values));
+    if (!bindings.empty()) {
+        operation = mk<ram::Filter>(ram::toCondition(bindings), std::move(operation));
+    }
+    std::string relName = getConcreteRelationName(relation->getQualifiedName());
+    appendStmt(result, mk<ram::Query>(mk<ram::Scan>(relName, 0, std::move(operation))));
+
+    return mk<ram::Sequence>(std::move(result));
+}
+
 Own<ram::Statement> UnitTranslator::generateClearExpiredRelations(
         const std::set<const ast::Relation*>& expiredRelations) const {
     VecOwn<ram::Statement> stmts;
@@ -268,6 +368,15 @@ Own<ram::Statement> UnitTranslator::generateStratumPostamble(
         const std::set<const ast::Relation*>& scc) const {
     VecOwn<ram::Statement> postamble;
     for (const ast::Relation* rel : scc) {
+        // Measure the memory usage of the indexes once the fixpoint has been reached; measuring a
+        // B-tree walks all of its nodes, which would be quadratic if it was done after every iteration
+        if (Global::config().has("profile")) {
+            const std::string logMemoryStatement =
+                    LogStatement::mRelation(toString(rel->getQualifiedName()), rel->getSrcLoc());
+            appendStmt(postamble,
+                    mk<ram::LogMemory>(getConcreteRelationName(rel->getQualifiedName()), logMemoryStatement));
+        }
+
         // Drop temporary tables after recursion
         appendStmt(postamble, mk<ram::Clear>(getDeltaRelationName(rel->getQualifiedName())));
         appendStmt(postamble, mk<ram::Clear>(getNewRelationName(rel->getQualifiedName())));
@@ -280,6 +389,8 @@ Own<ram::Statement> UnitTranslator::generateStratumTableUpdates(
     VecOwn<ram::Statement> updateTable;
     for (const ast::Relation* rel : scc) {
         // Copy @new into main relation, @delta := @new, and empty out @new
+        // For min relations, the guard of recursive clauses only admits tuples improving on the main
+        // relation into @new, and merging replaces the retained minima, so @delta holds the improvements
         std::string mainRelation = getConcreteRelationName(rel->getQualifiedName());
         std::string newRelation = getNewRelationName(rel->getQualifiedName());
         std::string deltaRelation = getDeltaRelationName(rel->getQualifiedName());
@@ -485,6 +596,12 @@ Own<ram::Sequence> UnitTranslator::generateProgram(const ast::TranslationUnit& t
         addRamSubroutine(stratumID, std::move(stratum));
     }
 
+    // Create a subroutine for each query entry point
+    for (const auto* query : context->getQueryDirectives()) {
+        std::string queryID = query->getParameter("name") + "_" + query->getParameter("adornment");
+        addRamSubroutine(queryID, generateQuerySubroutine(translationUnit, *query));
+    }
+
     // Invoke all strata
     VecOwn<ram::Statement> res;
     for (std::size_t i = 0; i < sccOrdering.size(); i++) {
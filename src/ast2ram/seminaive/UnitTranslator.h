@@ -23,6 +23,7 @@
 
 namespace souffle::ast {
 class Clause;
+class Directive;
 class Relation;
 class TranslationUnit;
 }  // namespace souffle::ast
@@ -63,6 +64,10 @@ protected:
     Own<ram::Statement> generateNonRecursiveRelation(const ast::Relation& rel) const;
     Own<ram::Statement> generateRecursiveStratum(const std::set<const ast::Relation*>& scc) const;
 
+    /** Query entry point translation */
+    Own<ram::Statement> generateQuerySubroutine(
+            const ast::TranslationUnit& translationUnit, const ast::Directive& query) const;
+
     /** IO translation */
     Own<ram::Statement> generateStoreRelation(const ast::Relation* relation) const;
     Own<ram::Statement> generateLoadRelation(const ast::Relation* relation) const;
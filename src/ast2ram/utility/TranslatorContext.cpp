@@ -121,6 +121,11 @@ std::vector<ast::Directive*> TranslatorContext::getLoadDirectives(const ast::Qua
             [&](const ast::Directive* dir) { return dir->getType() == ast::DirectiveType::input; });
 }
 
+std::vector<ast::Directive*> TranslatorContext::getQueryDirectives() const {
+    return filter(program->getDirectives(),
+            [&](const ast::Directive* dir) { return dir->getType() == ast::DirectiveType::query; });
+}
+
 bool TranslatorContext::hasSizeLimit(const ast::Relation* relation) const {
     return ioType->isLimitSize(relation);
 }
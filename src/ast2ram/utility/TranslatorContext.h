@@ -79,6 +79,7 @@ public:
     const ast::Relation* getAtomRelation(const ast::Atom* atom) const;
     std::vector<ast::Directive*> getStoreDirectives(const ast::QualifiedName& name) const;
     std::vector<ast::Directive*> getLoadDirectives(const ast::QualifiedName& name) const;
+    std::vector<ast::Directive*> getQueryDirectives() const;
     std::string getAttributeTypeQualifier(const ast::QualifiedName& name) const;
     bool hasSizeLimit(const ast::Relation* relation) const;
     std::size_t getSizeLimit(const ast::Relation* relation) const;
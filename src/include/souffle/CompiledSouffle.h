@@ -40,6 +40,7 @@
 #include "souffle/profile/Logger.h"
 #include "souffle/profile/ProfileEvent.h"
 #endif
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cassert>
@@ -129,6 +130,25 @@ public:
         return iterator(mk<iterator_wrapper>(id, this, relation.end()));
     }
 
+    void forEachBlock(const block_callback& callback, std::size_t blockSize = 1024) const override {
+        blockSize = std::max<std::size_t>(blockSize, 1);
+        std::vector<RamDomain> buffer(blockSize * Arity);
+        std::size_t rows = 0;
+        for (auto&& value : relation) {
+            RamDomain* row = buffer.data() + rows * Arity;
+            for (std::size_t i = 0; i < Arity; i++) {
+                row[i] = value[i];
+            }
+            if (++rows == blockSize) {
+                callback(buffer.data(), rows);
+                rows = 0;
+            }
+        }
+        if (rows > 0) {
+            callback(buffer.data(), rows);
+        }
+    }
+
     void insert(const tuple& arg) override {
         TupleType t;
         assert(&arg.getRelation() == this && "wrong relation");
@@ -257,6 +277,9 @@ public:
         data = false;
     }
     void printStatistics(std::ostream& /* o */) const {}
+    std::vector<std::pair<std::string, std::size_t>> getIndexMemoryUsage() const {
+        return {{"nullary", sizeof(data)}};
+    }
 };
 
 /** info relations */
@@ -0,0 +1,388 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file QueryServer.h
+ *
+ * Query server keeping an evaluated program resident; works for compiler
+ * and interpreter
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include "souffle/SouffleInterface.h"
+#include "souffle/SymbolTable.h"
+#include "souffle/utility/StringUtil.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <shared_mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+
+namespace souffle {
+
+/**
+ * A query server for an evaluated Souffle program.
+ *
+ * The program is loaded and evaluated once. Afterwards, clients connect to a Unix domain
+ * socket and submit requests, one per line. The fields of a request are separated by tabs
+ * (as in fact files):
+ *
+ *   relations                          -- list the names of all relations
+ *   size <rel>                         -- number of tuples in a relation
+ *   query <rel> <v1> ... <vn>          -- tuples of a relation matching the given values,
+ *                                         where `_` matches any value
+ *   subroutine <name> <a1> ... <an>    -- execute a subroutine with the given (raw) arguments,
+ *                                         which must match the number of arguments of the subroutine
+ *   quit                               -- close the connection
+ *   shutdown                           -- stop the server
+ *
+ * A response starts either with `ok <n>` followed by n tab-separated lines, or with
+ * `error <message>`.
+ *
+ * Connections are served by a pool of worker threads. Most requests only read relations, hence
+ * requests of different clients are executed concurrently on the shared relations. Subroutines
+ * (e.g. query entry points declared with `.query`) may extend relations and run exclusively.
+ */
+class QueryServer {
+public:
+    QueryServer(SouffleProgram& prog, std::string socketPath, std::size_t numWorkers)
+            : prog(prog), socketPath(std::move(socketPath)),
+              numWorkers(numWorkers > 0 ? numWorkers : std::max(std::thread::hardware_concurrency(), 1u)) {}
+
+    /**
+     * Accept and serve connections until a shutdown request has been received.
+     */
+    void run() {
+        listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0) {
+            throw std::runtime_error("cannot create socket: " + std::string(std::strerror(errno)));
+        }
+
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(addr.sun_path)) {
+            throw std::invalid_argument("socket path too long: " + socketPath);
+        }
+        std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(socketPath.c_str());
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+                listen(listenFd, SOMAXCONN) < 0) {
+            close(listenFd);
+            throw std::runtime_error(
+                    "cannot listen on socket " + socketPath + ": " + std::string(std::strerror(errno)));
+        }
+
+        // spawn workers serving accepted connections
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < numWorkers; ++i) {
+            workers.emplace_back([&]() {
+                while (auto fd = nextConnection()) {
+                    serveConnection(*fd);
+                }
+            });
+        }
+
+        // accept connections until the listening socket is shut down
+        while (!stopped) {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if (fd < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            std::lock_guard<std::mutex> guard(queueLock);
+            pending.push_back(fd);
+            queueCond.notify_one();
+        }
+
+        stop();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (int fd : pending) {
+            close(fd);
+        }
+        pending.clear();
+        close(listenFd);
+        unlink(socketPath.c_str());
+    }
+
+    /**
+     * Process a single request and return the response.
+     */
+    std::string processRequest(const std::string& request) {
+        std::vector<std::string> fields = splitString(request, '\t');
+        if (fields.empty()) {
+            return error("empty request");
+        }
+        const std::string& command = fields[0];
+        try {
+            if (command == "relations" && fields.size() == 1) {
+                std::vector<std::string> names;
+                for (Relation* rel : prog.getAllRelations()) {
+                    names.push_back(rel->getName());
+                }
+                return ok(names);
+            } else if (command == "size" && fields.size() == 2) {
+                std::shared_lock<std::shared_mutex> guard(evaluationLock);
+                Relation* rel = prog.getRelation(fields[1]);
+                if (rel == nullptr) {
+                    return error("unknown relation " + fields[1]);
+                }
+                return ok({std::to_string(rel->size())});
+            } else if (command == "query" && fields.size() >= 2) {
+                std::shared_lock<std::shared_mutex> guard(evaluationLock);
+                return query(fields);
+            } else if (command == "subroutine" && fields.size() >= 2) {
+                std::optional<std::size_t> arity = prog.getSubroutineArity(fields[1]);
+                if (!arity) {
+                    return error("unknown subroutine " + fields[1]);
+                }
+                if (fields.size() != *arity + 2) {
+                    return error("expected " + std::to_string(*arity) + " arguments for subroutine " +
+                                 fields[1]);
+                }
+                std::vector<RamDomain> args;
+                for (std::size_t i = 2; i < fields.size(); ++i) {
+                    args.push_back(RamSignedFromString(fields[i]));
+                }
+                std::vector<RamDomain> ret;
+                {
+                    std::unique_lock<std::shared_mutex> guard(evaluationLock);
+                    prog.executeSubroutine(fields[1], args, ret);
+                }
+                std::vector<std::string> lines;
+                for (RamDomain value : ret) {
+                    lines.push_back(std::to_string(value));
+                }
+                return ok(lines);
+            }
+        } catch (std::exception& e) {
+            return error(e.what());
+        }
+        return error("invalid request " + command);
+    }
+
+    /**
+     * Stop serving; pending connections are closed.
+     */
+    void stop() {
+        stopped = true;
+        if (listenFd >= 0) {
+            shutdown(listenFd, SHUT_RDWR);
+        }
+        std::lock_guard<std::mutex> guard(queueLock);
+        for (int fd : active) {
+            shutdown(fd, SHUT_RD);
+        }
+        queueCond.notify_all();
+    }
+
+private:
+    /** Answer a query request by scanning the relation */
+    std::string query(const std::vector<std::string>& fields) {
+        Relation* rel = prog.getRelation(fields[1]);
+        if (rel == nullptr) {
+            return error("unknown relation " + fields[1]);
+        }
+        const std::size_t arity = rel->getArity();
+        if (fields.size() != 2 && fields.size() != arity + 2) {
+            return error("expected " + std::to_string(arity) + " values for relation " + fields[1]);
+        }
+
+        // parse pattern; unbound positions are skipped when matching, and no tuple contains an unknown symbol
+        std::vector<std::optional<RamDomain>> pattern(arity);
+        for (std::size_t i = 0; i + 2 < fields.size(); ++i) {
+            if (fields[i + 2] != "_") {
+                pattern[i] = encode(*rel, i, fields[i + 2]);
+                if (!pattern[i]) {
+                    return ok({});
+                }
+            }
+        }
+
+        std::vector<std::string> lines;
+        rel->forEachBlock([&](const RamDomain* data, std::size_t rows) {
+            for (std::size_t row = 0; row < rows; ++row) {
+                const RamDomain* tuple = data + row * arity;
+                bool matches = true;
+                for (std::size_t i = 0; i < arity && matches; ++i) {
+                    matches = !pattern[i] || *pattern[i] == tuple[i];
+                }
+                if (matches) {
+                    lines.push_back(decode(*rel, tuple));
+                }
+            }
+        });
+        return ok(lines);
+    }
+
+    /** Encode a value of a column according to its attribute type; symbols are not added to the table */
+    static std::optional<RamDomain> encode(
+            const Relation& rel, std::size_t column, const std::string& value) {
+        switch (*rel.getAttrType(column)) {
+            case 's': return rel.getSymbolTable().find(value);
+            case 'f': return ramBitCast(RamFloatFromString(value));
+            case 'u': return ramBitCast(RamUnsignedFromString(value));
+            default: return RamSignedFromString(value);
+        }
+    }
+
+    /** Decode a tuple into a tab-separated line */
+    static std::string decode(const Relation& rel, const RamDomain* tuple) {
+        std::stringstream line;
+        for (std::size_t i = 0; i < rel.getArity(); ++i) {
+            if (i > 0) {
+                line << '\t';
+            }
+            switch (*rel.getAttrType(i)) {
+                case 's': line << rel.getSymbolTable().decode(tuple[i]); break;
+                case 'f': line << ramBitCast<RamFloat>(tuple[i]); break;
+                case 'u': line << ramBitCast<RamUnsigned>(tuple[i]); break;
+                default: line << tuple[i]; break;
+            }
+        }
+        return line.str();
+    }
+
+    static std::string ok(const std::vector<std::string>& lines) {
+        std::stringstream response;
+        response << "ok " << lines.size() << "\n";
+        for (const auto& line : lines) {
+            response << line << "\n";
+        }
+        return response.str();
+    }
+
+    static std::string error(const std::string& message) {
+        return "error " + message + "\n";
+    }
+
+    /** Obtain the next accepted connection, or nothing if the server stopped */
+    std::optional<int> nextConnection() {
+        std::unique_lock<std::mutex> guard(queueLock);
+        queueCond.wait(guard, [&]() { return stopped || !pending.empty(); });
+        if (pending.empty()) {
+            return std::nullopt;
+        }
+        int fd = pending.front();
+        pending.pop_front();
+        active.insert(fd);
+        return fd;
+    }
+
+    /** Serve requests of a single connection until it is closed */
+    void serveConnection(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        bool open = true;
+        while (open && !stopped) {
+            ssize_t n = read(fd, chunk, sizeof(chunk));
+            if (n <= 0) {
+                break;
+            }
+            buffer.append(chunk, n);
+            std::size_t end;
+            while (open && (end = buffer.find('\n')) != std::string::npos) {
+                std::string request = buffer.substr(0, end);
+                buffer.erase(0, end + 1);
+                if (!request.empty() && request.back() == '\r') {
+                    request.pop_back();
+                }
+                if (request == "quit") {
+                    open = false;
+                } else if (request == "shutdown") {
+                    open = false;
+                    stop();
+                } else {
+                    open = writeAll(fd, processRequest(request));
+                }
+            }
+        }
+        std::lock_guard<std::mutex> guard(queueLock);
+        active.erase(fd);
+        close(fd);
+    }
+
+    /** Write a complete response to a connection */
+    static bool writeAll(int fd, const std::string& data) {
+        std::size_t written = 0;
+        while (written < data.size()) {
+            ssize_t n = send(fd, data.data() + written, data.size() - written, SEND_FLAGS);
+            if (n <= 0) {
+                return false;
+            }
+            written += n;
+        }
+        return true;
+    }
+
+    /** Program answering the queries */
+    SouffleProgram& prog;
+
+    /** Path of the Unix domain socket */
+    std::string socketPath;
+
+    /** Number of connections served concurrently */
+    std::size_t numWorkers;
+
+    /** Listening socket */
+    int listenFd = -1;
+
+    /** Set once a shutdown has been requested */
+    std::atomic<bool> stopped{false};
+
+    /** Accepted connections waiting for a worker */
+    std::deque<int> pending;
+
+    /** Connections currently served by a worker */
+    std::set<int> active;
+
+    std::mutex queueLock;
+    std::condition_variable queueCond;
+
+    /** Excludes subroutines from concurrent reads of the relations */
+    std::shared_mutex evaluationLock;
+};
+
+/**
+ * Serve queries against an evaluated program on the given socket.
+ */
+inline void serveQueries(SouffleProgram& prog, const std::string& socketPath, std::size_t numWorkers) {
+    QueryServer server(prog, socketPath, numWorkers);
+    std::cerr << "Serving queries on " << socketPath << "\n";
+    server.run();
+}
+
+}  // end of namespace souffle
@@ -24,6 +24,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
 #include <map>
@@ -315,6 +316,27 @@ public:
      */
     virtual iterator end() const = 0;
 
+    /**
+     * Callback type for block-wise traversal of a relation.
+     *
+     * The first argument points to `rows` tuples stored contiguously in row-major order, each tuple
+     * consisting of getArity() elements. The memory is owned by the relation and only valid for the
+     * duration of the call.
+     */
+    using block_callback = std::function<void(const RamDomain*, std::size_t)>;
+
+    /**
+     * Visit all tuples of a relation in blocks of at most blockSize tuples.
+     *
+     * In contrast to the tuple iterator, no tuple object is materialised per row and no virtual call is
+     * made per row. Elements are passed in their raw encoding (i.e., symbols are symbol table indices).
+     * Child classes should override the default implementation, which falls back to the iterator.
+     *
+     * @param callback Callback invoked for each block of tuples
+     * @param blockSize Maximum number of tuples per block
+     */
+    virtual void forEachBlock(const block_callback& callback, std::size_t blockSize = 1024) const;
+
     /**
      * Get the number of tuples in a relation.
      *
@@ -685,6 +707,23 @@ public:
     }
 };
 
+inline void Relation::forEachBlock(const block_callback& callback, std::size_t blockSize) const {
+    const arity_type arity = getArity();
+    blockSize = std::max<std::size_t>(blockSize, 1);
+    std::vector<RamDomain> buffer(blockSize * arity);
+    std::size_t rows = 0;
+    for (const tuple& t : *this) {
+        std::copy_n(t.data, arity, buffer.data() + rows * arity);
+        if (++rows == blockSize) {
+            callback(buffer.data(), rows);
+            rows = 0;
+        }
+    }
+    if (rows > 0) {
+        callback(buffer.data(), rows);
+    }
+}
+
 /**
  * Abstract base class for generated Datalog programs.
  */
@@ -717,6 +756,12 @@ private:
      * allRelations store all the relation in a vector.
      */
     std::vector<Relation*> allRelations;
+
+    /**
+     * subroutineArities stores the number of arguments of each subroutine with its name as the key.
+     */
+    std::map<std::string, std::size_t> subroutineArities;
+
     /**
      * The number of threads used by OpenMP
      */
@@ -754,6 +799,16 @@ protected:
         addRelation(name, *rel, isInput, isOutput);
     }
 
+    /**
+     * Add the subroutine with the given number of arguments to subroutineArities.
+     *
+     * @param name the name of the subroutine (std::string)
+     * @param numArgs the number of arguments of the subroutine
+     */
+    void addSubroutine(const std::string& name, std::size_t numArgs) {
+        subroutineArities[name] = numArgs;
+    }
+
 public:
     /**
      * Destructor.
@@ -900,6 +955,20 @@ public:
         return allRelations;
     }
 
+    /**
+     * Get the number of arguments of a subroutine.
+     *
+     * @param name the name of the subroutine (std::string)
+     * @return the number of arguments, or nothing if the program has no subroutine with this name
+     */
+    std::optional<std::size_t> getSubroutineArity(const std::string& name) const {
+        auto it = subroutineArities.find(name);
+        if (it == subroutineArities.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
     /**
      * Execute a subroutine
      * @param name  Name of a subroutine (std:string)
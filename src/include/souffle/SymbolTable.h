@@ -25,6 +25,7 @@
 #include <deque>
 #include <initializer_list>
 #include <iostream>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -91,6 +92,17 @@ public:
         }
     }
 
+    /** Find the index of a symbol without adding it to the table; this method is thread-safe. */
+    std::optional<RamDomain> find(const std::string& symbol) const {
+        auto lease = access.acquire();
+        (void)lease;  // avoid warning;
+        auto it = strToNum.find(symbol);
+        if (it == strToNum.end()) {
+            return std::nullopt;
+        }
+        return static_cast<RamDomain>(it->second);
+    }
+
     /** Decode a symbol index to a symbol; this method is thread-safe.  */
     const std::string& decode(const RamDomain index) const {
         {
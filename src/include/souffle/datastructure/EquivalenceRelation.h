@@ -19,7 +19,6 @@
 #pragma once
 
 #include "souffle/RamTypes.h"
-#include "souffle/datastructure/LambdaBTree.h"
 #include "souffle/datastructure/PiggyList.h"
 #include "souffle/datastructure/UnionFind.h"
 #include "souffle/utility/ContainerUtil.h"
@@ -27,9 +26,9 @@
 #include <atomic>
 #include <cassert>
 #include <cstddef>
-#include <functional>
 #include <iostream>
 #include <iterator>
+#include <map>
 #include <set>
 #include <shared_mutex>
 #include <stdexcept>
@@ -44,16 +43,15 @@ class EquivalenceRelation {
 
     // mapping from representative to disjoint set
     // just a cache, essentially, used for iteration over
+    // maintained incrementally, i.e., only classes changed since the last generation are updated
     using StatesList = souffle::PiggyList<value_type>;
     using StatesBucket = StatesList*;
-    using StorePair = std::pair<value_type, StatesBucket>;
-    using StatesMap = souffle::LambdaBTreeSet<StorePair, std::function<StatesBucket(StorePair&)>,
-            souffle::EqrelMapComparator<StorePair>>;
+    using StatesMap = std::map<value_type, StatesBucket>;
 
 public:
     using element_type = TupleType;
 
-    EquivalenceRelation() : statesMapStale(false){};
+    EquivalenceRelation() : statesMapStale(false), pairCountStale(false){};
     ~EquivalenceRelation() {
         emptyPartition();
     }
@@ -100,8 +98,9 @@ public:
     bool insert(value_type x, value_type y, operation_hints) {
         // indicate that iterators will have to generate on request
         this->statesMapStale.store(true, std::memory_order_relaxed);
+        this->pairCountStale.store(true, std::memory_order_relaxed);
         bool retval = contains(x, y);
-        sds.unionNodes(x, y);
+        unionClasses(x, y);
         return retval;
     }
 
@@ -113,18 +112,56 @@ public:
         other.genAllDisjointSetLists();
 
         // iterate over partitions at a time
-        for (typename StatesMap::chunk it : other.equivalencePartition.getChunks(MAX_THREADS)) {
-            for (auto& p : it) {
-                value_type rep = p.first;
-                StatesList& pl = *p.second;
-                const std::size_t ksize = pl.size();
-                for (std::size_t i = 0; i < ksize; ++i) {
-                    this->sds.unionNodes(rep, pl.get(i));
-                }
+        for (auto& p : other.equivalencePartition) {
+            value_type rep = p.first;
+            StatesList& pl = *p.second;
+            const std::size_t ksize = pl.size();
+            for (std::size_t i = 0; i < ksize; ++i) {
+                this->unionClasses(rep, pl.get(i));
             }
         }
         // invalidate iterators unconditionally
         this->statesMapStale.store(true, std::memory_order_relaxed);
+        this->pairCountStale.store(true, std::memory_order_relaxed);
+    }
+
+    /**
+     * Insert an element together with a member of its class, e.g. the representative written
+     * by forEachClassMember. Unlike insert, no membership test is performed.
+     * @param element the element to be added
+     * @param representative a member of the class of the element
+     */
+    void insertClassMember(value_type element, value_type representative) {
+        this->statesMapStale.store(true, std::memory_order_relaxed);
+        this->pairCountStale.store(true, std::memory_order_relaxed);
+        unionClasses(element, representative);
+    }
+
+    /**
+     * Apply a function to each element and the representative of its class, i.e., the smallest
+     * element of the class. This describes the relation in linear space, as opposed to iterating
+     * over all pairs, which is quadratic in the size of the classes.
+     * @param f the function called with each (element, representative) pair
+     */
+    template <typename F>
+    void forEachClassMember(F&& f) const {
+        const std::size_t numElements = sds.ds.a_blocks.size();
+
+        // determine the smallest element of each class, indexed by the dense root
+        std::vector<value_type> smallest(numElements);
+        std::vector<bool> visited(numElements, false);
+        for (std::size_t i = 0; i < numElements; ++i) {
+            const parent_t root = sds.ds.findNode(i);
+            const value_type element = sds.toSparse(i);
+            if (!visited[root] || element < smallest[root]) {
+                smallest[root] = element;
+                visited[root] = true;
+            }
+        }
+
+        for (std::size_t i = 0; i < numElements; ++i) {
+            f(sds.toSparse(i), smallest[sds.ds.findNode(i)]);
+        }
     }
 
     /**
@@ -205,6 +242,8 @@ public:
         this->statesMapStale.store(true, std::memory_order_relaxed);
 
         equivalencePartition.clear();
+        partitionedElements = 0;
+        linkedRoots.clear();
     }
 
     /**
@@ -215,27 +254,62 @@ public:
 
         sds.clear();
         emptyPartition();
+        pairCount = 0;
+        pairCountStale.store(false, std::memory_order_relaxed);
 
         statesLock.unlock();
     }
 
     /**
      * Size of relation
+     * The number of pairs is computed from the sizes of the disjoint sets and cached until the
+     * relation is modified.
      * @return the sum of the number of pairs per disjoint set
      */
     std::size_t size() const {
-        genAllDisjointSetLists();
-
-        statesLock.lock_shared();
+        if (!pairCountStale.load(std::memory_order_acquire)) {
+            return pairCount;
+        }
 
-        std::size_t retVal = 0;
-        for (auto& e : this->equivalencePartition) {
-            const std::size_t s = e.second->size();
-            retVal += s * s;
+        statesLock.lock();
+        if (pairCountStale.load(std::memory_order_acquire)) {
+            std::size_t retVal = 0;
+            if (!statesMapStale.load(std::memory_order_acquire)) {
+                // the partition is up to date, hence the class sizes are known
+                for (auto& e : this->equivalencePartition) {
+                    const std::size_t s = e.second->size();
+                    retVal += s * s;
+                }
+            } else {
+                // count the members of each class by their dense root
+                const std::size_t numElements = sds.ds.a_blocks.size();
+                std::vector<std::size_t> classSize(numElements, 0);
+                for (std::size_t i = 0; i < numElements; ++i) {
+                    classSize[sds.ds.findNode(i)]++;
+                }
+                for (const std::size_t s : classSize) {
+                    retVal += s * s;
+                }
+            }
+            pairCount = retVal;
+            pairCountStale.store(false, std::memory_order_release);
         }
+        statesLock.unlock();
+        return pairCount;
+    }
 
-        statesLock.unlock_shared();
-        return retVal;
+    /**
+     * Determines the amount of memory used by this relation, including the cached partition
+     * of its equivalence classes
+     */
+    std::size_t getMemoryUsage() const {
+        std::size_t res = sizeof(*this) - sizeof(sds) + sds.getMemoryUsage();
+        statesLock.lock();
+        for (const auto& cur : equivalencePartition) {
+            res += sizeof(typename StatesMap::value_type) + cur.second->getMemoryUsage();
+        }
+        statesLock.unlock();
+        return res;
     }
 
     // an almighty iterator for several types of iteration.
@@ -591,7 +665,7 @@ public:
      * Check emptiness.
      */
     bool empty() const {
-        return this->size() == 0;
+        return sds.size() == 0;
     }
 
     /**
@@ -604,7 +678,7 @@ public:
         genAllDisjointSetLists();
 
         // locate the blocklist that the anterior val resides in
-        auto found = equivalencePartition.find({sds.findNode(anteriorVal), nullptr});
+        auto found = equivalencePartition.find(sds.findNode(anteriorVal));
         assert(found != equivalencePartition.end() && "iterator called on partition that doesn't exist");
 
         return iterator(static_cast<const EquivalenceRelation*>(this),
@@ -626,7 +700,7 @@ public:
         genAllDisjointSetLists();
 
         // locate the blocklist that the val resides in
-        auto found = equivalencePartition.find({sds.findNode(posteriorVal), nullptr});
+        auto found = equivalencePartition.find(sds.findNode(posteriorVal));
         assert(found != equivalencePartition.end() && "iterator called on partition that doesn't exist");
 
         return iterator(this, anteriorVal, posteriorVal, (*found).second);
@@ -641,7 +715,7 @@ public:
         genAllDisjointSetLists();
 
         // locate the blocklist that the val resides in
-        auto found = equivalencePartition.find({sds.findNode(rep), nullptr});
+        auto found = equivalencePartition.find(sds.findNode(rep));
         return iterator(this, (*found).second);
     }
 
@@ -715,9 +789,33 @@ private:
     // whether the cache is stale
     mutable std::atomic<bool> statesMapStale;
 
+    // number of elements (in dense order) covered by the cache
+    mutable std::size_t partitionedElements = 0;
+    // dense roots linked below another root since the cache was generated
+    mutable souffle::PiggyList<parent_t> linkedRoots;
+
+    // cached number of pairs
+    mutable std::size_t pairCount = 0;
+    // whether the cached number of pairs is stale
+    mutable std::atomic<bool> pairCountStale;
+
+    /**
+     * Union the classes of two elements, recording the root which ceased to be a root
+     * such that the cache can be updated incrementally.
+     */
+    void unionClasses(value_type x, value_type y) {
+        if (auto linked = sds.unionNodes(x, y)) {
+            linkedRoots.append(*linked);
+        }
+    }
+
     /**
      * Generate a cache of the sets such that they can be iterated over efficiently.
      * Each set is partitioned into a PiggyList.
+     *
+     * Only the changes since the last generation are applied: the set of each root that was
+     * linked below another root is merged into the set of its new root (the smaller set into
+     * the larger one), and elements added since are appended to the set of their root.
      */
     void genAllDisjointSetLists() const {
         statesLock.lock();
@@ -728,22 +826,51 @@ private:
             return;
         }
 
-        // btree version
-        emptyPartition();
-
-        std::size_t dSetSize = this->sds.ds.a_blocks.size();
-        for (std::size_t i = 0; i < dSetSize; ++i) {
-            typename TupleType::value_type sparseVal = this->sds.toSparse(i);
-            parent_t rep = this->sds.findNode(sparseVal);
+        // merge the sets of former roots into the sets of their current roots
+        const std::size_t numLinked = linkedRoots.size();
+        for (std::size_t i = 0; i < numLinked; ++i) {
+            const parent_t linked = linkedRoots.get(i);
+            auto found = equivalencePartition.find(sds.toSparse(linked));
+            // roots added since the last generation have no set yet
+            if (found == equivalencePartition.end()) {
+                continue;
+            }
+            StatesBucket members = found->second;
+            equivalencePartition.erase(found);
 
-            StorePair p = {static_cast<value_type>(rep), nullptr};
-            StatesList* mapList = equivalencePartition.insert(p, [&](StorePair& sp) {
-                auto* r = new StatesList(1);
-                sp.second = r;
-                return r;
-            });
-            mapList->append(sparseVal);
+            StatesBucket& target = equivalencePartition[sds.toSparse(sds.ds.findNode(linked))];
+            if (target == nullptr) {
+                target = members;
+                continue;
+            }
+            if (target->size() < members->size()) {
+                std::swap(target, members);
+            }
+            const std::size_t numMembers = members->size();
+            for (std::size_t j = 0; j < numMembers; ++j) {
+                target->append(members->get(j));
+            }
+            delete members;
+        }
+        linkedRoots.clear();
+
+        // add new elements to the sets of their roots
+        const std::size_t dSetSize = this->sds.ds.a_blocks.size();
+        StatesBucket lastList = nullptr;
+        parent_t lastRep = 0;
+        for (std::size_t i = partitionedElements; i < dSetSize; ++i) {
+            const parent_t rep = this->sds.ds.findNode(i);
+            if (lastList == nullptr || rep != lastRep) {
+                StatesBucket& mapList = equivalencePartition[sds.toSparse(rep)];
+                if (mapList == nullptr) {
+                    mapList = new StatesList(1);
+                }
+                lastList = mapList;
+                lastRep = rep;
+            }
+            lastList->append(this->sds.toSparse(i));
         }
+        partitionedElements = dSetSize;
 
         statesMapStale.store(false, std::memory_order_release);
         statesLock.unlock();
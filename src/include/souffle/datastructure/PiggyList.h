@@ -76,6 +76,17 @@ public:
         return numElements.load();
     }
 
+    /** Determines the amount of memory used by this list */
+    std::size_t getMemoryUsage() const {
+        std::size_t res = sizeof(*this);
+        for (std::size_t i = 0; i < maxContainers; ++i) {
+            if (blockLookupTable[i].load() != nullptr) {
+                res += (INITIALBLOCKSIZE << i) * sizeof(T);
+            }
+        }
+        return res;
+    }
+
     inline T* getBlock(std::size_t blockNum) const {
         return blockLookupTable[blockNum];
     }
@@ -182,6 +193,11 @@ public:
         return m_size.load();
     };
 
+    /** Determines the amount of memory used by this list */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) + container_size.load() * sizeof(T);
+    }
+
     inline T* getBlock(std::size_t blocknum) const {
         return this->blockLookupTable[blocknum];
     }
@@ -102,6 +102,11 @@ public:
         return count;
     }
 
+    /** Determines the amount of memory used by this table */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) + (count + blockSize - 1) / blockSize * sizeof(Block);
+    }
+
     const T& insert(const T& element) {
         // check whether the head is initialized
         if (!head) {
@@ -23,6 +23,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <optional>
 #include <utility>
 
 namespace souffle {
@@ -73,6 +74,13 @@ public:
         return sz;
     };
 
+    /**
+     * Determines the amount of memory used by this disjoint set
+     */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) - sizeof(a_blocks) + a_blocks.getMemoryUsage();
+    }
+
     /**
      * Yield reference to the node by its node index
      * @param node node to be searched
@@ -156,14 +164,15 @@ public:
      * Union the two specified index nodes
      * @param x node to be unioned
      * @param y node to be unioned
+     * @return the root that was linked below the other root, if the nodes were in different sets
      */
-    void unionNodes(parent_t x, parent_t y) {
+    std::optional<parent_t> unionNodes(parent_t x, parent_t y) {
         while (true) {
             x = findNode(x);
             y = findNode(y);
 
             // no need to union if both already in same set
-            if (x == y) return;
+            if (x == y) return std::nullopt;
 
             rank_t xrank = b2r(get(x));
             rank_t yrank = b2r(get(y));
@@ -182,7 +191,7 @@ public:
             if (xrank == yrank) {
                 updateRoot(y, yrank, y, yrank + 1);
             }
-            break;
+            return x;
         }
     }
 
@@ -318,15 +327,24 @@ public:
     inline SparseDomain findNode(SparseDomain x) {
         return toSparse(ds.findNode(toDense(x)));
     };
-    /* union the nodes, add if not existing */
-    inline void unionNodes(SparseDomain x, SparseDomain y) {
-        ds.unionNodes(toDense(x), toDense(y));
+    /* union the nodes, add if not existing; yields the dense root linked below the other root, if any */
+    inline std::optional<parent_t> unionNodes(SparseDomain x, SparseDomain y) {
+        return ds.unionNodes(toDense(x), toDense(y));
     };
 
     inline std::size_t size() {
         return ds.size();
     };
 
+    /**
+     * Determines the amount of memory used by this disjoint set, including the maps between
+     * sparse and dense values
+     */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) - sizeof(ds) - sizeof(sparseToDenseMap) - sizeof(denseToSparseMap) +
+               ds.getMemoryUsage() + sparseToDenseMap.getMemoryUsage() + denseToSparseMap.getMemoryUsage();
+    }
+
     /**
      * Remove all elements from this disjoint set
      */
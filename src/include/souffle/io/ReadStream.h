@@ -46,6 +46,12 @@ public:
         (void)lease;
         while (const auto next = readNextTuple()) {
             const RamDomain* ramDomain = next.get();
+            if constexpr (HasClassMemberInsertion<T>::value) {
+                if (eqrelClasses) {
+                    relation.insertClassMember(ramDomain[0], ramDomain[1]);
+                    continue;
+                }
+            }
             relation.insert(ramDomain);
         }
     }
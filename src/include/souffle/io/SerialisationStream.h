@@ -24,6 +24,7 @@
 #include <cstddef>
 #include <map>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -34,6 +35,22 @@ class SymbolTable;
 
 using json11::Json;
 
+/** Detects relations which can be written as one (element, representative) pair per element */
+template <typename T, typename = void>
+struct HasClassMembers : std::false_type {};
+
+template <typename T>
+struct HasClassMembers<T, std::void_t<decltype(std::declval<const T&>().forEachClassMember(
+                                  std::declval<void (*)(RamDomain, RamDomain)>()))>> : std::true_type {};
+
+/** Detects relations which can be read from (element, representative) pairs */
+template <typename T, typename = void>
+struct HasClassMemberInsertion : std::false_type {};
+
+template <typename T>
+struct HasClassMemberInsertion<T, std::void_t<decltype(std::declval<T&>().insertClassMember(
+                                          RamDomain(), RamDomain()))>> : std::true_type {};
+
 template <bool readOnlyTables>
 class SerialisationStream {
 public:
@@ -62,6 +79,7 @@ protected:
         assert(parseErrors.size() == 0 && "Internal JSON parsing failed.");
 
         auxiliaryArity = RamSignedFromString(getOr(rwOperation, "auxArity", "0"));
+        eqrelClasses = getOr(rwOperation, "classes", "false") == "true";
 
         setupFromJson();
     }
@@ -74,6 +92,9 @@ protected:
     std::size_t arity = 0;
     std::size_t auxiliaryArity = 0;
 
+    /** Whether an equivalence relation is represented by one (element, representative) pair per element */
+    bool eqrelClasses = false;
+
 private:
     void setupFromJson() {
         auto&& relInfo = types["relation"];
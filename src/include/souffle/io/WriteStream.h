@@ -45,6 +45,9 @@ public:
         }
         auto lease = symbolTable.acquireLock();
         (void)lease;  // silence "unused variable" warning
+        if (eqrelClasses) {
+            return writeClasses(relation);
+        }
         if (arity == 0) {
             if (relation.begin() != relation.end()) {
                 writeNullary();
@@ -64,6 +67,19 @@ public:
 protected:
     const bool summary;
 
+    /** Write an equivalence relation as one (element, representative) pair per element */
+    template <typename T>
+    void writeClasses(const T& relation) {
+        if constexpr (HasClassMembers<T>::value) {
+            relation.forEachClassMember([&](RamDomain element, RamDomain representative) {
+                const RamDomain tuple[2] = {element, representative};
+                writeNextTuple(tuple);
+            });
+        } else {
+            fatal("classes=true requires an equivalence relation");
+        }
+    }
+
     virtual void writeNullary() = 0;
     virtual void writeNextTuple(const RamDomain* tuple) = 0;
     virtual void writeSize(std::size_t) {
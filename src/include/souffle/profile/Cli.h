@@ -9,8 +9,11 @@
 #pragma once
 
 #include "souffle/profile/StringUtils.h"
+#include "souffle/profile/TraceExporter.h"
 #include "souffle/profile/Tui.h"
 
+#include <exception>
+#include <fstream>
 #include <iostream>
 #include <map>
 #include <string>
@@ -32,7 +35,7 @@ public:
         int c;
         option longOptions[1];
         longOptions[0] = {nullptr, 0, nullptr, 0};
-        while ((c = getopt_long(argc, argv, "c:hj::", longOptions, nullptr)) != EOF) {
+        while ((c = getopt_long(argc, argv, "c:hj::t:", longOptions, nullptr)) != EOF) {
             // An invalid argument was given
             if (c == '?') {
                 exit(EXIT_FAILURE);
@@ -60,7 +63,8 @@ public:
 
         if (args.count('h') != 0 || args.count('f') == 0) {
             std::cout << "Souffle Profiler" << std::endl
-                      << "Usage: souffle-profile <log-file> [ -h | -c <command> [options] | -j ]" << std::endl
+                      << "Usage: souffle-profile <log-file> [ -h | -c <command> [options] | -j | -t <file> ]"
+                      << std::endl
                       << "<log-file>            The log file to profile." << std::endl
                       << "-c <command>          Run the given command on the log file, try with  "
                          "'-c help' for a list"
@@ -69,6 +73,8 @@ public:
                       << "-j[filename]          Generate a GUI (html/js) version of the profiler."
                       << std::endl
                       << "                      Default filename is profiler_html/[num].html" << std::endl
+                      << "-t <file>             Export the profile as a Chrome trace, e.g. for Perfetto."
+                      << std::endl
                       << "-h                    Print this help message." << std::endl;
             exit(0);
         }
@@ -79,6 +85,8 @@ public:
             for (auto& command : Tools::split(args['c'], ";")) {
                 tui.runCommand(Tools::split(command, " "));
             }
+        } else if (args.count('t') != 0) {
+            exportTrace(filename, args['t']);
         } else if (args.count('j') != 0) {
             if (args['j'] == "j") {
                 Tui(filename, false, true).outputHtml();
@@ -89,6 +97,27 @@ public:
             Tui(filename, true, false).runProf();
         }
     }
+
+    /** Export the log file as a Chrome trace without loading it into a profile database */
+    static void exportTrace(const std::string& filename, const std::string& traceFilename) {
+        std::ifstream in(filename);
+        if (!in.is_open()) {
+            std::cerr << "Log file " << filename << " could not be opened." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        std::ofstream out(traceFilename);
+        if (!out.is_open()) {
+            std::cerr << "Trace file " << traceFilename << " could not be opened." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        try {
+            TraceExporter(out).exportLog(in);
+        } catch (const std::exception& e) {
+            std::cerr << "exception whilst exporting profile: " << e.what() << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        std::cout << "trace output to: " << traceFilename << std::endl;
+    }
 };
 
 }  // namespace profile
@@ -0,0 +1,328 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file EventBuffer.h
+ *
+ * Declares the buffers recording profile events as binary records
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+namespace profile {
+
+/** Kinds of profile events, determining the values of a record */
+enum class EventKind : uint32_t {
+    /** value: interned text of the configuration value */
+    Config,
+    /** values: time */
+    Time,
+    /** values: start, end, start max RSS, end max RSS, size, iteration */
+    Timing,
+    /** values: cycles, instructions, LLC misses, branch misses, iteration */
+    Counter,
+    /** values: thread, start, end, busy time, iteration */
+    Thread,
+    /** values: number, iteration */
+    Quantity,
+    /** values: time, system time, user time, max RSS */
+    Utilisation
+};
+
+/**
+ * Profile event recorded as a fixed-size binary record
+ *
+ * The text of the event is interned; the sequence number restores the
+ * order in which the events of all threads have been recorded.
+ */
+struct EventRecord {
+    uint64_t sequence;
+    EventKind kind;
+    uint32_t text;
+    std::array<uint64_t, 6> values;
+};
+
+/**
+ * Ring buffer of the events of a thread
+ *
+ * The ring has a single producer, the thread owning it, which never blocks.
+ * Consumers move the records out of the ring one at a time.
+ */
+class EventRing {
+public:
+    static constexpr std::size_t CAPACITY = 1024;
+
+    /** Append a record; returns false if the ring is full */
+    bool push(const EventRecord& record) {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == CAPACITY) {
+            return false;
+        }
+        records[h % CAPACITY] = record;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Number of records in the ring */
+    std::size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    /** Move the records of the ring to the end of the given vector */
+    void drain(std::vector<EventRecord>& out) {
+        std::lock_guard<std::mutex> guard(consumer);
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        const std::size_t h = head.load(std::memory_order_acquire);
+        for (; t != h; ++t) {
+            out.push_back(records[t % CAPACITY]);
+        }
+        tail.store(t, std::memory_order_release);
+    }
+
+    /** Whether a thread currently records into the ring */
+    std::atomic<bool> owned{false};
+
+private:
+    std::array<EventRecord, CAPACITY> records;
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+    std::mutex consumer;
+};
+
+/**
+ * Buffer of profile events
+ *
+ * Each thread records its events into a ring of its own, without locks.
+ * The texts of the events are interned, so that recording an event only
+ * looks up its text in a cache of the thread. A background thread moves
+ * the records of the rings into a central store, and the events are only
+ * converted by the caller of take(), e.g. into the profile database when
+ * the program terminates.
+ *
+ * The rings of terminated threads are reused by new threads.
+ */
+class EventBuffer {
+public:
+    EventBuffer() : id(nextId()) {}
+
+    ~EventBuffer() {
+        stop();
+    }
+
+    EventBuffer(const EventBuffer&) = delete;
+    EventBuffer& operator=(const EventBuffer&) = delete;
+
+    /** Record an event of the calling thread */
+    void record(EventKind kind, const std::string& text, std::array<uint64_t, 6> values) {
+        EventRing& ring = localRing();
+        EventRecord record{sequence.fetch_add(1, std::memory_order_relaxed), kind, intern(text), values};
+        if (!ring.push(record)) {
+            // the flusher is behind; make room by moving the records to the store ourselves
+            moveToStore(ring);
+            ring.push(record);
+        } else if (ring.size() >= EventRing::CAPACITY / 2 && !flushRequested.exchange(true)) {
+            flushCondition.notify_one();
+        }
+    }
+
+    /** Intern a text, returning its id */
+    uint32_t intern(const std::string& text) {
+        LocalState& local = localState();
+        auto it = local.ids.find(text);
+        if (it != local.ids.end()) {
+            return it->second;
+        }
+        std::lock_guard<std::mutex> guard(internMutex);
+        auto inserted = ids.emplace(text, static_cast<uint32_t>(texts.size()));
+        if (inserted.second) {
+            texts.push_back(text);
+        }
+        local.ids.emplace(text, inserted.first->second);
+        return inserted.first->second;
+    }
+
+    /** Text of an interned id */
+    const std::string& getText(uint32_t textId) {
+        std::lock_guard<std::mutex> guard(internMutex);
+        return texts[textId];
+    }
+
+    /** Remove all recorded events and return them in the order in which they have been recorded */
+    std::vector<EventRecord> take() {
+        std::vector<EventRecord> result;
+        {
+            std::lock_guard<std::mutex> guard(storeMutex);
+            drainRings();
+            result.swap(store);
+        }
+        std::sort(result.begin(), result.end(),
+                [](const EventRecord& a, const EventRecord& b) { return a.sequence < b.sequence; });
+        return result;
+    }
+
+    /** Stop the background thread; events are still recorded */
+    void stop() {
+        {
+            std::lock_guard<std::mutex> guard(flushMutex);
+            if (!flushing) {
+                return;
+            }
+            flushing = false;
+        }
+        flushCondition.notify_all();
+        flusher.join();
+    }
+
+private:
+    /** Interval in which the background thread moves the records into the store */
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL{10};
+
+    static std::size_t nextId() {
+        static std::atomic<std::size_t> counter{0};
+        return ++counter;
+    }
+
+    /**
+     * Ring and interned texts of a thread
+     *
+     * The ring is shared with the buffer, so that it can be released even
+     * if the thread outlives the buffer.
+     */
+    struct LocalState {
+        std::size_t buffer = 0;
+        std::shared_ptr<EventRing> ring;
+        std::unordered_map<std::string, uint32_t> ids;
+
+        ~LocalState() {
+            release();
+        }
+
+        void release() {
+            if (ring != nullptr) {
+                ring->owned.store(false, std::memory_order_release);
+                ring = nullptr;
+            }
+        }
+    };
+
+    LocalState& localState() {
+        thread_local LocalState local;
+        if (local.buffer != id) {
+            local.release();
+            local.buffer = id;
+            local.ids.clear();
+        }
+        return local;
+    }
+
+    EventRing& localRing() {
+        LocalState& local = localState();
+        if (local.ring == nullptr) {
+            local.ring = acquireRing();
+        }
+        return *local.ring;
+    }
+
+    /** Find a ring which is not owned by a thread, or create one */
+    std::shared_ptr<EventRing> acquireRing() {
+        std::lock_guard<std::mutex> guard(ringMutex);
+        for (auto& ring : rings) {
+            bool expected = false;
+            if (ring->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return ring;
+            }
+        }
+        rings.push_back(std::make_shared<EventRing>());
+        rings.back()->owned.store(true, std::memory_order_relaxed);
+        start();
+        return rings.back();
+    }
+
+    /** Start the background thread if it is not running */
+    void start() {
+        std::lock_guard<std::mutex> guard(flushMutex);
+        if (flushing) {
+            return;
+        }
+        flushing = true;
+        flusher = std::thread([this]() {
+            std::unique_lock<std::mutex> lock(flushMutex);
+            while (flushing) {
+                flushCondition.wait_for(lock, FLUSH_INTERVAL);
+                flushRequested = false;
+                lock.unlock();
+                {
+                    std::lock_guard<std::mutex> guard(storeMutex);
+                    drainRings();
+                }
+                lock.lock();
+            }
+        });
+    }
+
+    void moveToStore(EventRing& ring) {
+        std::lock_guard<std::mutex> guard(storeMutex);
+        ring.drain(store);
+    }
+
+    /** Move the records of all rings into the store; the store must be locked */
+    void drainRings() {
+        std::lock_guard<std::mutex> guard(ringMutex);
+        for (auto& ring : rings) {
+            ring->drain(store);
+        }
+    }
+
+    /** identifies the buffer in the state of the threads */
+    const std::size_t id;
+
+    /** sequence number of the next event */
+    std::atomic<uint64_t> sequence{0};
+
+    /** rings of the threads */
+    std::vector<std::shared_ptr<EventRing>> rings;
+    std::mutex ringMutex;
+
+    /** records moved out of the rings */
+    std::vector<EventRecord> store;
+    std::mutex storeMutex;
+
+    /** interned texts */
+    std::unordered_map<std::string, uint32_t> ids;
+    std::deque<std::string> texts;
+    std::mutex internMutex;
+
+    /** background thread */
+    std::thread flusher;
+    bool flushing = false;
+    std::atomic<bool> flushRequested{false};
+    std::condition_variable flushCondition;
+    std::mutex flushMutex;
+};
+
+}  // namespace profile
+}  // namespace souffle
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "souffle/profile/HardwareCounters.h"
 #include "souffle/profile/ProfileDatabase.h"
 #include "souffle/utility/MiscUtil.h"
 #include "souffle/utility/StreamUtil.h"
@@ -203,6 +204,50 @@ public:
     }
 } nonRecursiveRuleTimingProcessor;
 
+/**
+ * Non-Recursive Rule Hardware Counter Profile Event Processor
+ */
+const class NonRecursiveRuleCounterProcessor : public EventProcessor {
+public:
+    NonRecursiveRuleCounterProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@hw-nonrecursive-rule", this);
+    }
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string& relation = signature[1];
+        const std::string& rule = signature[3];
+        for (const char* counter : HardwareCounters::getNames()) {
+            std::size_t value = va_arg(args, std::size_t);
+            db.addSizeEntry(
+                    {"program", "relation", relation, "non-recursive-rule", rule, "counters", counter},
+                    value);
+        }
+    }
+} nonRecursiveRuleCounterProcessor;
+
+/**
+ * Non-Recursive Rule Thread Profile Event Processor
+ */
+const class NonRecursiveRuleThreadProcessor : public EventProcessor {
+public:
+    NonRecursiveRuleThreadProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@thread-nonrecursive-rule", this);
+    }
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string& relation = signature[1];
+        const std::string& rule = signature[3];
+        std::string thread = std::to_string(va_arg(args, std::size_t));
+        microseconds start = va_arg(args, microseconds);
+        microseconds end = va_arg(args, microseconds);
+        std::size_t busy = va_arg(args, std::size_t);
+        db.addDurationEntry(
+                {"program", "relation", relation, "non-recursive-rule", rule, "thread", thread, "runtime"},
+                start, end);
+        db.addSizeEntry(
+                {"program", "relation", relation, "non-recursive-rule", rule, "thread", thread, "busy"},
+                busy);
+    }
+} nonRecursiveRuleThreadProcessor;
+
 /**
  * Non-Recursive Rule Number Profile Event Processor
  */
@@ -260,6 +305,57 @@ public:
     }
 } recursiveRuleTimingProcessor;
 
+/**
+ * Recursive Rule Hardware Counter Profile Event Processor
+ */
+const class RecursiveRuleCounterProcessor : public EventProcessor {
+public:
+    RecursiveRuleCounterProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@hw-recursive-rule", this);
+    }
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string& relation = signature[1];
+        const std::string& version = signature[2];
+        const std::string& rule = signature[4];
+        HardwareCounters::Values values;
+        for (auto& value : values) {
+            value = va_arg(args, std::size_t);
+        }
+        std::string iteration = std::to_string(va_arg(args, std::size_t));
+        for (std::size_t i = 0; i < values.size(); i++) {
+            db.addSizeEntry({"program", "relation", relation, "iteration", iteration, "recursive-rule", rule,
+                                    version, "counters", HardwareCounters::getNames()[i]},
+                    values[i]);
+        }
+    }
+} recursiveRuleCounterProcessor;
+
+/**
+ * Recursive Rule Thread Profile Event Processor
+ */
+const class RecursiveRuleThreadProcessor : public EventProcessor {
+public:
+    RecursiveRuleThreadProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@thread-recursive-rule", this);
+    }
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string& relation = signature[1];
+        const std::string& version = signature[2];
+        const std::string& rule = signature[4];
+        std::string thread = std::to_string(va_arg(args, std::size_t));
+        microseconds start = va_arg(args, microseconds);
+        microseconds end = va_arg(args, microseconds);
+        std::size_t busy = va_arg(args, std::size_t);
+        std::string iteration = std::to_string(va_arg(args, std::size_t));
+        db.addDurationEntry({"program", "relation", relation, "iteration", iteration, "recursive-rule", rule,
+                                    version, "thread", thread, "runtime"},
+                start, end);
+        db.addSizeEntry({"program", "relation", relation, "iteration", iteration, "recursive-rule", rule,
+                                version, "thread", thread, "busy"},
+                busy);
+    }
+} recursiveRuleThreadProcessor;
+
 /**
  * Recursive Rule Number Profile Event Processor
  */
@@ -402,6 +498,25 @@ public:
     }
 } recursiveRelationCopyTimingProcessor;
 
+/**
+ * Relation Memory Profile Event Processor
+ */
+const class RelationMemoryProcessor : public EventProcessor {
+public:
+    RelationMemoryProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@m-relation", this);
+    }
+    /** process event input */
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string& relation = signature[1];
+        const std::string& srcLocator = signature[2];
+        const std::string& index = signature[3];
+        std::size_t bytes = va_arg(args, std::size_t);
+        db.addTextEntry({"program", "relation", relation, "source-locator"}, srcLocator);
+        db.addSizeEntry({"program", "relation", relation, "memory", index}, bytes);
+    }
+} relationMemoryProcessor;
+
 /**
  * Recursive Relation Copy Timing Profile Event Processor
  */
@@ -0,0 +1,211 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file HardwareCounters.h
+ *
+ * Declares the hardware performance counters read by the profiler
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif  // _OPENMP
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif  // __linux__
+
+namespace souffle {
+
+/**
+ * Hardware performance counters of the program
+ *
+ * The counters are opened with perf_event_open once for every thread of the
+ * OpenMP team when they are enabled. They are either read for the calling
+ * thread only, or summed up over the team, so that the events of the worker
+ * threads of a parallel rule are attributed to the rule as well; the sum
+ * includes the events of idle threads waiting for work, hence it is only
+ * meaningful for parallel operations. Threads outside of the team, such as
+ * the background threads of the profiler, are not counted.
+ *
+ * Counters are only available on Linux; counters which are not supported by
+ * the processor or not permitted by the kernel read as zero.
+ */
+class HardwareCounters {
+public:
+    /** Number of counters */
+    static constexpr std::size_t SIZE = 4;
+
+    /** Values of the counters in the order of their names */
+    using Values = std::array<std::size_t, SIZE>;
+
+    /** get instance */
+    static HardwareCounters& instance() {
+        static HardwareCounters singleton;
+        return singleton;
+    }
+
+    /** Names of the counters as stored in the profile database */
+    static const std::array<const char*, SIZE>& getNames() {
+        static const std::array<const char*, SIZE> names{
+                "cycles", "instructions", "llc-misses", "branch-misses"};
+        return names;
+    }
+
+    ~HardwareCounters() {
+#ifdef __linux__
+        for (const Descriptors& fds : threads) {
+            for (int fd : fds) {
+                if (fd >= 0) {
+                    close(fd);
+                }
+            }
+        }
+#endif  // __linux__
+    }
+
+    /** Open the counters for all threads of the team; returns false if no counter is available */
+    bool enable() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (enabled) {
+            return true;
+        }
+#ifdef __linux__
+        // the counters of a thread are stored at its thread number
+        const Descriptors own = open();
+        threads.push_back(own);
+#ifdef _OPENMP
+        Descriptors none;
+        none.fill(-1);
+        threads.resize(omp_get_max_threads(), none);
+#pragma omp parallel
+        {
+            std::size_t thread = omp_get_thread_num();
+            if (thread != 0 && thread < threads.size()) {
+                threads[thread] = open();
+            }
+        }
+#endif  // _OPENMP
+        for (std::size_t i = 0; i < SIZE; i++) {
+            if (own[i] < 0) {
+                std::cerr << "Warning: hardware counter " << getNames()[i] << " is not available: "
+                          << std::strerror(-own[i]) << std::endl;
+            } else {
+                enabled = true;
+            }
+        }
+#else
+        std::cerr << "Warning: hardware counters are only available on Linux" << std::endl;
+#endif  // __linux__
+        return enabled;
+    }
+
+    /** Check whether the counters have been enabled */
+    bool isEnabled() const {
+        return enabled;
+    }
+
+    /** Read the counters summed up over all threads of the team */
+    Values read() {
+        Values values{};
+#ifdef __linux__
+        if (!enabled) {
+            return values;
+        }
+        for (const Descriptors& fds : threads) {
+            add(fds, values);
+        }
+#endif  // __linux__
+        return values;
+    }
+
+    /** Read the counters of the calling thread */
+    Values readThread() {
+        Values values{};
+#ifdef __linux__
+        if (!enabled) {
+            return values;
+        }
+#ifdef _OPENMP
+        std::size_t thread = omp_get_thread_num();
+#else
+        std::size_t thread = 0;
+#endif  // _OPENMP
+        if (thread < threads.size()) {
+            add(threads[thread], values);
+        }
+#endif  // __linux__
+        return values;
+    }
+
+private:
+    HardwareCounters() = default;
+
+#ifdef __linux__
+    using Descriptors = std::array<int, SIZE>;
+
+    /** Open the counters of the calling thread; failures are stored as -errno */
+    static Descriptors open() {
+        static const std::array<std::pair<uint32_t, uint64_t>, SIZE> events{{
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        }};
+        Descriptors fds;
+        for (std::size_t i = 0; i < SIZE; i++) {
+            struct perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = events[i].first;
+            attr.config = events[i].second;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            fds[i] = fd == -1 ? -errno : fd;
+        }
+        return fds;
+    }
+
+    /** Add the values of the counters of a thread */
+    static void add(const Descriptors& fds, Values& values) {
+        for (std::size_t i = 0; i < SIZE; i++) {
+            uint64_t value = 0;
+            if (fds[i] >= 0 && ::read(fds[i], &value, sizeof(value)) == sizeof(value)) {
+                values[i] += value;
+            }
+        }
+    }
+
+    /** counters per thread of the team, opened once when enabled */
+    std::vector<Descriptors> threads;
+#endif  // __linux__
+
+    std::atomic<bool> enabled{false};
+    std::mutex mutex;
+};
+
+}  // namespace souffle
@@ -17,12 +17,19 @@
 
 #pragma once
 
+#include "souffle/profile/HardwareCounters.h"
 #include "souffle/profile/ProfileEvent.h"
 #include "souffle/utility/MiscUtil.h"
+#include <algorithm>
 #include <cstddef>
 #include <functional>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif  // _OPENMP
 
 namespace souffle {
 
@@ -52,6 +59,17 @@ public:
 #endif  // WIN32
         // Assume that if we are logging the progress of an event then we care about usage during that time.
         ProfileEventSingleton::instance().resetTimerInterval();
+        isRule = this->label.rfind("@t-nonrecursive-rule;", 0) == 0 ||
+                 this->label.rfind("@t-recursive-rule;", 0) == 0;
+        if (isRule) {
+            parent = currentLogger();
+            currentLogger() = this;
+        }
+        countersEnabled = isRule && HardwareCounters::instance().isEnabled();
+        if (countersEnabled) {
+            startCounters = HardwareCounters::instance().read();
+            startThreadCounters = HardwareCounters::instance().readThread();
+        }
     }
 
     ~Logger() {
@@ -67,14 +85,134 @@ public:
 #endif  // WIN32
         ProfileEventSingleton::instance().makeTimingEvent(
                 label, start, now(), startMaxRSS, endMaxRSS, size() - preSize, iteration);
+        if (isRule) {
+            currentLogger() = parent;
+        }
+        // the work of the threads and the counters of a rule are recorded under the label of its timer
+        for (std::size_t thread = 0; thread < threads.size(); thread++) {
+            const ThreadWork& work = threads[thread];
+            if (work.active) {
+                ProfileEventSingleton::instance().makeThreadEvent(
+                        "@thread-" + label.substr(3), thread, work.start, work.end, work.busy, iteration);
+            }
+        }
+        if (countersEnabled) {
+            // the counters of the team are only charged to rules with parallel operations, since they
+            // include the idle threads waiting for work
+            const bool parallel = !threads.empty();
+            const HardwareCounters::Values& before = parallel ? startCounters : startThreadCounters;
+            HardwareCounters::Values counters = parallel ? HardwareCounters::instance().read()
+                                                         : HardwareCounters::instance().readThread();
+            ProfileEventSingleton::instance().makeCounterEvent("@hw-" + label.substr(3),
+                    counters[0] - before[0], counters[1] - before[1], counters[2] - before[2],
+                    counters[3] - before[3], iteration);
+        }
     }
 
+    /** Logger of the rule evaluated by the current thread, or nullptr */
+    static Logger* current() {
+        return currentLogger();
+    }
+
+    /**
+     * Work of a thread in a parallel operation of a rule
+     *
+     * Each thread of the parallel region creates a timer with the logger of
+     * the rule, which has to be obtained by the thread starting the region.
+     * The work of the thread is measured per chunk, so that the time waiting
+     * for the other threads at the end of the operation is not counted.
+     */
+    class ThreadTimer {
+    public:
+        ThreadTimer(Logger* logger) : logger(logger) {
+            if (logger != nullptr) {
+                first = last = now();
+            }
+        }
+
+        ~ThreadTimer() {
+            if (logger != nullptr) {
+#ifdef _OPENMP
+                std::size_t thread = omp_get_thread_num();
+#else
+                std::size_t thread = 0;
+#endif  // _OPENMP
+                logger->addThreadWork(thread, first, last, busy);
+            }
+        }
+
+        ThreadTimer(const ThreadTimer&) = delete;
+        ThreadTimer& operator=(const ThreadTimer&) = delete;
+
+        /** Chunk of the parallel operation processed by the thread */
+        class Chunk {
+        public:
+            Chunk(ThreadTimer& timer) : timer(timer) {
+                if (timer.logger != nullptr) {
+                    start = now();
+                }
+            }
+
+            ~Chunk() {
+                if (timer.logger != nullptr) {
+                    timer.last = now();
+                    timer.busy += std::chrono::duration_cast<microseconds>(timer.last - start);
+                }
+            }
+
+            Chunk(const Chunk&) = delete;
+            Chunk& operator=(const Chunk&) = delete;
+
+        private:
+            ThreadTimer& timer;
+            time_point start;
+        };
+
+    private:
+        Logger* logger;
+        time_point first;
+        time_point last;
+        microseconds busy{0};
+    };
+
 private:
+    /** Work of a thread during the lifetime of the logger */
+    struct ThreadWork {
+        bool active = false;
+        time_point start;
+        time_point end;
+        microseconds busy{0};
+    };
+
+    static Logger*& currentLogger() {
+        thread_local Logger* logger = nullptr;
+        return logger;
+    }
+
+    void addThreadWork(std::size_t thread, time_point start, time_point end, microseconds busy) {
+        std::lock_guard<std::mutex> lock(threadMutex);
+        if (threads.size() <= thread) {
+            threads.resize(thread + 1);
+        }
+        ThreadWork& work = threads[thread];
+        work.start = work.active ? std::min(work.start, start) : start;
+        work.end = work.active ? std::max(work.end, end) : end;
+        work.busy += busy;
+        work.active = true;
+    }
+
     std::string label;
     time_point start;
     std::size_t startMaxRSS;
     std::size_t iteration;
     std::function<std::size_t()> size;
     std::size_t preSize;
+    bool isRule;
+    Logger* parent = nullptr;
+    bool countersEnabled;
+    HardwareCounters::Values startCounters{};
+    HardwareCounters::Values startThreadCounters{};
+    std::vector<ThreadWork> threads;
+    std::mutex threadMutex;
 };
 }  // end of namespace souffle
@@ -16,7 +16,10 @@
 #include "souffle/profile/Row.h"
 #include "souffle/profile/Rule.h"
 #include "souffle/profile/Table.h"
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
+#include <map>
 #include <memory>
 #include <ratio>
 #include <set>
@@ -48,6 +51,10 @@ public:
 
     Table getRulTable() const;
 
+    Table getCountersTable() const;
+
+    Table getMemoryTable() const;
+
     Table getSubrulTable(std::string strRel, std::string strRul) const;
 
     Table getAtomTable(std::string strRel, std::string strRul) const;
@@ -117,16 +124,39 @@ Table inline OutputProcessor::getRelTable() const {
  * ROW[8] = PERFOR
  * ROW[9] = VER
  * ROW[10]= REL_NAME
+ * ROW[11]= IMBALANCE
+ *
+ * The load imbalance of a rule evaluated in parallel is the ratio of the work of the busiest thread
+ * to the average work of all threads, summed up over all evaluations; it is 1 if the work is evenly
+ * distributed and empty if the rule has not been evaluated in parallel.
  */
 Table inline OutputProcessor::getRulTable() const {
     const std::unordered_map<std::string, std::shared_ptr<Relation>>& relationMap =
             programRun->getRelationMap();
     std::unordered_map<std::string, std::shared_ptr<Row>> ruleMap;
+    // maximal and average work of the threads per rule
+    std::unordered_map<std::string, std::pair<double, double>> threadWork;
+    auto addThreadWork = [&](const Rule& rule) {
+        if (rule.getThreads().empty()) {
+            return;
+        }
+        double max = 0;
+        double total = 0;
+        for (const auto& cur : rule.getThreads()) {
+            double busy = cur.second.busy.count();
+            max = std::max(max, busy);
+            total += busy;
+        }
+        auto& work = threadWork[rule.getName()];
+        work.first += max;
+        work.second += total / rule.getThreads().size();
+    };
 
     for (auto& rel : relationMap) {
         for (auto& current : rel.second->getRuleMap()) {
-            Row row(11);
+            Row row(12);
             std::shared_ptr<Rule> rule = current.second;
+            addThreadWork(*rule);
             row[0] = std::make_shared<Cell<std::chrono::microseconds>>(rule->getRuntime());
             row[1] = std::make_shared<Cell<std::chrono::microseconds>>(rule->getRuntime());
             row[2] = std::make_shared<Cell<std::chrono::microseconds>>(std::chrono::microseconds(0));
@@ -142,6 +172,7 @@ Table inline OutputProcessor::getRulTable() const {
         for (auto& iter : rel.second->getIterations()) {
             for (auto& current : iter->getRules()) {
                 std::shared_ptr<Rule> rule = current.second;
+                addThreadWork(*rule);
                 if (ruleMap.find(rule->getName()) != ruleMap.end()) {
                     Row row = *ruleMap[rule->getName()];
                     row[2] = std::make_shared<Cell<std::chrono::microseconds>>(
@@ -151,7 +182,7 @@ Table inline OutputProcessor::getRulTable() const {
                             row[0]->getTimeVal() + rule->getRuntime());
                     ruleMap[rule->getName()] = std::make_shared<Row>(row);
                 } else {
-                    Row row(11);
+                    Row row(12);
                     row[0] = std::make_shared<Cell<std::chrono::microseconds>>(rule->getRuntime());
                     row[1] = std::make_shared<Cell<std::chrono::microseconds>>(std::chrono::microseconds(0));
                     row[2] = std::make_shared<Cell<std::chrono::microseconds>>(rule->getRuntime());
@@ -178,6 +209,10 @@ Table inline OutputProcessor::getRulTable() const {
             } else {
                 t[9] = std::make_shared<Cell<double>>(t[4]->getLongVal() / 1.0);
             }
+            auto work = threadWork.find(current.first);
+            if (work != threadWork.end() && work->second.second > 0) {
+                t[11] = std::make_shared<Cell<double>>(work->second.first / work->second.second);
+            }
             current.second = std::make_shared<Row>(t);
         }
     }
@@ -189,6 +224,118 @@ Table inline OutputProcessor::getRulTable() const {
     return table;
 }
 
+/*
+ * counters table :
+ * ROW[0] = CYCLES
+ * ROW[1] = INSTRUCTIONS
+ * ROW[2] = IPC
+ * ROW[3] = LLC_MISSES
+ * ROW[4] = BRANCH_MISSES
+ * ROW[5] = RUL NAME
+ * ROW[6] = ID
+ * ROW[7] = REL_NAME
+ * ROW[8] = SRC
+ *
+ * The counters of recursive rules are summed up over all iterations and versions.
+ * Rows are ordered by decreasing number of cycles.
+ */
+Table inline OutputProcessor::getCountersTable() const {
+    std::map<std::string, std::shared_ptr<Row>> ruleMap;
+    auto addRule = [&](const Relation& rel, const Rule& rule) {
+        if (!rule.hasCounters()) {
+            return;
+        }
+        auto it = ruleMap.find(rule.getName());
+        if (it == ruleMap.end()) {
+            Row row(9);
+            for (std::size_t i : {0, 1, 3, 4}) {
+                row[i] = std::make_shared<Cell<long>>(0);
+            }
+            row[5] = std::make_shared<Cell<std::string>>(rule.getName());
+            row[6] = std::make_shared<Cell<std::string>>(rule.getId());
+            row[7] = std::make_shared<Cell<std::string>>(rel.getName());
+            row[8] = std::make_shared<Cell<std::string>>(rule.getLocator());
+            it = ruleMap.emplace(rule.getName(), std::make_shared<Row>(row)).first;
+        }
+        Row& row = *it->second;
+        row[0] = std::make_shared<Cell<long>>(row[0]->getLongVal() + rule.getCounter("cycles"));
+        row[1] = std::make_shared<Cell<long>>(row[1]->getLongVal() + rule.getCounter("instructions"));
+        row[3] = std::make_shared<Cell<long>>(row[3]->getLongVal() + rule.getCounter("llc-misses"));
+        row[4] = std::make_shared<Cell<long>>(row[4]->getLongVal() + rule.getCounter("branch-misses"));
+    };
+    for (auto& rel : programRun->getRelationMap()) {
+        for (auto& current : rel.second->getRuleMap()) {
+            addRule(*rel.second, *current.second);
+        }
+        for (auto& iter : rel.second->getIterations()) {
+            for (auto& current : iter->getRules()) {
+                addRule(*rel.second, *current.second);
+            }
+        }
+    }
+
+    std::vector<std::shared_ptr<Row>> rows;
+    for (auto& current : ruleMap) {
+        Row& row = *current.second;
+        long cycles = row[0]->getLongVal();
+        row[2] = std::make_shared<Cell<double>>(cycles == 0 ? 0.0 : row[1]->getLongVal() / double(cycles));
+        rows.push_back(current.second);
+    }
+    std::stable_sort(rows.begin(), rows.end(), [](std::shared_ptr<Row> left, std::shared_ptr<Row> right) {
+        return (*left)[0]->getLongVal() > (*right)[0]->getLongVal();
+    });
+
+    Table table;
+    for (auto& row : rows) {
+        table.addRow(row);
+    }
+    return table;
+}
+
+/*
+ * memory table :
+ * ROW[0] = BYTES
+ * ROW[1] = SHARE
+ * ROW[2] = INDEX
+ * ROW[3] = REL NAME
+ * ROW[4] = ID
+ * ROW[5] = SRC
+ *
+ * Each row is an index of a relation with the number of bytes it used after the
+ * evaluation of the relation, and its percentage of the sum of all indexes. Rows are
+ * ordered by decreasing number of bytes.
+ */
+Table inline OutputProcessor::getMemoryTable() const {
+    std::vector<std::shared_ptr<Row>> rows;
+    std::size_t total = 0;
+    for (auto& rel : programRun->getRelationMap()) {
+        const Relation& r = *rel.second;
+        for (const auto& index : r.getMemory()) {
+            Row row(6);
+            row[0] = std::make_shared<Cell<long>>(index.second);
+            row[2] = std::make_shared<Cell<std::string>>(index.first);
+            row[3] = std::make_shared<Cell<std::string>>(r.getName());
+            row[4] = std::make_shared<Cell<std::string>>(r.getId());
+            row[5] = std::make_shared<Cell<std::string>>(r.getLocator());
+            rows.push_back(std::make_shared<Row>(row));
+            total += index.second;
+        }
+    }
+    for (auto& row : rows) {
+        long bytes = (*row)[0]->getLongVal();
+        (*row)[1] = std::make_shared<Cell<double>>(total == 0 ? 0.0 : bytes * 100.0 / total);
+    }
+    std::stable_sort(rows.begin(), rows.end(), [](std::shared_ptr<Row> left, std::shared_ptr<Row> right) {
+        return (*left)[0]->getLongVal() > (*right)[0]->getLongVal();
+    });
+
+    Table table;
+    for (auto& row : rows) {
+        table.addRow(row);
+    }
+    return table;
+}
+
 /*
  * atom table :
  * ROW[0] = clause
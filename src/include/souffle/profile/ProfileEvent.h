@@ -16,9 +16,11 @@
 
 #pragma once
 
+#include "souffle/profile/EventBuffer.h"
 #include "souffle/profile/EventProcessor.h"
 #include "souffle/profile/ProfileDatabase.h"
 #include "souffle/utility/MiscUtil.h"
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -29,6 +31,7 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 #ifdef WIN32
 #include <Psapi.h>
 #else
@@ -40,17 +43,26 @@ namespace souffle {
 
 /**
  * Profile Event Singleton
+ *
+ * Events are recorded as binary records into the event buffer of the
+ * calling thread, and only converted into the profile database when the
+ * database is accessed or dumped.
  */
 class ProfileEventSingleton {
     /** profile database */
     profile::ProfileDatabase database;
     std::string filename{""};
 
+    /** events which have not been converted into the database yet */
+    profile::EventBuffer buffer;
+    std::mutex databaseMutex;
+
     ProfileEventSingleton() = default;
 
 public:
     ~ProfileEventSingleton() {
         stopTimer();
+        buffer.stop();
         ProfileEventSingleton::instance().dump();
     }
 
@@ -62,33 +74,44 @@ public:
 
     /** create config record */
     void makeConfigRecord(const std::string& key, const std::string& value) {
-        profile::EventProcessorSingleton::instance().process(database, "@config", key.c_str(), value.c_str());
+        buffer.record(profile::EventKind::Config, key, {buffer.intern(value)});
     }
 
     /** create time event */
     void makeTimeEvent(const std::string& txt) {
-        profile::EventProcessorSingleton::instance().process(
-                database, txt.c_str(), std::chrono::duration_cast<microseconds>(now().time_since_epoch()));
+        buffer.record(profile::EventKind::Time, txt, {toValue(now())});
     }
 
     /** create an event for recording start and end times */
     void makeTimingEvent(const std::string& txt, time_point start, time_point end, std::size_t startMaxRSS,
             std::size_t endMaxRSS, std::size_t size, std::size_t iteration) {
-        microseconds start_ms = std::chrono::duration_cast<microseconds>(start.time_since_epoch());
-        microseconds end_ms = std::chrono::duration_cast<microseconds>(end.time_since_epoch());
-        profile::EventProcessorSingleton::instance().process(
-                database, txt.c_str(), start_ms, end_ms, startMaxRSS, endMaxRSS, size, iteration);
+        buffer.record(profile::EventKind::Timing, txt,
+                {toValue(start), toValue(end), startMaxRSS, endMaxRSS, size, iteration});
+    }
+
+    /** create an event for recording the hardware counters of a rule */
+    void makeCounterEvent(const std::string& txt, std::size_t cycles, std::size_t instructions,
+            std::size_t llcMisses, std::size_t branchMisses, std::size_t iteration) {
+        buffer.record(profile::EventKind::Counter, txt,
+                {cycles, instructions, llcMisses, branchMisses, iteration});
+    }
+
+    /** create an event for recording the work of a thread in a rule */
+    void makeThreadEvent(const std::string& txt, std::size_t thread, time_point start, time_point end,
+            microseconds busy, std::size_t iteration) {
+        buffer.record(profile::EventKind::Thread, txt,
+                {thread, toValue(start), toValue(end), static_cast<uint64_t>(busy.count()), iteration});
     }
 
     /** create quantity event */
     void makeQuantityEvent(const std::string& txt, std::size_t number, int iteration) {
-        profile::EventProcessorSingleton::instance().process(database, txt.c_str(), number, iteration);
+        buffer.record(profile::EventKind::Quantity, txt, {number, static_cast<uint64_t>(iteration)});
     }
 
     /** create utilisation event */
     void makeUtilisationEvent(const std::string& txt) {
         /* current time */
-        microseconds time = std::chrono::duration_cast<microseconds>(now().time_since_epoch());
+        uint64_t time = toValue(now());
 
 #ifdef WIN32
         HANDLE hProcess = GetCurrentProcess();
@@ -121,8 +144,7 @@ public:
         std::size_t maxRSS = ru.ru_maxrss;
 #endif  // WIN32
 
-        profile::EventProcessorSingleton::instance().process(
-                database, txt.c_str(), time, systemTime, userTime, maxRSS);
+        buffer.record(profile::EventKind::Utilisation, txt, {time, systemTime, userTime, maxRSS});
     }
 
     void setOutputFile(std::string outputFilename) {
@@ -130,6 +152,7 @@ public:
     }
     /** Dump all events */
     void dump() {
+        convertEvents();
         if (!filename.empty()) {
             std::ofstream os(filename);
             if (!os.is_open()) {
@@ -153,15 +176,55 @@ public:
     void resetTimerInterval(uint32_t interval = 1) {
         timer.resetTimerInterval(interval);
     }
-    const profile::ProfileDatabase& getDB() const {
+    const profile::ProfileDatabase& getDB() {
+        convertEvents();
         return database;
     }
 
     void setDBFromFile(const std::string& databaseFilename) {
+        convertEvents();
         database = profile::ProfileDatabase(databaseFilename);
     }
 
 private:
+    static uint64_t toValue(time_point time) {
+        return std::chrono::duration_cast<microseconds>(time.time_since_epoch()).count();
+    }
+
+    /** Convert the recorded events into the profile database */
+    void convertEvents() {
+        std::lock_guard<std::mutex> guard(databaseMutex);
+        auto& processor = profile::EventProcessorSingleton::instance();
+        for (const profile::EventRecord& event : buffer.take()) {
+            const char* txt = buffer.getText(event.text).c_str();
+            const auto& v = event.values;
+            switch (event.kind) {
+                case profile::EventKind::Config:
+                    processor.process(database, "@config", txt, buffer.getText(v[0]).c_str());
+                    break;
+                case profile::EventKind::Time: processor.process(database, txt, microseconds(v[0])); break;
+                case profile::EventKind::Timing:
+                    processor.process(database, txt, microseconds(v[0]), microseconds(v[1]),
+                            std::size_t(v[2]), std::size_t(v[3]), std::size_t(v[4]), std::size_t(v[5]));
+                    break;
+                case profile::EventKind::Counter:
+                    processor.process(database, txt, std::size_t(v[0]), std::size_t(v[1]), std::size_t(v[2]),
+                            std::size_t(v[3]), std::size_t(v[4]));
+                    break;
+                case profile::EventKind::Thread:
+                    processor.process(database, txt, std::size_t(v[0]), microseconds(v[1]),
+                            microseconds(v[2]), std::size_t(v[3]), std::size_t(v[4]));
+                    break;
+                case profile::EventKind::Quantity:
+                    processor.process(database, txt, std::size_t(v[0]), static_cast<int>(v[1]));
+                    break;
+                case profile::EventKind::Utilisation:
+                    processor.process(database, txt, microseconds(v[0]), v[1], v[2], std::size_t(v[3]));
+                    break;
+            }
+        }
+    }
+
     /**  Profile Timer */
     class ProfileTimer {
     private:
@@ -0,0 +1,416 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ProfileSampler.h
+ *
+ * Declares a sampling profiler recording the rules executed by each thread
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/profile/ProfileEvent.h"
+#include "souffle/utility/MiscUtil.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+#ifdef WIN32
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#endif  // WIN32
+
+namespace souffle {
+
+/**
+ * Sampling profiler
+ *
+ * Instead of timing every evaluation of a rule, each thread announces the
+ * rules it is executing in a per-thread slot. A background thread reads the
+ * slots of all threads periodically, and the number of samples in which a
+ * rule was executed estimates its runtime. Announcing a rule costs a few
+ * relaxed stores, so that profiling has little impact on the program.
+ *
+ * The number of tuples added by an execution of a rule is kept in the slot
+ * of the thread as well: executions which have been sampled are recorded
+ * individually, while all other executions of a rule are folded into a
+ * single record. Hence, the memory of a slot is bounded by the number of
+ * samples and rules, and recording an execution takes no global lock.
+ *
+ * When sampling stops, the estimated runtimes are recorded as timing events
+ * in the profile database, where they take the place of the events of the
+ * Logger. The folded executions of a rule are recorded as a single event
+ * with a runtime of zero, or added to the samples of their latest iteration.
+ */
+class ProfileSampler {
+    struct Slot;
+
+public:
+    /** get instance */
+    static ProfileSampler& instance() {
+        static ProfileSampler singleton;
+        return singleton;
+    }
+
+    /** The sampling thread is stopped, but no events are recorded during static destruction */
+    ~ProfileSampler() {
+        halt();
+    }
+
+    /**
+     * Rule executed by the current thread during the lifetime of the scope
+     *
+     * The label must remain valid until sampling stops. The number of tuples
+     * added during the scope is obtained from the given size function.
+     */
+    template <typename Size>
+    class Scope {
+    public:
+        Scope(const char* label, std::size_t iteration, Size size)
+                : slot(localSlot()), label(label), iteration(iteration), size(std::move(size)),
+                  preSize(this->size()) {
+            std::size_t depth = slot.depth.load(std::memory_order_relaxed);
+            if (depth < MAX_DEPTH) {
+                slot.labels[depth].store(label, std::memory_order_relaxed);
+                slot.iterations[depth].store(iteration, std::memory_order_relaxed);
+                slot.sampled[depth].store(false, std::memory_order_relaxed);
+            }
+            slot.depth.store(depth + 1, std::memory_order_release);
+        }
+
+        Scope(const std::string& label, std::size_t iteration, Size size)
+                : Scope(label.c_str(), iteration, std::move(size)) {}
+
+        ~Scope() {
+            const std::size_t depth = slot.depth.load(std::memory_order_relaxed) - 1;
+            const bool sampled = depth < MAX_DEPTH && slot.sampled[depth].load(std::memory_order_relaxed);
+            slot.depth.store(depth, std::memory_order_release);
+            slot.record(label, iteration, size() - preSize, sampled);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Slot& slot;
+        const char* label;
+        std::size_t iteration;
+        Size size;
+        std::size_t preSize;
+    };
+
+    /** Start sampling every interval microseconds */
+    void start(std::size_t interval) {
+        if (running) {
+            return;
+        }
+        samplingInterval = std::chrono::microseconds(std::max<std::size_t>(interval, 1));
+        lastSample = now();
+        running = true;
+        th = std::thread([this]() {
+            std::unique_lock<std::mutex> lock(timerMutex);
+            while (running) {
+                conditionVariable.wait_for(lock, samplingInterval, [this]() { return !running; });
+                sample();
+            }
+        });
+    }
+
+    /** Take a sample immediately, in addition to the periodic samples */
+    void sampleNow() {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        if (running) {
+            sample();
+        }
+    }
+
+    /** Stop sampling and record the estimated runtimes in the profile database */
+    void stop() {
+        if (!halt()) {
+            return;
+        }
+
+        // collect the executions recorded by all threads
+        std::vector<SizeRecord> executions;
+        std::map<const char*, SizeRecord> folded;
+        {
+            std::lock_guard<std::mutex> lock(slotMutex);
+            for (Slot* slot : slots) {
+                retire(*slot);
+            }
+            executions.swap(retiredExecutions);
+            folded.swap(retiredFolded);
+        }
+
+        // sampled executions whose samples have been missed are folded as well
+        for (const auto& cur : executions) {
+            auto estimate = samples.find({cur.label, cur.iteration});
+            if (estimate != samples.end()) {
+                estimate->second.size += cur.size;
+            } else {
+                fold(folded, cur);
+            }
+        }
+
+        // only the first event of an iteration is kept by the database, hence folded executions whose
+        // latest iteration has been sampled are added to the samples
+        for (auto cur = folded.begin(); cur != folded.end();) {
+            auto estimate = samples.find({cur->second.label, cur->second.iteration});
+            if (estimate != samples.end()) {
+                estimate->second.size += cur->second.size;
+                cur = folded.erase(cur);
+            } else {
+                ++cur;
+            }
+        }
+        auto& events = ProfileEventSingleton::instance();
+        for (const auto& cur : samples) {
+            const Estimate& estimate = cur.second;
+            events.makeTimingEvent(cur.first.first, estimate.start, estimate.start + estimate.duration,
+                    estimate.startMaxRSS, estimate.endMaxRSS, estimate.size, cur.first.second);
+        }
+        for (const auto& cur : folded) {
+            const SizeRecord& record = cur.second;
+            events.makeTimingEvent(
+                    record.label, record.time, record.time, 0, 0, record.size, record.iteration);
+        }
+        samples.clear();
+
+        // quantities take precedence over the sizes of the timing events
+        std::lock_guard<std::mutex> lock(quantityMutex);
+        for (const auto& cur : quantities) {
+            events.makeQuantityEvent(std::get<0>(cur), std::get<1>(cur), std::get<2>(cur));
+        }
+        quantities.clear();
+    }
+
+    /** Check whether sampling is running */
+    bool isRunning() const {
+        return running;
+    }
+
+    /** Create a quantity event, recorded after the sampled timing events */
+    void makeQuantityEvent(const std::string& txt, std::size_t number, int iteration) {
+        if (!running) {
+            ProfileEventSingleton::instance().makeQuantityEvent(txt, number, iteration);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(quantityMutex);
+        quantities.emplace_back(txt, number, iteration);
+    }
+
+private:
+    /** Maximal nesting depth of the rules recorded per thread */
+    static constexpr std::size_t MAX_DEPTH = 8;
+
+    /** Tuples added by an execution of a rule, or by the folded executions of a rule */
+    struct SizeRecord {
+        const char* label;
+        std::size_t iteration;
+        std::size_t size;
+        time_point time;
+    };
+
+    /** Rules executed by a thread, written by the thread and read by the sampler */
+    struct Slot {
+        Slot() {
+            ProfileSampler::instance().attach(this);
+        }
+
+        ~Slot() {
+            ProfileSampler::instance().detach(this);
+        }
+
+        /** Record the tuples added by an execution; the lock is only contended when sampling stops */
+        void record(const char* label, std::size_t iteration, std::size_t size, bool sampled) {
+            const SizeRecord record{label, iteration, size, now()};
+            std::lock_guard<std::mutex> lock(mutex);
+            if (sampled) {
+                executions.push_back(record);
+            } else {
+                fold(folded, record);
+            }
+        }
+
+        std::atomic<std::size_t> depth{0};
+        std::array<std::atomic<const char*>, MAX_DEPTH> labels{};
+        std::array<std::atomic<std::size_t>, MAX_DEPTH> iterations{};
+        /** set by the sampler if the rule at a depth has been sampled */
+        std::array<std::atomic<bool>, MAX_DEPTH> sampled{};
+
+        /** executions which have been sampled */
+        std::vector<SizeRecord> executions;
+        /** executions which have not been sampled, folded per rule */
+        std::map<const char*, SizeRecord> folded;
+        std::mutex mutex;
+    };
+
+    /** Samples of a rule */
+    struct Estimate {
+        time_point start;
+        microseconds duration{0};
+        std::size_t startMaxRSS = 0;
+        std::size_t endMaxRSS = 0;
+        std::size_t size = 0;
+    };
+
+    ProfileSampler() = default;
+
+    static Slot& localSlot() {
+        thread_local Slot slot;
+        return slot;
+    }
+
+    /** Fold an execution into the record of its rule, keeping the latest iteration */
+    static void fold(std::map<const char*, SizeRecord>& folded, const SizeRecord& record) {
+        auto inserted = folded.emplace(record.label, record);
+        if (!inserted.second) {
+            SizeRecord& cur = inserted.first->second;
+            cur.size += record.size;
+            if (cur.time <= record.time) {
+                cur.iteration = record.iteration;
+                cur.time = record.time;
+            }
+        }
+    }
+
+    void attach(Slot* slot) {
+        std::lock_guard<std::mutex> lock(slotMutex);
+        slots.insert(slot);
+    }
+
+    void detach(Slot* slot) {
+        std::lock_guard<std::mutex> lock(slotMutex);
+        retire(*slot);
+        slots.erase(slot);
+    }
+
+    /** Move the records of a slot to the retired records; the slots must be locked */
+    void retire(Slot& slot) {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        retiredExecutions.insert(retiredExecutions.end(), slot.executions.begin(), slot.executions.end());
+        slot.executions.clear();
+        for (const auto& cur : slot.folded) {
+            fold(retiredFolded, cur.second);
+        }
+        slot.folded.clear();
+    }
+
+    /** Stop the sampling thread; returns whether it has been running */
+    bool halt() {
+        {
+            std::lock_guard<std::mutex> lock(timerMutex);
+            if (!running) {
+                return false;
+            }
+            running = false;
+        }
+        conditionVariable.notify_all();
+        if (th.joinable()) {
+            th.join();
+        }
+        return true;
+    }
+
+    static std::size_t getMaxRSS() {
+#ifdef WIN32
+        PROCESS_MEMORY_COUNTERS processMemoryCounters;
+        GetProcessMemoryInfo(GetCurrentProcess(), &processMemoryCounters, sizeof(processMemoryCounters));
+        return processMemoryCounters.PeakWorkingSetSize / 1000;
+#else
+        struct rusage ru {};
+        getrusage(RUSAGE_SELF, &ru);
+        return ru.ru_maxrss;
+#endif  // WIN32
+    }
+
+    /**
+     * Record the rules executed by all threads
+     *
+     * Each rule is attributed the time since the previous sample; a rule
+     * executed by several threads is counted once.
+     */
+    void sample() {
+        const time_point time = now();
+        const auto elapsed = std::chrono::duration_cast<microseconds>(time - lastSample);
+        lastSample = time;
+        active.clear();
+        {
+            std::lock_guard<std::mutex> lock(slotMutex);
+            for (Slot* slot : slots) {
+                std::size_t depth = std::min(slot->depth.load(std::memory_order_acquire), MAX_DEPTH);
+                for (std::size_t i = 0; i < depth; i++) {
+                    const char* label = slot->labels[i].load(std::memory_order_relaxed);
+                    std::size_t iteration = slot->iterations[i].load(std::memory_order_relaxed);
+                    if (label != nullptr) {
+                        active.emplace_back(label, iteration);
+                        slot->sampled[i].store(true, std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+        if (active.empty()) {
+            return;
+        }
+        std::sort(active.begin(), active.end());
+        active.erase(std::unique(active.begin(), active.end()), active.end());
+
+        const std::size_t maxRSS = getMaxRSS();
+        for (const auto& cur : active) {
+            auto inserted = samples.emplace(cur, Estimate());
+            Estimate& estimate = inserted.first->second;
+            if (inserted.second) {
+                estimate.start = time - elapsed;
+                estimate.startMaxRSS = maxRSS;
+            }
+            estimate.duration += elapsed;
+            estimate.endMaxRSS = maxRSS;
+        }
+    }
+
+    /** sampling thread */
+    std::thread th;
+    std::atomic<bool> running{false};
+    std::chrono::microseconds samplingInterval{1000};
+    time_point lastSample;
+    std::condition_variable conditionVariable;
+    std::mutex timerMutex;
+
+    /** slots of all threads which executed a rule */
+    std::set<Slot*> slots;
+    std::mutex slotMutex;
+
+    /** records of the slots of terminated threads, or collected when sampling stops */
+    std::vector<SizeRecord> retiredExecutions;
+    std::map<const char*, SizeRecord> retiredFolded;
+
+    /** rules executed in the current sample */
+    std::vector<std::pair<const char*, std::size_t>> active;
+
+    /** samples per rule and iteration */
+    std::map<std::pair<const char*, std::size_t>, Estimate> samples;
+
+    /** quantity events recorded while sampling */
+    std::vector<std::tuple<std::string, std::size_t, int>> quantities;
+    std::mutex quantityMutex;
+};
+
+}  // namespace souffle
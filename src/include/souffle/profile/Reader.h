@@ -84,6 +84,59 @@ private:
     Rule& rule;
 };
 
+/**
+ * Visit ProfileDB hardware counters.
+ * counters : {counter: num}
+ */
+class CountersVisitor : public Visitor {
+public:
+    CountersVisitor(Rule& rule) : rule(rule) {}
+    void visit(SizeEntry& size) override {
+        rule.setCounter(size.getKey(), size.getSize());
+    }
+
+private:
+    Rule& rule;
+};
+
+/**
+ * Visit ProfileDB work of a thread.
+ * thread : {runtime: duration, busy: num}
+ */
+class ThreadVisitor : public Visitor {
+public:
+    ThreadVisitor(ThreadWork& work) : work(work) {}
+    void visit(DurationEntry& duration) override {
+        if (duration.getKey() == "runtime") {
+            work.start = duration.getStart();
+            work.end = duration.getEnd();
+        }
+    }
+    void visit(SizeEntry& size) override {
+        if (size.getKey() == "busy") {
+            work.busy = std::chrono::microseconds(size.getSize());
+        }
+    }
+
+private:
+    ThreadWork& work;
+};
+
+/**
+ * Visit ProfileDB memory of indexes of a relation.
+ * memory : {index: num}
+ */
+class MemoryVisitor : public Visitor {
+public:
+    MemoryVisitor(Relation& relation) : relation(relation) {}
+    void visit(SizeEntry& size) override {
+        relation.addMemory(size.getKey(), size.getSize());
+    }
+
+private:
+    Relation& relation;
+};
+
 /**
  * Visit ProfileDB recursive rule.
  * ruleversion: {DSN}
@@ -97,6 +150,18 @@ public:
             for (auto& key : directory.getKeys()) {
                 directory.readDirectoryEntry(key)->accept(atomFrequenciesVisitor);
             }
+        } else if (directory.getKey() == "counters") {
+            CountersVisitor countersVisitor(base);
+            for (auto& key : directory.getKeys()) {
+                directory.readEntry(key)->accept(countersVisitor);
+            }
+        } else if (directory.getKey() == "thread") {
+            for (auto& key : directory.getKeys()) {
+                ThreadVisitor threadVisitor(base.getThreadWork(std::stoul(key)));
+                for (auto& threadKey : directory.readDirectoryEntry(key)->getKeys()) {
+                    directory.readDirectoryEntry(key)->readEntry(threadKey)->accept(threadVisitor);
+                }
+            }
         }
     }
 };
@@ -142,6 +207,18 @@ public:
             for (auto& key : directory.getKeys()) {
                 directory.readDirectoryEntry(key)->accept(atomFrequenciesVisitor);
             }
+        } else if (directory.getKey() == "counters") {
+            CountersVisitor countersVisitor(base);
+            for (auto& key : directory.getKeys()) {
+                directory.readEntry(key)->accept(countersVisitor);
+            }
+        } else if (directory.getKey() == "thread") {
+            for (auto& key : directory.getKeys()) {
+                ThreadVisitor threadVisitor(base.getThreadWork(std::stoul(key)));
+                for (auto& threadKey : directory.readDirectoryEntry(key)->getKeys()) {
+                    directory.readDirectoryEntry(key)->readEntry(threadKey)->accept(threadVisitor);
+                }
+            }
         }
     }
 };
@@ -252,6 +329,11 @@ public:
             auto* postMaxRSS = as<SizeEntry>(directory.readEntry("post"));
             base.setPreMaxRSS(preMaxRSS->getSize());
             base.setPostMaxRSS(postMaxRSS->getSize());
+        } else if (directory.getKey() == "memory") {
+            MemoryVisitor memoryVisitor(base);
+            for (const auto& key : directory.getKeys()) {
+                directory.readEntry(key)->accept(memoryVisitor);
+            }
         }
     }
     void visit(SizeEntry& size) override {
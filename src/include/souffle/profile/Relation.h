@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <chrono>
 #include <cstddef>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -42,6 +43,9 @@ private:
     int recursiveId = 0;
     std::size_t tuplesRead = 0;
 
+    /** memory used by each index after the evaluation of the relation */
+    std::map<std::string, std::size_t> memory;
+
     std::vector<std::shared_ptr<Iteration>> iterations;
 
     std::unordered_map<std::string, std::shared_ptr<Rule>> ruleMap;
@@ -248,6 +252,14 @@ public:
     void addReads(std::size_t tuplesRead) {
         this->tuplesRead += tuplesRead;
     }
+
+    void addMemory(const std::string& index, std::size_t bytes) {
+        memory[index] = bytes;
+    }
+
+    const std::map<std::string, std::size_t>& getMemory() const {
+        return memory;
+    }
 };
 
 }  // namespace profile
@@ -9,6 +9,8 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
+#include <map>
 #include <set>
 #include <sstream>
 #include <string>
@@ -41,6 +43,15 @@ public:
     }
 };
 
+/*
+ * Work of a thread in the parallel operations of a rule
+ */
+struct ThreadWork {
+    std::chrono::microseconds start{};
+    std::chrono::microseconds end{};
+    std::chrono::microseconds busy{};
+};
+
 /*
  * Class to hold information about souffle Rule profile information
  */
@@ -53,6 +64,8 @@ protected:
     std::string identifier;
     std::string locator{};
     std::set<Atom> atoms;
+    std::map<std::string, std::size_t> counters;
+    std::map<std::size_t, ThreadWork> threads;
 
 private:
     bool recursive = false;
@@ -104,6 +117,29 @@ public:
     const std::set<Atom>& getAtoms() const {
         return atoms;
     }
+
+    void setCounter(const std::string& counter, std::size_t value) {
+        counters[counter] = value;
+    }
+
+    /** Value of a hardware counter, or zero if the counter has not been recorded */
+    std::size_t getCounter(const std::string& counter) const {
+        auto it = counters.find(counter);
+        return it == counters.end() ? 0 : it->second;
+    }
+
+    bool hasCounters() const {
+        return !counters.empty();
+    }
+
+    ThreadWork& getThreadWork(std::size_t thread) {
+        return threads[thread];
+    }
+
+    /** Work per thread, empty if the rule has not been evaluated in parallel */
+    const std::map<std::size_t, ThreadWork>& getThreads() const {
+        return threads;
+    }
     std::string getName() const {
         return name;
     }
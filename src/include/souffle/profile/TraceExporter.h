@@ -0,0 +1,511 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file TraceExporter.h
+ *
+ * Exports a profile as a trace in the Chrome Trace Event format
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/profile/ProfileDatabase.h"
+#include "souffle/utility/MiscUtil.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+namespace profile {
+
+/**
+ * Exporter of a profile to the Chrome Trace Event format
+ *
+ * The trace can be inspected in standard viewers such as Perfetto or
+ * chrome://tracing. The program, relations, iterations, rules and IO
+ * operations are written as complete events on separate tracks, the work
+ * of the threads of parallel rules on a track per thread, and the resource
+ * utilisation as counter events.
+ *
+ * Events are written as the entries of the profile are visited. A profile
+ * log is read as a stream, holding only the entries of the directories on
+ * the current path, so that large profiles need not be loaded into a
+ * profile database first.
+ */
+class TraceExporter {
+public:
+    TraceExporter(std::ostream& out) : out(out) {}
+
+    /** Export a profile database */
+    void exportDatabase(const ProfileDatabase& db) {
+        begin();
+        if (auto* program = as<DirectoryEntry>(db.lookupEntry({"program"}))) {
+            visitDirectory(*program);
+        }
+        end();
+    }
+
+    /** Export a profile log, reading it as a stream */
+    void exportLog(std::istream& in) {
+        begin();
+        LogReader(in, *this).read();
+        end();
+    }
+
+private:
+    /** Tracks of the trace */
+    enum Track : std::size_t { PROGRAM = 0, RELATIONS, ITERATIONS, RULES, IO, THREADS };
+
+    /** Leaf entries of a directory on the current path */
+    struct Frame {
+        std::string key;
+        std::map<std::string, std::size_t> sizes;
+        std::map<std::string, std::string> texts;
+        std::vector<std::tuple<std::string, microseconds, microseconds>> durations;
+        std::vector<std::pair<std::string, microseconds>> times;
+        bool hasDirectories = false;
+    };
+
+    /**
+     * Streaming reader of a profile log
+     *
+     * Duration and time entries are objects in the log; as in the profile
+     * database, an object is read as such an entry if it only consists of
+     * the start and end or of the time.
+     */
+    class LogReader {
+    public:
+        LogReader(std::istream& in, TraceExporter& exporter) : in(in), exporter(exporter) {}
+
+        void read() {
+            expect('{');
+            if (peek() == '}') {
+                return;
+            }
+            do {
+                std::string key = readString();
+                expect(':');
+                if (key == "root" && peek() == '{') {
+                    readRoot();
+                } else {
+                    skipValue();
+                }
+            } while (accept(','));
+            expect('}');
+        }
+
+    private:
+        void readRoot() {
+            expect('{');
+            if (accept('}')) {
+                return;
+            }
+            do {
+                std::string key = readString();
+                expect(':');
+                if (key == "program" && peek() == '{') {
+                    exporter.enter(key);
+                    readMembers();
+                    exporter.leave();
+                } else {
+                    skipValue();
+                }
+            } while (accept(','));
+            expect('}');
+        }
+
+        /** Read the members of the directory on top of the path, up to the closing brace */
+        void readMembers() {
+            expect('{');
+            if (accept('}')) {
+                return;
+            }
+            do {
+                std::string key = readString();
+                expect(':');
+                readValue(key);
+            } while (accept(','));
+            expect('}');
+        }
+
+        void readValue(const std::string& key) {
+            Frame& parent = exporter.path.back();
+            char c = peek();
+            if (c == '"') {
+                parent.texts[key] = readString();
+            } else if (c == '{') {
+                exporter.enter(key);
+                readMembers();
+                Frame& frame = exporter.path.back();
+                if (!frame.hasDirectories && frame.texts.empty() && frame.durations.empty() &&
+                        frame.times.empty()) {
+                    const auto& sizes = frame.sizes;
+                    if (sizes.size() == 2 && sizes.count("start") != 0 && sizes.count("end") != 0) {
+                        auto start = microseconds(sizes.at("start"));
+                        auto end = microseconds(sizes.at("end"));
+                        exporter.path.pop_back();
+                        exporter.path.back().durations.emplace_back(key, start, end);
+                        return;
+                    }
+                    if (sizes.size() == 1 && sizes.count("time") != 0) {
+                        auto time = microseconds(sizes.at("time"));
+                        exporter.path.pop_back();
+                        exporter.path.back().times.emplace_back(key, time);
+                        return;
+                    }
+                }
+                exporter.leave();
+            } else {
+                parent.sizes[key] = readNumber();
+            }
+        }
+
+        void skipValue() {
+            char c = peek();
+            if (c == '"') {
+                readString();
+            } else if (c == '{' || c == '[') {
+                char close = c == '{' ? '}' : ']';
+                next();
+                if (accept(close)) {
+                    return;
+                }
+                do {
+                    if (c == '{') {
+                        readString();
+                        expect(':');
+                    }
+                    skipValue();
+                } while (accept(','));
+                expect(close);
+            } else {
+                while (in && !std::isspace(in.peek()) && in.peek() != ',' && in.peek() != '}' &&
+                        in.peek() != ']' && in.peek() != EOF) {
+                    in.get();
+                }
+            }
+        }
+
+        std::string readString() {
+            expect('"');
+            std::string result;
+            for (int c = in.get(); c != '"'; c = in.get()) {
+                if (c == EOF) {
+                    throw std::runtime_error("Unexpected end of profile log.");
+                }
+                if (c == '\\') {
+                    c = in.get();
+                    switch (c) {
+                        case 'n': c = '\n'; break;
+                        case 't': c = '\t'; break;
+                        case 'r': c = '\r'; break;
+                        case 'b': c = '\b'; break;
+                        case 'f': c = '\f'; break;
+                        case 'u':
+                            // code points are not needed for the names of the trace
+                            for (int i = 0; i < 4; i++) {
+                                in.get();
+                            }
+                            c = '?';
+                            break;
+                        case EOF: throw std::runtime_error("Unexpected end of profile log.");
+                        default: break;
+                    }
+                }
+                result.push_back(static_cast<char>(c));
+            }
+            return result;
+        }
+
+        std::size_t readNumber() {
+            skipWhitespace();
+            long long value = 0;
+            if (!(in >> value)) {
+                throw std::runtime_error("Parse error: expected a number in profile log.");
+            }
+            // fractions and exponents are not written by the profile database
+            return value < 0 ? 0 : static_cast<std::size_t>(value);
+        }
+
+        void skipWhitespace() {
+            while (std::isspace(in.peek())) {
+                in.get();
+            }
+        }
+
+        char peek() {
+            skipWhitespace();
+            return static_cast<char>(in.peek());
+        }
+
+        void next() {
+            in.get();
+        }
+
+        bool accept(char c) {
+            if (peek() == c) {
+                next();
+                return true;
+            }
+            return false;
+        }
+
+        void expect(char c) {
+            if (!accept(c)) {
+                throw std::runtime_error(std::string("Parse error: expected '") + c + "' in profile log.");
+            }
+        }
+
+        std::istream& in;
+        TraceExporter& exporter;
+    };
+
+    void begin() {
+        out << R"_({"displayTimeUnit": "ms", "traceEvents": [)_";
+        first = true;
+        nameTrack(PROGRAM, "program");
+        nameTrack(RELATIONS, "relations");
+        nameTrack(ITERATIONS, "iterations");
+        nameTrack(RULES, "rules");
+        nameTrack(IO, "io");
+        path.clear();
+        path.emplace_back();
+    }
+
+    void end() {
+        out << "\n]}\n";
+    }
+
+    void visitDirectory(DirectoryEntry& dir) {
+        enter(dir.getKey());
+        for (const auto& key : dir.getKeys()) {
+            Entry* entry = dir.readEntry(key);
+            Frame& frame = path.back();
+            if (auto* sub = as<DirectoryEntry>(entry)) {
+                visitDirectory(*sub);
+            } else if (auto* size = as<SizeEntry>(entry)) {
+                frame.sizes[key] = size->getSize();
+            } else if (auto* text = as<TextEntry>(entry)) {
+                frame.texts[key] = text->getText();
+            } else if (auto* duration = as<DurationEntry>(entry)) {
+                frame.durations.emplace_back(key, duration->getStart(), duration->getEnd());
+            } else if (auto* time = as<TimeEntry>(entry)) {
+                frame.times.emplace_back(key, time->getTime());
+            }
+        }
+        leave();
+    }
+
+    void enter(const std::string& key) {
+        path.back().hasDirectories = true;
+        path.emplace_back();
+        path.back().key = key;
+    }
+
+    /** Write the events of the directory on top of the path and remove it from the path */
+    void leave() {
+        const Frame& frame = path.back();
+        // path of the directory without the leading program directory
+        std::vector<std::string> keys;
+        for (std::size_t i = 2; i < path.size(); i++) {
+            keys.push_back(path[i].key);
+        }
+        std::size_t depth = keys.size();
+
+        for (const auto& cur : frame.durations) {
+            const std::string& name = std::get<0>(cur);
+            microseconds start = std::get<1>(cur);
+            microseconds end = std::get<2>(cur);
+            if (depth == 0 && name == "runtime") {
+                writeSpan("program", "program", PROGRAM, start, end, {});
+            } else if (depth == 2 && keys[0] == "relation") {
+                const std::string& relation = keys[1];
+                if (name == "runtime") {
+                    writeSpan(relation, "relation", RELATIONS, start, end, relationArgs(frame));
+                } else if (name == "loadtime" || name == "savetime") {
+                    writeSpan((name == "loadtime" ? "load " : "save ") + relation, "io", IO, start, end,
+                            relationArgs(frame));
+                }
+            } else if (depth == 4 && keys[0] == "relation" && keys[2] == "iteration") {
+                const std::string& relation = keys[1];
+                if (name == "runtime") {
+                    auto args = iterationArgs(frame, keys[3]);
+                    writeSpan(relation + " iteration " + keys[3], "iteration", ITERATIONS, start, end, args);
+                } else if (name == "copytime") {
+                    writeSpan("copy " + relation, "iteration", ITERATIONS, start, end,
+                            {{"iteration", keys[3]}});
+                }
+            } else if (name == "runtime" && isRule(keys, depth)) {
+                writeSpan(keys[depth - 1 - (keys[2] == "iteration" ? 1 : 0)], "rule", RULES, start, end,
+                        ruleArgs(frame, keys));
+            } else if (name == "runtime" && depth >= 2 && keys[depth - 2] == "thread" &&
+                       isRule(keys, depth - 2)) {
+                std::size_t thread = std::stoul(keys[depth - 1]);
+                std::vector<std::pair<std::string, std::string>> args{{"relation", keys[1]}};
+                if (frame.sizes.count("busy") != 0) {
+                    args.emplace_back("busy", std::to_string(frame.sizes.at("busy")));
+                }
+                const std::string& rule = keys[depth - 3 - (keys[2] == "iteration" ? 1 : 0)];
+                writeSpan(rule, "thread", threadTrack(thread), start, end, args);
+            }
+        }
+
+        for (const auto& cur : frame.times) {
+            writeEvent(cur.first, "time", "i", PROGRAM, cur.second, R"_(, "s": "g")_");
+        }
+
+        // resource utilisation at a timepoint
+        if (depth == 3 && keys[0] == "usage" && keys[1] == "timepoint" && !frame.sizes.empty()) {
+            std::string args = R"_(, "args": {)_";
+            bool firstArg = true;
+            for (const auto& cur : frame.sizes) {
+                args += (firstArg ? "\"" : ", \"") + escape(cur.first) + "\": " + std::to_string(cur.second);
+                firstArg = false;
+            }
+            args += "}";
+            writeEvent("usage", "usage", "C", PROGRAM, microseconds(std::stoll(keys[2])), args);
+        }
+
+        path.pop_back();
+    }
+
+    /** Check whether the keys are the path of a non-recursive rule or of a version of a recursive rule */
+    static bool isRule(const std::vector<std::string>& keys, std::size_t depth) {
+        if (depth < 4 || keys[0] != "relation") {
+            return false;
+        }
+        if (depth == 4) {
+            return keys[2] == "non-recursive-rule";
+        }
+        return depth == 7 && keys[2] == "iteration" && keys[4] == "recursive-rule";
+    }
+
+    static std::vector<std::pair<std::string, std::string>> relationArgs(const Frame& frame) {
+        std::vector<std::pair<std::string, std::string>> args;
+        if (frame.sizes.count("num-tuples") != 0) {
+            args.emplace_back("tuples", std::to_string(frame.sizes.at("num-tuples")));
+        }
+        if (frame.texts.count("source-locator") != 0) {
+            args.emplace_back("source", frame.texts.at("source-locator"));
+        }
+        return args;
+    }
+
+    static std::vector<std::pair<std::string, std::string>> iterationArgs(
+            const Frame& frame, const std::string& iteration) {
+        std::vector<std::pair<std::string, std::string>> args{{"iteration", iteration}};
+        if (frame.sizes.count("num-tuples") != 0) {
+            args.emplace_back("tuples", std::to_string(frame.sizes.at("num-tuples")));
+        }
+        return args;
+    }
+
+    static std::vector<std::pair<std::string, std::string>> ruleArgs(
+            const Frame& frame, const std::vector<std::string>& keys) {
+        std::vector<std::pair<std::string, std::string>> args{{"relation", keys[1]}};
+        if (keys[2] == "iteration") {
+            args.emplace_back("iteration", keys[3]);
+            args.emplace_back("version", keys[6]);
+        }
+        auto rest = relationArgs(frame);
+        args.insert(args.end(), rest.begin(), rest.end());
+        return args;
+    }
+
+    std::size_t threadTrack(std::size_t thread) {
+        std::size_t track = THREADS + thread;
+        if (threads.insert(thread).second) {
+            nameTrack(track, "thread " + std::to_string(thread));
+        }
+        return track;
+    }
+
+    void nameTrack(std::size_t track, const std::string& name) {
+        separate();
+        out << R"_({"name": "thread_name", "ph": "M", "pid": 1, "tid": )_" << track
+            << R"_(, "args": {"name": ")_" << escape(name) << "\"}}";
+        separate();
+        out << R"_({"name": "thread_sort_index", "ph": "M", "pid": 1, "tid": )_" << track
+            << R"_(, "args": {"sort_index": )_" << track << "}}";
+    }
+
+    void writeSpan(const std::string& name, const std::string& category, std::size_t track,
+            microseconds start, microseconds end,
+            const std::vector<std::pair<std::string, std::string>>& args) {
+        std::string rest = ", \"dur\": " + std::to_string(std::max(end - start, microseconds(0)).count());
+        if (!args.empty()) {
+            rest += R"_(, "args": {)_";
+            bool firstArg = true;
+            for (const auto& cur : args) {
+                rest += (firstArg ? "\"" : ", \"") + escape(cur.first) + "\": \"" + escape(cur.second) + "\"";
+                firstArg = false;
+            }
+            rest += "}";
+        }
+        writeEvent(name, category, "X", track, start, rest);
+    }
+
+    void writeEvent(const std::string& name, const std::string& category, const char* phase,
+            std::size_t track, microseconds time, const std::string& rest) {
+        separate();
+        out << R"_({"name": ")_" << escape(name) << R"_(", "cat": ")_" << category << R"_(", "ph": ")_"
+            << phase << R"_(", "pid": 1, "tid": )_" << track << ", \"ts\": " << time.count() << rest << "}";
+    }
+
+    void separate() {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    }
+
+    static std::string escape(const std::string& text) {
+        std::string result;
+        for (char c : text) {
+            switch (c) {
+                case '"': result += "\\\""; break;
+                case '\\': result += "\\\\"; break;
+                case '\n': result += "\\n"; break;
+                case '\t': result += "\\t"; break;
+                case '\r': result += "\\r"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buffer[8];
+                        std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                        result += buffer;
+                    } else {
+                        result.push_back(c);
+                    }
+            }
+        }
+        return result;
+    }
+
+    std::ostream& out;
+    bool first = true;
+
+    /** directories on the current path, starting with the root */
+    std::vector<Frame> path;
+
+    /** threads which have been named */
+    std::set<std::size_t> threads;
+};
+
+}  // namespace profile
+}  // namespace souffle
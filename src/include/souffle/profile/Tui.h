@@ -172,6 +172,10 @@ public:
             } else {
                 rul(resultLimit);
             }
+        } else if (c[0] == "counters") {
+            counters(resultLimit);
+        } else if (c[0] == "indexes") {
+            indexes(resultLimit);
         } else if (c[0] == "graph") {
             if (c.size() == 3 && c[1].find(".") == std::string::npos) {
                 iterRel(c[1], c[2]);
@@ -413,16 +417,23 @@ public:
                 ss << R"_({"tot_t": [)_";
 
                 std::vector<uint64_t> iteration_tuples;
+                std::vector<std::map<std::size_t, long>> iteration_threads;
+                std::size_t threadCount = 0;
                 bool firstCol = true;
                 for (auto& i : run->getRelation(row[7]->toString(0))->getIterations()) {
                     bool add = false;
                     std::chrono::microseconds totalTime{};
                     uint64_t totalSize = 0L;
+                    std::map<std::size_t, long> threads;
                     for (auto& rul : i->getRules()) {
                         if (rul.second->getId() == row[6]->toString(0)) {
                             totalTime += rul.second->getRuntime();
 
                             totalSize += rul.second->size();
+                            for (auto& thread : rul.second->getThreads()) {
+                                threads[thread.first] += thread.second.busy.count();
+                                threadCount = std::max(threadCount, thread.first + 1);
+                            }
                             add = true;
                         }
                     }
@@ -430,6 +441,7 @@ public:
                         comma(firstCol);
                         ss << totalTime.count();
                         iteration_tuples.push_back(totalSize);
+                        iteration_threads.push_back(threads);
                     }
                 }
                 ss << R"_(], "tuples": [)_";
@@ -438,6 +450,20 @@ public:
                     comma(firstCol);
                     ss << i;
                 }
+                // busy time of each thread per iteration, if the rule has been evaluated in parallel
+                ss << R"_(], "threads": [)_";
+                firstCol = true;
+                for (auto& threads : iteration_threads) {
+                    if (threadCount == 0) {
+                        break;
+                    }
+                    comma(firstCol);
+                    ss << '[';
+                    for (std::size_t thread = 0; thread < threadCount; thread++) {
+                        ss << (thread == 0 ? "" : ", ") << threads[thread];
+                    }
+                    ss << ']';
+                }
 
                 ss << "]}, {";
 
@@ -465,6 +491,52 @@ public:
         return ss;
     }
 
+    std::stringstream& genJsonIndexes(std::stringstream& ss) {
+        ss << R"_("indexes":{)_";
+        bool firstRow = true;
+        for (auto& _row : out.getMemoryTable().getRows()) {
+            Row& row = *_row;
+            if (!firstRow) {
+                ss << ",";
+            }
+            firstRow = false;
+            ss << "\n ";
+            ss << '"' << row[4]->toString(0) << ":" << Tools::cleanJsonOut(row[2]->toString(0));
+            ss << R"_(": [)_";
+            ss << '"' << Tools::cleanJsonOut(row[3]->toString(0)) << R"_(", )_";
+            ss << '"' << Tools::cleanJsonOut(row[4]->toString(0)) << R"_(", )_";
+            ss << '"' << Tools::cleanJsonOut(row[2]->toString(0)) << R"_(", )_";
+            ss << row[0]->getLongVal() << ", ";
+            ss << '"' << Tools::cleanJsonOut(row[5]->toString(0)) << R"_("])_";
+        }
+        ss << "\n}";
+        return ss;
+    }
+
+    std::stringstream& genJsonCounters(std::stringstream& ss) {
+        ss << R"_("counters":{)_";
+        bool firstRow = true;
+        for (auto& _row : out.getCountersTable().getRows()) {
+            Row& row = *_row;
+            if (!firstRow) {
+                ss << ",";
+            }
+            firstRow = false;
+            ss << "\n ";
+            ss << '"' << row[6]->toString(0) << R"_(": [)_";
+            ss << '"' << Tools::cleanJsonOut(row[5]->toString(0)) << R"_(", )_";
+            ss << '"' << Tools::cleanJsonOut(row[6]->toString(0)) << R"_(", )_";
+            ss << row[0]->getLongVal() << ", ";
+            ss << row[1]->getLongVal() << ", ";
+            ss << row[2]->getDoubleVal() << ", ";
+            ss << row[3]->getLongVal() << ", ";
+            ss << row[4]->getLongVal() << ", ";
+            ss << '"' << Tools::cleanJsonOut(row[8]->toString(0)) << R"_("])_";
+        }
+        ss << "\n}";
+        return ss;
+    }
+
     std::stringstream& genJsonUsage(std::stringstream& ss) {
         const std::shared_ptr<ProgramRun>& run = out.getProgramRun();
 
@@ -621,6 +693,10 @@ public:
         ss << ",\n";
         genJsonRules(ss, "rul", ruleTable.rows.size());
         ss << ",\n";
+        genJsonCounters(ss);
+        ss << ",\n";
+        genJsonIndexes(ss);
+        ss << ",\n";
         genJsonUsage(ss);
         ss << ",\n";
         genJsonConfiguration(ss);
@@ -686,11 +762,13 @@ public:
         std::cout << "\nAvailable profiling commands:" << std::endl;
         std::printf("  %-30s%-5s %s\n", "rel", "-", "display relation table.");
         std::printf("  %-30s%-5s %s\n", "rel <relation id>", "-", "display all rules of a given relation.");
-        std::printf("  %-30s%-5s %s\n", "rul", "-", "display rule table");
+        std::printf("  %-30s%-5s %s\n", "rul", "-", "display rule table with the load imbalance of threads.");
         std::printf("  %-30s%-5s %s\n", "rul <rule id>", "-", "display all version of given rule.");
         std::printf("  %-30s%-5s %s\n", "rul id", "-", "display all rules names and ids.");
         std::printf(
                 "  %-30s%-5s %s\n", "rul id <rule id>", "-", "display the rule name for the given rule id.");
+        std::printf("  %-30s%-5s %s\n", "counters", "-", "display hardware counters of rules.");
+        std::printf("  %-30s%-5s %s\n", "indexes", "-", "display memory used by the indexes of relations.");
         std::printf("  %-30s%-5s %s\n", "graph <relation id> <type>", "-",
                 "graph a relation by type: (tot_t/copy_t/tuples).");
         std::printf("  %-30s%-5s %s\n", "graph <rule id> <type>", "-",
@@ -984,6 +1062,8 @@ public:
 
         linereader.appendTabCompletion("rel");
         linereader.appendTabCompletion("rul");
+        linereader.appendTabCompletion("counters");
+        linereader.appendTabCompletion("indexes");
         linereader.appendTabCompletion("rul id");
         linereader.appendTabCompletion("graph ");
         linereader.appendTabCompletion("top");
@@ -1101,8 +1181,8 @@ public:
     void rul(std::size_t limit, bool showLimit = true) {
         ruleTable.sort(sortColumn);
         std::cout << "  ----- Rule Table -----\n";
-        std::printf(
-                "%8s%8s%8s%8s%8s%8s %s\n\n", "TOT_T", "NREC_T", "REC_T", "TUPLES", "TUP/s", "ID", "RELATION");
+        std::printf("%8s%8s%8s%8s%8s%8s%8s %s\n\n", "TOT_T", "NREC_T", "REC_T", "TUPLES", "TUP/s", "IMBAL",
+                "ID", "RELATION");
         std::size_t count = 0;
         for (auto& row : Tools::formatTable(ruleTable, precision)) {
             if (++count > limit) {
@@ -1111,8 +1191,53 @@ public:
                 }
                 break;
             }
-            std::printf("%8s%8s%8s%8s%8s%8s %s\n", row[0].c_str(), row[1].c_str(), row[2].c_str(),
-                    row[4].c_str(), row[9].c_str(), row[6].c_str(), row[7].c_str());
+            std::printf("%8s%8s%8s%8s%8s%8s%8s %s\n", row[0].c_str(), row[1].c_str(), row[2].c_str(),
+                    row[4].c_str(), row[9].c_str(), row[11].c_str(), row[6].c_str(), row[7].c_str());
+        }
+    }
+
+    void indexes(std::size_t limit) {
+        Table memoryTable = out.getMemoryTable();
+        if (memoryTable.getRows().empty()) {
+            std::cout << "No memory usage of indexes recorded.\n";
+            return;
+        }
+        std::cout << "  ----- Index Memory Usage -----\n";
+        std::printf("%10s%8s%8s %-24s %s\n\n", "BYTES", "SHARE", "ID", "INDEX", "RELATION");
+        std::size_t count = 0;
+        auto formattedMemoryTable = Tools::formatTable(memoryTable, precision);
+        for (std::size_t i = 0; i < formattedMemoryTable.size(); i++) {
+            if (++count > limit) {
+                std::cout << (memoryTable.getRows().size() - limit) << " rows not shown" << std::endl;
+                break;
+            }
+            auto& row = formattedMemoryTable[i];
+            double share = (*memoryTable.getRows()[i])[1]->getDoubleVal();
+            std::printf("%10s%7.1f%%%8s %-24s %s\n", row[0].c_str(), share, row[4].c_str(), row[2].c_str(),
+                    row[3].c_str());
+        }
+    }
+
+    void counters(std::size_t limit) {
+        Table countersTable = out.getCountersTable();
+        if (countersTable.getRows().empty()) {
+            std::cout << "No hardware counters recorded. Enable them with --profile-counters.\n";
+            return;
+        }
+        std::cout << "  ----- Rule Hardware Counters -----\n";
+        std::printf("%10s%10s%8s%10s%10s%8s %s\n\n", "CYCLES", "INSTR", "IPC", "LLC_MISS", "BR_MISS", "ID",
+                "RELATION");
+        std::size_t count = 0;
+        auto formattedCountersTable = Tools::formatTable(countersTable, precision);
+        for (std::size_t i = 0; i < formattedCountersTable.size(); i++) {
+            if (++count > limit) {
+                std::cout << (countersTable.getRows().size() - limit) << " rows not shown" << std::endl;
+                break;
+            }
+            auto& row = formattedCountersTable[i];
+            double ipc = (*countersTable.getRows()[i])[2]->getDoubleVal();
+            std::printf("%10s%10s%8.2f%10s%10s%8s %s\n", row[0].c_str(), row[1].c_str(), ipc, row[3].c_str(),
+                    row[4].c_str(), row[6].c_str(), row[7].c_str());
         }
     }
 
@@ -51,6 +51,7 @@ function graphRel() {
     graph_vals.labels = [];
     graph_vals.tot_t = [];
     graph_vals.tuples = [];
+    graph_vals.threads = [];
     for (j = 0; j < data.rel[selected.rel][9].tot_t.length; j++) {
         graph_vals.labels.push(j.toString());
         graph_vals.tot_t.push(
@@ -76,15 +77,26 @@ function graphIterRul() {
     graph_vals.labels = [];
     graph_vals.tot_t = [];
     graph_vals.tuples = [];
-    for (j = 0; j < data.rul[selected.rul][9].tot_t.length; j++) {
+    graph_vals.threads = [];
+    for (j = 0; j < data.rul[selected.rul][8].tot_t.length; j++) {
         graph_vals.labels.push(j.toString());
         graph_vals.tot_t.push(
-            data.rul[selected.rul][9].tot_t[j]
+            data.rul[selected.rul][8].tot_t[j]
         );
         graph_vals.tuples.push(
-            data.rul[selected.rul][9].tuples[j]
+            data.rul[selected.rul][8].tuples[j]
         )
     }
+    // one series per thread with its busy time in each iteration
+    var threads = data.rul[selected.rul][8].threads || [];
+    for (j = 0; j < threads.length; j++) {
+        for (t = 0; t < threads[j].length; t++) {
+            if (graph_vals.threads.length <= t) {
+                graph_vals.threads.push([]);
+            }
+            graph_vals.threads[t].push({meta: "thread " + t, value: threads[j][t]});
+        }
+    }
 
     document.getElementById('chart_tab').click();
     drawGraph();
@@ -182,6 +194,24 @@ function drawGraph() {
         labels: graph_vals.labels,
         series: [graph_vals.tuples],
     }, options)
+
+    if (graph_vals.threads.length == 0) {
+        document.getElementById("thread-chart").style.display = "none";
+        return;
+    }
+    document.getElementById("thread-chart").style.display = "block";
+    options.stackBars = true;
+    options.axisY = {
+        labelInterpolationFnc: function (value) {
+            return humanise_time(value / 1000000);
+        }
+    };
+    options.plugins = [Chartist.plugins.tooltip({tooltipFnc: function (meta, value) {
+            return meta + '<br/>' + humanise_time(Number(value) / 1000000);}})];
+    new Chartist.Bar(".ct-chart-threads", {
+        labels: graph_vals.labels,
+        series: graph_vals.threads,
+    }, options)
 }
 
 
@@ -211,6 +241,8 @@ function toggle_precision() {
     precision=!precision;
     flip_table_values(document.getElementById("Rel_table"));
     flip_table_values(document.getElementById("Rul_table"));
+    flip_table_values(document.getElementById("Counters_table"));
+    flip_table_values(document.getElementById("Indexes_table"));
     flip_table_values(document.getElementById("rulesofrel_table"));
     flip_table_values(document.getElementById("rulvertable"));
 }
@@ -254,6 +286,10 @@ function create_cell(type, value, perc_total) {
         cell.innerHTML = humanise_time(value);
         cell.setAttribute('data-sort', value);
         cell.className = "time_cell";
+    } else if (type === "float") {
+        cell.innerHTML = parseFloat(value).toFixed(2);
+        cell.setAttribute('data-sort', value);
+        cell.className = "float_cell";
     } else if (type === "int") {
         cell.innerHTML = minify_numbers(value);
         cell.setAttribute('data-sort', value);
@@ -346,6 +382,22 @@ function gen_rul_table() {
         "rul");
 }
 
+function gen_counters_table() {
+    if (!data.hasOwnProperty("counters") || Object.keys(data.counters).length === 0) return;
+    generate_table([["text",0],["id",1],["int",2],["int",3],["float",4],["int",5],["int",6],["code_loc",7]],
+        "Counters_table_body",
+        "counters");
+    document.getElementById("rulcounters").style.display = "block";
+}
+
+function gen_indexes_table() {
+    if (!data.hasOwnProperty("indexes") || Object.keys(data.indexes).length === 0) return;
+    generate_table([["text",0],["id",1],["text",2],["int",3],["perc","int",3],["code_loc",4]],
+        "Indexes_table_body",
+        "indexes");
+    document.getElementById("relindexes").style.display = "block";
+}
+
 function gen_top_rel_table() {
     generate_table([["text",0],["id",1],["time",2],["time",3],["time",4],
         ["time",5],["int",6],["int",7],["perc","float",2],["perc","int",6],["code_loc",8]],
@@ -576,7 +628,8 @@ var came_from = !1;
 var graph_vals = {
     labels:[],
     tot_t:[],
-    tuples:[]
+    tuples:[],
+    threads:[]
 };
 
 
@@ -584,9 +637,13 @@ function init() {
     gen_top();
     gen_rel_table();
     gen_rul_table();
+    gen_counters_table();
+    gen_indexes_table();
     gen_code(-1)
     Tablesort(document.getElementById('Rel_table'),{descending: true});
     Tablesort(document.getElementById('Rul_table'),{descending: true});
+    Tablesort(document.getElementById('Counters_table'),{descending: true});
+    Tablesort(document.getElementById('Indexes_table'),{descending: true});
     Tablesort(document.getElementById('rulesofrel_table'),{descending: true});
     Tablesort(document.getElementById('rulvertable'),{descending: true});
     document.getElementById("default").click();
@@ -48,6 +48,9 @@ std::string htmlBodyTop = R"___(
             <li>Percentage of tuples generated by the rule/relation compared to the total</li>
             <li>The source location of the rule/relation in the datalog file</li>
         </ul>
+        <p>For rules evaluated in parallel, graphing the iterations of a recursive rule also shows the busy time of each thread per iteration.</p>
+        <p>The Relations tab also shows the memory used by each index of a relation after the relation has been evaluated.</p>
+        <p>If the program was profiled with --profile-counters, the Rules tab also shows the cycles, instructions, instructions per cycle, last level cache misses and branch misses of each rule.</p>
         <p>The tables are sortable by all columns by clicking on the header. Number precision can be toggled by pressing the button at the top of the page to show either shorthand or full precision.</p>
         <p>In the relation tab, to see the rules of a relation, select a relation from the table, and a table of rules will appear below. Similary, by selecting a Rule in the Rule tab, a list of versions of the rule will show up (for recursive rules).</p>
         <p>To visualise a graph of a relation, select the relation from the Relations table, then press the graph selected button to show the iterations of the Relation</p>
@@ -131,6 +134,25 @@ std::string htmlBodyTop = R"___(
             </tbody>
         </table>
     </div>
+    <div id="relindexes" style="display:none;">
+        <h3>Index Memory Table</h3>
+        <div class="table_wrapper">
+            <table id='Indexes_table'>
+                <thead>
+                <tr>
+                    <th data-sort-method="text">Name</th>
+                    <th data-sort-method="text">ID</th>
+                    <th data-sort-method="text">Index</th>
+                    <th data-sort-method="number">Bytes</th>
+                    <th data-sort-method="number">% of Memory</th>
+                    <th data-sort-method="text">Source</th>
+                </tr>
+                </thead>
+                <tbody id="Indexes_table_body">
+                </tbody>
+            </table>
+        </div>
+    </div>
     <hr/>
     <div id="rulesofrel" style="display:none;">
         <h3>Rules of Relation</h3>
@@ -179,6 +201,27 @@ std::string htmlBodyTop = R"___(
             </tbody>
         </table>
     </div>
+    <div id="rulcounters" style="display:none;">
+        <h3>Hardware Counters Table</h3>
+        <div class="table_wrapper">
+            <table id='Counters_table'>
+                <thead>
+                <tr>
+                    <th data-sort-method="text">Name</th>
+                    <th data-sort-method="text">ID</th>
+                    <th data-sort-method="number">Cycles</th>
+                    <th data-sort-method="number">Instructions</th>
+                    <th data-sort-method="number">IPC</th>
+                    <th data-sort-method="number">LLC Misses</th>
+                    <th data-sort-method="number">Branch Misses</th>
+                    <th data-sort-method="text">Source</th>
+                </tr>
+                </thead>
+                <tbody id="Counters_table_body">
+                </tbody>
+            </table>
+        </div>
+    </div>
     <hr/>
     <div id="rulver" style="display:none;">
         <h3>Rule Versions Table</h3>
@@ -227,6 +270,10 @@ std::string htmlBodyTop = R"___(
     <div class="ct-chart1"></div>
     <h1>Total number of tuples</h1>
     <div class="ct-chart2"></div>
+    <div id="thread-chart" style="display:none;">
+        <h1>Busy time per thread</h1>
+        <div class="ct-chart-threads"></div>
+    </div>
     <!--<h1>Copy time</h1>-->
     <!--<div class="ct-chart3"></div>-->
     <!--<button onclick="show_graph_vals=!show_graph_vals;draw_graph();">Toggle values</button>-->
@@ -101,6 +101,20 @@ public:
             }
             query = parseTuple(command[1]);
             printTree(prov.explain(query.first, query.second, ExplainConfig::getExplainConfig().depthLimit));
+        } else if (command[0] == "explainall") {
+            std::vector<std::pair<std::string, std::vector<std::string>>> tuples;
+            if (command.size() == 2) {
+                tuples = parseTuples(command[1]);
+            }
+            if (tuples.empty()) {
+                printError(
+                        "Usage: explainall relation_name(\"<string element1>\", <number element2>, ...), "
+                        "relation_name(...), ...\n");
+                return true;
+            }
+            for (auto& tree : prov.explainAll(tuples, ExplainConfig::getExplainConfig().depthLimit)) {
+                printTree(std::move(tree));
+            }
         } else if (command[0] == "subproof") {
             std::pair<std::string, std::vector<std::string>> query;
             int label = -1;
@@ -180,6 +194,18 @@ public:
             } catch (std::exception& e) {
                 printError("Usage: measure <relation name>\n");
             }
+        } else if (command[0] == "export") {
+            auto args = command.size() == 2 ? split(command[1], ' ') : std::vector<std::string>();
+            if (args.size() < 2) {
+                printError("Usage: export <filename> <relation1> <relation2> ...\n");
+                return true;
+            }
+            std::ofstream out(args[0], std::ios::binary);
+            if (!out) {
+                printError("Cannot open <" + args[0] + ">\n");
+                return true;
+            }
+            printInfo(prov.exportProofs(std::vector<std::string>(args.begin() + 1, args.end()), out));
         } else if (command[0] == "output") {
             if (command.size() == 2) {
                 // assign a new filestream, the old one is deleted by unique_ptr
@@ -253,6 +279,8 @@ public:
                     "----------\n"
                     "setdepth <depth>: Set a limit for printed derivation tree height\n"
                     "explain <relation>(<element1>, <element2>, ...): Prints derivation tree\n"
+                    "explainall <relation1>(<element1>, ...), <relation2>(<element1>, ...), ...: Prints\n"
+                    "    the derivation trees of several tuples, which share the search for subproofs\n"
                     "explainnegation <relation>(<element1>, <element2>, ...): Enters an interactive\n"
                     "    interface where the non-existence of a tuple can be explained\n"
                     "subproof <relation>(<label>): Prints derivation tree for a subproof, label is\n"
@@ -261,6 +289,8 @@ public:
                     "output <filename>: Write output into a file, or provide empty filename to\n"
                     "    disable output\n"
                     "format <json|proof>: switch format between json and proof-trees\n"
+                    "export <filename> <relation1> <relation2> ...: Write the proofs of all tuples of\n"
+                    "    the relations into a file, as a binary proof DAG\n"
                     "query <relation1>(<element1>, <element2>, ...), <relation2>(<element1>, <element2>), "
                     "... :\n"
                     "check existence of constant tuples or find solutions for parameterised tuples\n"
@@ -334,6 +364,37 @@ private:
         return std::make_pair(relName, args);
     }
 
+    /**
+     * Parse a list of tuples, each split into relation name and values
+     * @param str The string to parse, should be something like "R(x1, x2, ...), S(y1, y2, ...), ..."
+     * @return the tuples, or an empty list if any of them is malformed
+     */
+    std::vector<std::pair<std::string, std::vector<std::string>>> parseTuples(const std::string& str) {
+        std::vector<std::pair<std::string, std::vector<std::string>>> tuples;
+
+        // regex for a single tuple, whose string values may contain parentheses
+        std::regex tupleRegex(
+                "[a-zA-Z0-9_.-]+[[:blank:]]*\\(([^\"()]|\"[^\"]*\")*\\)", std::regex_constants::extended);
+        std::regex blankRegex("[[:blank:]]*", std::regex_constants::extended);
+        std::regex separatorRegex("[[:blank:]]*,[[:blank:]]*", std::regex_constants::extended);
+        std::smatch tupleMatcher;
+        std::string tuplesStr = str;
+        while (std::regex_search(tuplesStr, tupleMatcher, tupleRegex)) {
+            // tuples are separated by commas
+            const std::regex& precedingRegex = tuples.empty() ? blankRegex : separatorRegex;
+            auto tuple = parseTuple(tupleMatcher[0]);
+            if (tuple.first.empty() || !std::regex_match(tupleMatcher.prefix().str(), precedingRegex)) {
+                return {};
+            }
+            tuples.push_back(std::move(tuple));
+            tuplesStr = tupleMatcher.suffix().str();
+        }
+        if (!std::regex_match(tuplesStr, blankRegex)) {
+            return {};
+        }
+        return tuples;
+    }
+
     /**
      * Parse tuple for query, split into relation name and args, additionally allow varaible as argument in
      * relation tuple
@@ -0,0 +1,263 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ExplainDag.h
+ *
+ * Binary format for exported proof DAGs
+ *
+ * A proof DAG holds one node per tuple, hence a subproof shared by several
+ * derivations is stored once. A file starts with the magic bytes "SFPRFDAG"
+ * and a version byte, followed by records introduced by a tag byte:
+ *
+ *   'R' relation: name, arity, the type of each attribute, and the number of
+ *       rules followed by the number and text of each rule
+ *   'S' symbol: the code and text of a symbol, preceding the first node using it
+ *   'N' node: relation, rule number, height, the values of the tuple, and the
+ *       number of children followed by the children
+ *   'E' end: the number of nodes
+ *
+ * Relations and nodes are numbered in the order of their records. A node
+ * follows its children, which are stored as the distance to its own number.
+ * Facts have height 0 and no children. Negated atoms and constraints are not
+ * stored since they are determined by the rule and the values of the tuples.
+ *
+ * Numbers are unsigned LEB128 varints, values of tuples are zig-zag encoded,
+ * and strings are prefixed by their length.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace souffle {
+
+/** In-memory representation of a proof DAG file */
+struct ProofDag {
+    struct Relation {
+        std::string name;
+        std::vector<std::string> types;
+        std::map<std::size_t, std::string> rules;
+    };
+
+    struct Node {
+        std::size_t rel;
+        std::size_t ruleNum;
+        std::size_t height;
+        std::vector<RamDomain> tuple;
+        std::vector<std::size_t> children;
+    };
+
+    std::vector<Relation> relations;
+    std::map<RamDomain, std::string> symbols;
+    std::vector<Node> nodes;
+};
+
+namespace detail {
+constexpr char proofDagMagic[] = "SFPRFDAG";
+constexpr char proofDagVersion = 1;
+}  // namespace detail
+
+/**
+ * Writes a proof DAG record by record, such that it need not be kept in memory
+ */
+class ProofDagWriter {
+public:
+    explicit ProofDagWriter(std::ostream& out) : out(out) {
+        out.write(detail::proofDagMagic, sizeof(detail::proofDagMagic) - 1);
+        out.put(detail::proofDagVersion);
+    }
+
+    /** Write a relation, returning its number */
+    std::size_t addRelation(const std::string& name, const std::vector<std::string>& types,
+            const std::map<std::size_t, std::string>& rules) {
+        out.put('R');
+        writeString(name);
+        writeNumber(types.size());
+        for (const auto& type : types) {
+            writeString(type);
+        }
+        writeNumber(rules.size());
+        for (const auto& [ruleNum, rule] : rules) {
+            writeNumber(ruleNum);
+            writeString(rule);
+        }
+        return numRelations++;
+    }
+
+    void addSymbol(RamDomain code, const std::string& text) {
+        out.put('S');
+        writeValue(code);
+        writeString(text);
+    }
+
+    /** Write a node whose children have been written before, returning its number */
+    std::size_t addNode(std::size_t rel, std::size_t ruleNum, std::size_t height,
+            const std::vector<RamDomain>& tuple, const std::vector<std::size_t>& children) {
+        out.put('N');
+        writeNumber(rel);
+        writeNumber(ruleNum);
+        writeNumber(height);
+        for (RamDomain value : tuple) {
+            writeValue(value);
+        }
+        writeNumber(children.size());
+        for (std::size_t child : children) {
+            writeNumber(numNodes - child);
+        }
+        return numNodes++;
+    }
+
+    /** Write the end record */
+    void finish() {
+        out.put('E');
+        writeNumber(numNodes);
+        out.flush();
+    }
+
+    std::size_t getNumNodes() const {
+        return numNodes;
+    }
+
+private:
+    std::ostream& out;
+    std::size_t numRelations = 0;
+    std::size_t numNodes = 0;
+
+    void writeNumber(uint64_t number) {
+        while (number >= 0x80) {
+            out.put(static_cast<char>((number & 0x7f) | 0x80));
+            number >>= 7;
+        }
+        out.put(static_cast<char>(number));
+    }
+
+    void writeValue(RamDomain value) {
+        auto bits = static_cast<RamUnsigned>(value);
+        writeNumber((bits << 1) ^ static_cast<RamUnsigned>(value >> (RAM_DOMAIN_SIZE - 1)));
+    }
+
+    void writeString(const std::string& str) {
+        writeNumber(str.size());
+        out.write(str.data(), str.size());
+    }
+};
+
+/**
+ * Reads a proof DAG written by a ProofDagWriter
+ */
+class ProofDagReader {
+public:
+    explicit ProofDagReader(std::istream& in) : in(in) {}
+
+    ProofDag read() {
+        std::string magic(sizeof(detail::proofDagMagic) - 1, '\0');
+        in.read(&magic[0], magic.size());
+        if (!in || magic != detail::proofDagMagic || in.get() != detail::proofDagVersion) {
+            throw std::invalid_argument("Not a proof DAG file");
+        }
+
+        ProofDag dag;
+        while (true) {
+            switch (in.get()) {
+                case 'R': {
+                    ProofDag::Relation rel;
+                    rel.name = readString();
+                    rel.types.resize(readNumber());
+                    for (auto& type : rel.types) {
+                        type = readString();
+                    }
+                    for (std::size_t i = readNumber(); i > 0; --i) {
+                        std::size_t ruleNum = readNumber();
+                        rel.rules[ruleNum] = readString();
+                    }
+                    dag.relations.push_back(std::move(rel));
+                    break;
+                }
+                case 'S': {
+                    RamDomain code = readValue();
+                    dag.symbols[code] = readString();
+                    break;
+                }
+                case 'N': {
+                    ProofDag::Node node;
+                    node.rel = readNumber();
+                    if (node.rel >= dag.relations.size()) {
+                        throw std::invalid_argument("Proof DAG node of unknown relation");
+                    }
+                    node.ruleNum = readNumber();
+                    node.height = readNumber();
+                    node.tuple.resize(dag.relations[node.rel].types.size());
+                    for (auto& value : node.tuple) {
+                        value = readValue();
+                    }
+                    node.children.resize(readNumber());
+                    for (auto& child : node.children) {
+                        std::size_t distance = readNumber();
+                        if (distance == 0 || distance > dag.nodes.size()) {
+                            throw std::invalid_argument("Proof DAG node with invalid child");
+                        }
+                        child = dag.nodes.size() - distance;
+                    }
+                    dag.nodes.push_back(std::move(node));
+                    break;
+                }
+                case 'E':
+                    if (readNumber() != dag.nodes.size()) {
+                        throw std::invalid_argument("Truncated proof DAG file");
+                    }
+                    return dag;
+                default: throw std::invalid_argument("Corrupt proof DAG file");
+            }
+        }
+    }
+
+private:
+    std::istream& in;
+
+    uint64_t readNumber() {
+        uint64_t number = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            auto byte = in.get();
+            if (byte == std::istream::traits_type::eof()) {
+                throw std::invalid_argument("Truncated proof DAG file");
+            }
+            number |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return number;
+            }
+        }
+        throw std::invalid_argument("Corrupt proof DAG file");
+    }
+
+    RamDomain readValue() {
+        auto bits = static_cast<RamUnsigned>(readNumber());
+        return static_cast<RamDomain>((bits >> 1) ^ (~(bits & 1) + 1));
+    }
+
+    std::string readString() {
+        std::string str(readNumber(), '\0');
+        in.read(&str[0], str.size());
+        if (!in) {
+            throw std::invalid_argument("Truncated proof DAG file");
+        }
+        return str;
+    }
+};
+
+}  // end of namespace souffle
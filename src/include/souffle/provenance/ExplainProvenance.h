@@ -167,6 +167,15 @@ public:
     virtual Own<TreeNode> explain(
             std::string relName, std::vector<std::string> tuple, std::size_t depthLimit) = 0;
 
+    /**
+     * Explain a batch of tuples, given as pairs of relation name and arguments
+     *
+     * The subproofs found for one tuple are shared with the others.
+     */
+    virtual VecOwn<TreeNode> explainAll(
+            const std::vector<std::pair<std::string, std::vector<std::string>>>& tuples,
+            std::size_t depthLimit) = 0;
+
     virtual Own<TreeNode> explainSubproof(std::string relName, RamDomain label, std::size_t depthLimit) = 0;
 
     virtual std::vector<std::string> explainNegationGetVariables(
@@ -183,6 +192,13 @@ public:
 
     virtual void printRulesJSON(std::ostream& os) = 0;
 
+    /**
+     * Export the proofs of all tuples of the given relations as a proof DAG
+     * @param relNames, relations whose tuples are explained
+     * @param out, binary stream receiving the proof DAG
+     */
+    virtual std::string exportProofs(const std::vector<std::string>& relNames, std::ostream& out) = 0;
+
     /**
      * Process query with given arguments
      * @param rels, vector of relation, argument pairs
@@ -20,10 +20,12 @@
 #include "souffle/RamTypes.h"
 #include "souffle/SouffleInterface.h"
 #include "souffle/SymbolTable.h"
+#include "souffle/provenance/ExplainDag.h"
 #include "souffle/provenance/ExplainProvenance.h"
 #include "souffle/provenance/ExplainTree.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/ParallelUtil.h"
 #include "souffle/utility/StreamUtil.h"
 #include "souffle/utility/StringUtil.h"
 #include <algorithm>
@@ -34,6 +36,7 @@
 #include <map>
 #include <memory>
 #include <regex>
+#include <set>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -89,147 +92,46 @@ public:
         }
     }
 
+    /**
+     * Explain a tuple, given with the rule number and height of its derivation, up to a depth
+     */
     Own<TreeNode> explain(std::string relName, std::vector<RamDomain> tuple, int ruleNum, int levelNum,
             std::size_t depthLimit) {
-        std::stringstream joinedArgs;
-        joinedArgs << join(decodeArguments(relName, tuple), ", ");
-        auto joinedArgsStr = joinedArgs.str();
-
-        // if fact
-        if (levelNum == 0) {
-            return mk<LeafNode>(relName + "(" + joinedArgsStr + ")");
-        }
-
-        assert(contains(info, std::make_pair(relName, ruleNum)) && "invalid rule for tuple");
+        expandProofs({ProofGoal{relName, tuple, ruleNum, levelNum}}, depthLimit);
+        return buildTree(relName, std::move(tuple), ruleNum, levelNum, depthLimit);
+    }
 
-        // if depth limit exceeded
-        if (depthLimit <= 1) {
-            tuple.push_back(ruleNum);
-            tuple.push_back(levelNum);
+    Own<TreeNode> explain(
+            std::string relName, std::vector<std::string> args, std::size_t depthLimit) override {
+        auto trees = explainAll({{std::move(relName), std::move(args)}}, depthLimit);
+        return std::move(trees.front());
+    }
 
-            // find if subproof exists already
-            std::size_t idx = 0;
-            auto it = std::find(subproofs.begin(), subproofs.end(), tuple);
-            if (it != subproofs.end()) {
-                idx = it - subproofs.begin();
-            } else {
-                subproofs.push_back(tuple);
-                idx = subproofs.size() - 1;
+    VecOwn<TreeNode> explainAll(const std::vector<std::pair<std::string, std::vector<std::string>>>& tuples,
+            std::size_t depthLimit) override {
+        std::vector<ProofGoal> goals;
+        for (const auto& [relName, args] : tuples) {
+            ProofGoal goal{relName, argsToNums(relName, args), -1, -1};
+            if (!goal.tuple.empty()) {
+                std::tie(goal.ruleNum, goal.levelNum) = findTuple(relName, goal.tuple);
             }
-
-            return mk<LeafNode>("subproof " + relName + "(" + std::to_string(idx) + ")");
+            goals.push_back(std::move(goal));
         }
 
-        tuple.push_back(levelNum);
-
-        auto internalNode =
-                mk<InnerNode>(relName + "(" + joinedArgsStr + ")", "(R" + std::to_string(ruleNum) + ")");
-
-        // make return vector pointer
-        std::vector<RamDomain> ret;
-
-        // execute subroutine to get subproofs
-        prog.executeSubroutine(relName + "_" + std::to_string(ruleNum) + "_subproof", tuple, ret);
-
-        // recursively get nodes for subproofs
-        std::size_t tupleCurInd = 0;
-        auto bodyRelations = info.at(std::make_pair(relName, ruleNum));
-
-        // start from begin + 1 because the first element represents the head atom
-        for (auto it = bodyRelations.begin() + 1; it < bodyRelations.end(); it++) {
-            std::string bodyLiteral = *it;
-            // split bodyLiteral since it contains relation name plus arguments
-            std::string bodyRel = splitString(bodyLiteral, ',')[0];
-
-            // check whether the current atom is a constraint
-            assert(bodyRel.size() > 0 && "body of a relation should have positive length");
-            bool isConstraint = contains(constraintList, bodyRel);
-
-            // handle negated atom names
-            auto bodyRelAtomName = bodyRel;
-            if (bodyRel[0] == '!' && bodyRel != "!=") {
-                bodyRelAtomName = bodyRel.substr(1);
-            }
-
-            // traverse subroutine return
-            std::size_t arity;
-            std::size_t auxiliaryArity;
-            if (isConstraint) {
-                // we only handle binary constraints, and assume arity is 4 to account for hidden provenance
-                // annotations
-                arity = 4;
-                auxiliaryArity = 2;
-            } else {
-                arity = prog.getRelation(bodyRelAtomName)->getArity();
-                auxiliaryArity = prog.getRelation(bodyRelAtomName)->getAuxiliaryArity();
-            }
-            auto tupleEnd = tupleCurInd + arity;
-
-            // store current tuple
-            std::vector<RamDomain> subproofTuple;
+        // the derivations of all tuples are searched at once, sharing the cached subproofs
+        expandProofs(goals, depthLimit);
 
-            for (; tupleCurInd < tupleEnd - auxiliaryArity; tupleCurInd++) {
-                subproofTuple.push_back(ret[tupleCurInd]);
-            }
-
-            int subproofRuleNum = ret[tupleCurInd];
-            int subproofLevelNum = ret[tupleCurInd + 1];
-
-            tupleCurInd += 2;
-
-            // for a negation, display the corresponding tuple and do not recurse
-            if (bodyRel[0] == '!' && bodyRel != "!=") {
-                std::stringstream joinedTuple;
-                joinedTuple << join(decodeArguments(bodyRelAtomName, subproofTuple), ", ");
-                auto joinedTupleStr = joinedTuple.str();
-                internalNode->add_child(mk<LeafNode>(bodyRel + "(" + joinedTupleStr + ")"));
-                internalNode->setSize(internalNode->getSize() + 1);
-                // for a binary constraint, display the corresponding values and do not recurse
-            } else if (isConstraint) {
-                std::stringstream joinedConstraint;
-
-                // FIXME: We need type info in order to figure out how to print arguments.
-                BinaryConstraintOp rawBinOp = toBinaryConstraintOp(bodyRel);
-                if (isOrderedBinaryConstraintOp(rawBinOp)) {
-                    joinedConstraint << subproofTuple[0] << " " << bodyRel << " " << subproofTuple[1];
-                } else {
-                    joinedConstraint << bodyRel << "(\"" << symTable.decode(subproofTuple[0]) << "\", \""
-                                     << symTable.decode(subproofTuple[1]) << "\")";
-                }
-
-                internalNode->add_child(mk<LeafNode>(joinedConstraint.str()));
-                internalNode->setSize(internalNode->getSize() + 1);
-                // otherwise, for a normal tuple, recurse
+        VecOwn<TreeNode> trees;
+        for (const auto& goal : goals) {
+            if (goal.tuple.empty()) {
+                trees.push_back(mk<LeafNode>("Relation not found"));
+            } else if (goal.ruleNum < 0 || goal.levelNum == -1) {
+                trees.push_back(mk<LeafNode>("Tuple not found"));
             } else {
-                auto child =
-                        explain(bodyRel, subproofTuple, subproofRuleNum, subproofLevelNum, depthLimit - 1);
-                internalNode->setSize(internalNode->getSize() + child->getSize());
-                internalNode->add_child(std::move(child));
+                trees.push_back(buildTree(goal.relName, goal.tuple, goal.ruleNum, goal.levelNum, depthLimit));
             }
-
-            tupleCurInd = tupleEnd;
         }
-
-        return internalNode;
-    }
-
-    Own<TreeNode> explain(
-            std::string relName, std::vector<std::string> args, std::size_t depthLimit) override {
-        auto tuple = argsToNums(relName, args);
-        if (tuple.empty()) {
-            return mk<LeafNode>("Relation not found");
-        }
-
-        std::tuple<int, int> tupleInfo = findTuple(relName, tuple);
-
-        int ruleNum = std::get<0>(tupleInfo);
-        int levelNum = std::get<1>(tupleInfo);
-
-        if (ruleNum < 0 || levelNum == -1) {
-            return mk<LeafNode>("Tuple not found");
-        }
-
-        return explain(relName, tuple, ruleNum, levelNum, depthLimit);
+        return trees;
     }
 
     Own<TreeNode> explainSubproof(
@@ -599,6 +501,30 @@ public:
         os << "\n]\n";
     }
 
+    std::string exportProofs(const std::vector<std::string>& relNames, std::ostream& out) override {
+        for (const auto& relName : relNames) {
+            if (prog.getRelation(relName) == nullptr) {
+                return "No relation found\n";
+            }
+        }
+
+        ProofDagExport dag(out);
+        for (const auto& relName : relNames) {
+            auto rel = prog.getRelation(relName);
+            arity_type arity = rel->getPrimaryArity();
+            for (auto& tuple : *rel) {
+                std::vector<RamDomain> currentTuple;
+                for (arity_type i = 0; i < arity; i++) {
+                    currentTuple.push_back(tuple[i]);
+                }
+                exportProof(dag, relName, std::move(currentTuple), tuple[arity], tuple[arity + 1]);
+            }
+        }
+        dag.writer.finish();
+
+        return "Exported " + std::to_string(dag.writer.getNumNodes()) + " proof nodes\n";
+    }
+
     void queryProcess(const std::vector<std::pair<std::string, std::vector<std::string>>>& rels) override {
         std::regex varRegex("[a-zA-Z_][a-zA-Z_0-9]*", std::regex_constants::extended);
         std::regex symbolRegex("\"([^\"]*)\"", std::regex_constants::extended);
@@ -734,12 +660,366 @@ public:
     }
 
 private:
+    /** A tuple to be explained, with the rule number and height of its derivation */
+    struct ProofGoal {
+        std::string relName;
+        std::vector<RamDomain> tuple;
+        int ruleNum;
+        int levelNum;
+    };
+
+    /** A literal of the body of a derivation, as returned by a subproof subroutine */
+    struct BodyLiteral {
+        // the relation of an atom, prefixed by '!' if negated, or the operator of a constraint
+        std::string rel;
+        std::vector<RamDomain> tuple;
+        int ruleNum;
+        int levelNum;
+        bool isConstraint;
+        bool isNegation;
+    };
+
+    /** The name and arguments of the subproof subroutine of a derivation */
+    using SubproofCall = std::pair<std::string, std::vector<RamDomain>>;
+
     std::map<std::pair<std::string, std::size_t>, std::vector<std::string>> info;
     std::map<std::pair<std::string, std::size_t>, std::string> rules;
     std::vector<std::vector<RamDomain>> subproofs;
+
+    /** Cached results of the subproof subroutines, shared by all explanations */
+    std::map<SubproofCall, std::vector<RamDomain>> proofSteps;
+
+    /** Cached proof trees of derivations which are not cut by the depth limit */
+    std::map<SubproofCall, Own<TreeNode>> proofTrees;
     std::vector<std::string> constraintList = {
             "=", "!=", "<", "<=", ">=", ">", "match", "contains", "not_match", "not_contains"};
 
+    SubproofCall getSubproofCall(
+            const std::string& relName, std::vector<RamDomain> tuple, int ruleNum, int levelNum) const {
+        tuple.push_back(levelNum);
+        return {relName + "_" + std::to_string(ruleNum) + "_subproof", std::move(tuple)};
+    }
+
+    /** Obtain the result of a subproof subroutine, executing it unless cached */
+    const std::vector<RamDomain>& getSubproof(const SubproofCall& call) {
+        auto it = proofSteps.find(call);
+        if (it == proofSteps.end()) {
+            std::vector<RamDomain> ret;
+            prog.executeSubroutine(call.first, call.second, ret);
+            it = proofSteps.emplace(call, std::move(ret)).first;
+        }
+        return it->second;
+    }
+
+    /**
+     * Execute the subproof subroutines of the derivations of the given tuples and, recursively,
+     * of their body atoms up to the depth limit, caching their results.
+     *
+     * The derivations are expanded level by level. Those of a level are independent of each
+     * other, hence their subroutines are executed in parallel.
+     */
+    void expandProofs(std::vector<ProofGoal> goals, std::size_t depthLimit) {
+        std::set<SubproofCall> visited;
+        for (std::size_t depth = depthLimit; depth > 1 && !goals.empty(); --depth) {
+            // the derivations of this level which have not been expanded on a previous level
+            std::vector<std::pair<const ProofGoal*, SubproofCall>> calls;
+            for (const auto& goal : goals) {
+                // facts and missing tuples have no derivation
+                if (goal.ruleNum < 0 || goal.levelNum <= 0) {
+                    continue;
+                }
+                auto call = getSubproofCall(goal.relName, goal.tuple, goal.ruleNum, goal.levelNum);
+                if (visited.insert(call).second) {
+                    calls.emplace_back(&goal, std::move(call));
+                }
+            }
+
+            std::vector<const SubproofCall*> pending;
+            for (const auto& call : calls) {
+                if (!contains(proofSteps, call.second)) {
+                    pending.push_back(&call.second);
+                }
+            }
+            std::vector<std::vector<RamDomain>> results(pending.size());
+            PARALLEL_START
+            pfor (std::size_t i = 0; i < pending.size(); i++) {
+                prog.executeSubroutine(pending[i]->first, pending[i]->second, results[i]);
+            }
+            PARALLEL_END
+            for (std::size_t i = 0; i < pending.size(); i++) {
+                proofSteps.emplace(*pending[i], std::move(results[i]));
+            }
+
+            // the atoms of the bodies are the goals of the next level
+            std::vector<ProofGoal> next;
+            for (const auto& [goal, call] : calls) {
+                for (auto& literal : getBodyLiterals(goal->relName, goal->ruleNum, proofSteps.at(call))) {
+                    if (!literal.isConstraint && !literal.isNegation) {
+                        next.push_back(ProofGoal{
+                                literal.rel, std::move(literal.tuple), literal.ruleNum, literal.levelNum});
+                    }
+                }
+            }
+            goals = std::move(next);
+        }
+    }
+
+    /**
+     * Split the result of the subproof subroutine of a derivation into its body literals
+     */
+    std::vector<BodyLiteral> getBodyLiterals(
+            const std::string& relName, int ruleNum, const std::vector<RamDomain>& ret) const {
+        std::vector<BodyLiteral> literals;
+        std::size_t tupleCurInd = 0;
+        const auto& bodyRelations = info.at(std::make_pair(relName, ruleNum));
+
+        // start from begin + 1 because the first element represents the head atom
+        for (auto it = bodyRelations.begin() + 1; it < bodyRelations.end(); it++) {
+            std::string bodyLiteral = *it;
+            // split bodyLiteral since it contains relation name plus arguments
+            std::string bodyRel = splitString(bodyLiteral, ',')[0];
+
+            // check whether the current atom is a constraint
+            assert(bodyRel.size() > 0 && "body of a relation should have positive length");
+            bool isConstraint = contains(constraintList, bodyRel);
+
+            // handle negated atom names
+            bool isNegation = bodyRel[0] == '!' && bodyRel != "!=";
+            auto bodyRelAtomName = isNegation ? bodyRel.substr(1) : bodyRel;
+
+            // traverse subroutine return
+            std::size_t arity;
+            std::size_t auxiliaryArity;
+            if (isConstraint) {
+                // we only handle binary constraints, and assume arity is 4 to account for hidden provenance
+                // annotations
+                arity = 4;
+                auxiliaryArity = 2;
+            } else {
+                arity = prog.getRelation(bodyRelAtomName)->getArity();
+                auxiliaryArity = prog.getRelation(bodyRelAtomName)->getAuxiliaryArity();
+            }
+            auto tupleEnd = tupleCurInd + arity;
+
+            BodyLiteral literal{bodyRel, {}, 0, 0, isConstraint, isNegation};
+            for (; tupleCurInd < tupleEnd - auxiliaryArity; tupleCurInd++) {
+                literal.tuple.push_back(ret[tupleCurInd]);
+            }
+            literal.ruleNum = ret[tupleCurInd];
+            literal.levelNum = ret[tupleCurInd + 1];
+            literals.push_back(std::move(literal));
+
+            tupleCurInd = tupleEnd;
+        }
+        return literals;
+    }
+
+    std::string formatAtom(const std::string& relName, const std::vector<RamDomain>& tuple) const {
+        std::stringstream joinedArgs;
+        joinedArgs << relName << "(" << join(decodeArguments(relName, tuple), ", ") << ")";
+        return joinedArgs.str();
+    }
+
+    /**
+     * Build the proof tree of a derivation from the cached subproofs
+     */
+    Own<TreeNode> buildTree(std::string relName, std::vector<RamDomain> tuple, int ruleNum, int levelNum,
+            std::size_t depthLimit) {
+        // if fact
+        if (levelNum == 0) {
+            return mk<LeafNode>(formatAtom(relName, tuple));
+        }
+
+        assert(contains(info, std::make_pair(relName, ruleNum)) && "invalid rule for tuple");
+
+        // if depth limit exceeded
+        if (depthLimit <= 1) {
+            tuple.push_back(ruleNum);
+            tuple.push_back(levelNum);
+
+            // find if subproof exists already
+            std::size_t idx = 0;
+            auto it = std::find(subproofs.begin(), subproofs.end(), tuple);
+            if (it != subproofs.end()) {
+                idx = it - subproofs.begin();
+            } else {
+                subproofs.push_back(tuple);
+                idx = subproofs.size() - 1;
+            }
+
+            return mk<LeafNode>("subproof " + relName + "(" + std::to_string(idx) + ")");
+        }
+
+        // the heights of the body atoms are less than the height of the derivation, hence its tree
+        // is not cut if the depth limit exceeds the height, and the same for all occurrences
+        auto call = getSubproofCall(relName, tuple, ruleNum, levelNum);
+        bool complete = depthLimit > static_cast<std::size_t>(levelNum);
+        if (complete) {
+            auto it = proofTrees.find(call);
+            if (it != proofTrees.end()) {
+                return it->second->clone();
+            }
+        }
+
+        auto internalNode = mk<InnerNode>(formatAtom(relName, tuple), "(R" + std::to_string(ruleNum) + ")");
+
+        const auto& ret = getSubproof(call);
+
+        // recursively get nodes for subproofs
+        for (auto& literal : getBodyLiterals(relName, ruleNum, ret)) {
+            // for a negation, display the corresponding tuple and do not recurse
+            if (literal.isNegation) {
+                std::stringstream joinedTuple;
+                joinedTuple << join(decodeArguments(literal.rel.substr(1), literal.tuple), ", ");
+                auto joinedTupleStr = joinedTuple.str();
+                internalNode->add_child(mk<LeafNode>(literal.rel + "(" + joinedTupleStr + ")"));
+                internalNode->setSize(internalNode->getSize() + 1);
+                // for a binary constraint, display the corresponding values and do not recurse
+            } else if (literal.isConstraint) {
+                std::stringstream joinedConstraint;
+
+                // FIXME: We need type info in order to figure out how to print arguments.
+                BinaryConstraintOp rawBinOp = toBinaryConstraintOp(literal.rel);
+                if (isOrderedBinaryConstraintOp(rawBinOp)) {
+                    joinedConstraint << literal.tuple[0] << " " << literal.rel << " " << literal.tuple[1];
+                } else {
+                    joinedConstraint << literal.rel << "(\"" << symTable.decode(literal.tuple[0]) << "\", \""
+                                     << symTable.decode(literal.tuple[1]) << "\")";
+                }
+
+                internalNode->add_child(mk<LeafNode>(joinedConstraint.str()));
+                internalNode->setSize(internalNode->getSize() + 1);
+                // otherwise, for a normal tuple, recurse
+            } else {
+                auto child = buildTree(literal.rel, std::move(literal.tuple), literal.ruleNum,
+                        literal.levelNum, depthLimit - 1);
+                internalNode->setSize(internalNode->getSize() + child->getSize());
+                internalNode->add_child(std::move(child));
+            }
+        }
+
+        if (complete) {
+            proofTrees.emplace(call, internalNode->clone());
+        }
+        return internalNode;
+    }
+
+    /** State of an export of proofs, mapping the exported tuples to their nodes */
+    struct ProofDagExport {
+        explicit ProofDagExport(std::ostream& out) : writer(out) {}
+
+        ProofDagWriter writer;
+        std::map<std::string, std::size_t> relations;
+        std::vector<std::map<std::vector<RamDomain>, std::size_t>> nodes;
+        std::set<RamDomain> symbols;
+    };
+
+    /** A derivation being exported, whose body atoms are exported first */
+    struct ProofDagFrame {
+        std::string relName;
+        std::size_t rel;
+        std::vector<RamDomain> tuple;
+        int ruleNum;
+        int levelNum;
+        bool expanded;
+        std::vector<BodyLiteral> body;
+        std::vector<std::size_t> children;
+    };
+
+    /** Obtain the number of a relation in an export, writing the relation on first use */
+    std::size_t getExportedRelation(ProofDagExport& dag, const std::string& relName) {
+        auto it = dag.relations.find(relName);
+        if (it != dag.relations.end()) {
+            return it->second;
+        }
+
+        auto rel = prog.getRelation(relName);
+        std::vector<std::string> types;
+        for (arity_type i = 0; i < rel->getPrimaryArity(); i++) {
+            types.push_back(rel->getAttrType(i));
+        }
+        std::map<std::size_t, std::string> relRules;
+        for (const auto& rule : rules) {
+            if (rule.first.first == relName) {
+                relRules.insert({rule.first.second, rule.second});
+            }
+        }
+
+        std::size_t num = dag.writer.addRelation(relName, types, relRules);
+        dag.relations.insert({relName, num});
+        dag.nodes.emplace_back();
+        return num;
+    }
+
+    /**
+     * Export the derivation of a tuple, and those of its body atoms which have not been exported
+     * yet, returning the number of its node
+     *
+     * Derivations may be deep, hence they are traversed with an explicit stack. Apart from the
+     * stack, only the numbers of the exported nodes are kept in memory.
+     */
+    std::size_t exportProof(ProofDagExport& dag, const std::string& relName, std::vector<RamDomain> tuple,
+            int ruleNum, int levelNum) {
+        std::size_t rel = getExportedRelation(dag, relName);
+        auto it = dag.nodes[rel].find(tuple);
+        if (it != dag.nodes[rel].end()) {
+            return it->second;
+        }
+
+        std::vector<ProofDagFrame> stack;
+        stack.push_back({relName, rel, std::move(tuple), ruleNum, levelNum, false, {}, {}});
+        while (true) {
+            auto& frame = stack.back();
+
+            // find the body atoms of a derivation, reversed such that they are exported in order
+            if (!frame.expanded) {
+                frame.expanded = true;
+                if (frame.levelNum > 0) {
+                    std::vector<RamDomain> ret;
+                    auto call = getSubproofCall(frame.relName, frame.tuple, frame.ruleNum, frame.levelNum);
+                    prog.executeSubroutine(call.first, call.second, ret);
+                    for (auto& literal : getBodyLiterals(frame.relName, frame.ruleNum, ret)) {
+                        if (!literal.isConstraint && !literal.isNegation) {
+                            frame.body.push_back(std::move(literal));
+                        }
+                    }
+                    std::reverse(frame.body.begin(), frame.body.end());
+                }
+            }
+
+            // export the next body atom, unless it has been exported before
+            if (!frame.body.empty()) {
+                BodyLiteral literal = std::move(frame.body.back());
+                frame.body.pop_back();
+                std::size_t bodyRel = getExportedRelation(dag, literal.rel);
+                auto pos = dag.nodes[bodyRel].find(literal.tuple);
+                if (pos != dag.nodes[bodyRel].end()) {
+                    frame.children.push_back(pos->second);
+                } else {
+                    stack.push_back({literal.rel, bodyRel, std::move(literal.tuple), literal.ruleNum,
+                            literal.levelNum, false, {}, {}});
+                }
+                continue;
+            }
+
+            // all body atoms have been exported, hence the derivation itself can be written
+            auto relation = prog.getRelation(frame.relName);
+            for (std::size_t i = 0; i < frame.tuple.size(); i++) {
+                if (*relation->getAttrType(i) == 's' && dag.symbols.insert(frame.tuple[i]).second) {
+                    dag.writer.addSymbol(frame.tuple[i], symTable.decode(frame.tuple[i]));
+                }
+            }
+            std::size_t node =
+                    dag.writer.addNode(frame.rel, frame.ruleNum, frame.levelNum, frame.tuple, frame.children);
+            dag.nodes[frame.rel].insert({std::move(frame.tuple), node});
+            stack.pop_back();
+            if (stack.empty()) {
+                return node;
+            }
+            stack.back().children.push_back(node);
+        }
+    }
+
     RamDomain lookupExisting(const std::string& symbol) {
         // only works if run sequentially; check size of symbole
         std::size_t before = symTable.size();
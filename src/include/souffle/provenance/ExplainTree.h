@@ -112,6 +112,9 @@ public:
 
     virtual void printJSON(std::ostream& os, int pos) = 0;
 
+    // copy the node and its sub-trees, which are not placed yet
+    virtual Own<TreeNode> clone() const = 0;
+
 protected:
     std::string txt;      // text of tree node
     uint32_t width = 0;   // width of node (including sub-trees)
@@ -190,6 +193,15 @@ public:
         os << tab << "}";
     }
 
+    Own<TreeNode> clone() const override {
+        auto res = mk<InnerNode>(txt, label);
+        for (const Own<TreeNode>& k : children) {
+            res->add_child(k->clone());
+        }
+        res->setSize(size);
+        return res;
+    }
+
 private:
     VecOwn<TreeNode> children;
     std::string label;
@@ -222,6 +234,10 @@ public:
         std::string tab(pos, '\t');
         os << tab << R"({ "axiom": ")" << stringify(txt) << "\"}";
     }
+
+    Own<TreeNode> clone() const override {
+        return mk<LeafNode>(txt);
+    }
 };
 
 }  // end of namespace souffle
@@ -14,13 +14,138 @@
  *
  ***********************************************************************/
 
+#include "interpreter/DynamicBTree.h"
 #include "interpreter/Relation.h"
 #include "ram/Relation.h"
 #include "ram/analysis/Index.h"
 #include "souffle/utility/MiscUtil.h"
+#include <cstddef>
+#include <utility>
+#include <vector>
 
 namespace souffle::interpreter {
 
+namespace {
+
+/**
+ * A btree index of an arity only known at runtime.
+ */
+class DynamicBTreeIndex : public DynamicIndex {
+    using TreeIterator = DynamicBTree::iterator;
+
+    DynamicBTree data;
+
+    class Cursor : public DynamicIndex::Cursor {
+        TreeIterator cur;
+        TreeIterator last;
+
+    public:
+        Cursor(TreeIterator cur, TreeIterator last) : cur(cur), last(last) {}
+
+        const RamDomain* get() const override {
+            return cur == last ? nullptr : (*cur).data();
+        }
+
+        const RamDomain* next() override {
+            ++cur;
+            return get();
+        }
+
+        Own<DynamicIndex::Cursor> clone() const override {
+            return mk<Cursor>(cur, last);
+        }
+
+        bool equal(const DynamicIndex::Cursor& other) const override {
+            return cur == static_cast<const Cursor&>(other).cur;
+        }
+    };
+
+    souffle::range<iterator> wrap(TreeIterator begin, TreeIterator end) const {
+        if (begin == end) {
+            return {iterator(), iterator()};
+        }
+        return {iterator(mk<Cursor>(begin, end), data.getArity()), iterator()};
+    }
+
+    class View : public DynamicIndex::View {
+        const DynamicBTreeIndex& index;
+
+    public:
+        View(const DynamicBTreeIndex& index) : index(index) {}
+
+        bool contains(const RamDomain* entry) override {
+            return index.data.contains(entry);
+        }
+
+        souffle::range<iterator> range(const RamDomain* low, const RamDomain* high) override {
+            return index.range(low, high);
+        }
+    };
+
+public:
+    DynamicBTreeIndex(Order order) : DynamicIndex(order), data(order.size()) {}
+
+    Own<DynamicIndex::View> createView() const override {
+        return mk<View>(*this);
+    }
+
+    bool empty() const override {
+        return data.empty();
+    }
+
+    std::size_t size() const override {
+        return data.size();
+    }
+
+    std::size_t getMemoryUsage() const override {
+        return data.getMemoryUsage();
+    }
+
+    bool insert(const RamDomain* tuple) override {
+        RamDomain entry[MAX_DYNAMIC_ARITY];
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            entry[i] = tuple[order[i]];
+        }
+        return data.insert(entry);
+    }
+
+    bool contains(const RamDomain* entry) const override {
+        return data.contains(entry);
+    }
+
+    souffle::range<iterator> range(const RamDomain* low, const RamDomain* high) const {
+        if (data.compare(low, high) > 0) {
+            return {iterator(), iterator()};
+        }
+        return wrap(data.lower_bound(low), data.upper_bound(high));
+    }
+
+    souffle::range<iterator> scan() const override {
+        return wrap(data.begin(), data.end());
+    }
+
+    std::vector<souffle::range<iterator>> partitionScan(int partitionCount) const override {
+        std::vector<souffle::range<iterator>> res;
+        for (const auto& chunk : data.partition(partitionCount)) {
+            res.push_back(wrap(chunk.first, chunk.second));
+        }
+        return res;
+    }
+
+    void clear() override {
+        data.clear();
+    }
+};
+
+}  // namespace
+
+Own<DynamicIndex> createDynamicBTreeIndex(std::size_t arity, Order order) {
+    if (arity > MAX_DYNAMIC_ARITY) {
+        fatal("Requested arity not supported by dynamic btree relations.");
+    }
+    return mk<DynamicBTreeIndex>(std::move(order));
+}
+
 #define CREATE_BTREE_REL(Structure, Arity, ...)                        \
     case (Arity): {                                                    \
         return mk<Relation<Arity, interpreter::Btree>>(                \
@@ -32,7 +157,13 @@ Own<RelationWrapper> createBTreeRelation(
     switch (id.getArity()) {
         FOR_EACH_BTREE(CREATE_BTREE_REL);
 
-        default: fatal("Requested arity not yet supported. Feel free to add it.");
+        default: {
+            if (id.getArity() > MAX_DYNAMIC_ARITY) {
+                fatal("Requested arity not yet supported. Feel free to add it.");
+            }
+            return mk<Relation<Dynamic, interpreter::Btree>>(
+                    id.getArity(), id.getAuxiliaryArity(), id.getName(), indexSelection);
+        }
     }
 }
 
@@ -10,29 +10,190 @@
  *
  * @file BrieIndex.cpp
  *
- * Interpreter index with generic interface.
+ * Interpreter index on tries, for Brie relations of any arity.
  *
  ***********************************************************************/
 
 #include "interpreter/Relation.h"
 #include "ram/Relation.h"
 #include "ram/analysis/Index.h"
+#include "souffle/datastructure/Brie.h"
 #include "souffle/utility/MiscUtil.h"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
 
 namespace souffle::interpreter {
 
-#define CREATE_BRIE_REL(Structure, Arity, ...)                                                               \
-    case (Arity): {                                                                                          \
-        return mk<Relation<Arity, interpreter::Brie>>(id.getAuxiliaryArity(), id.getName(), indexSelection); \
+namespace {
+
+/**
+ * A Brie index of a fixed arity behind the runtime-arity interface.
+ */
+template <std::size_t Arity>
+class TrieIndex : public DynamicIndex {
+    using Data = Trie<Arity>;
+    using Entry = typename Data::const_entry_span_type;
+    using Hints = typename Data::operation_hints;
+    using TrieIterator = typename Data::iterator;
+
+    Data data;
+
+    class Cursor : public DynamicIndex::Cursor {
+        TrieIterator cur;
+        TrieIterator last;
+
+    public:
+        Cursor(TrieIterator cur, TrieIterator last) : cur(std::move(cur)), last(std::move(last)) {}
+
+        const RamDomain* get() const override {
+            return cur == last ? nullptr : cur->data();
+        }
+
+        const RamDomain* next() override {
+            ++cur;
+            return get();
+        }
+
+        Own<DynamicIndex::Cursor> clone() const override {
+            return mk<Cursor>(cur, last);
+        }
+
+        bool equal(const DynamicIndex::Cursor& other) const override {
+            return cur == static_cast<const Cursor&>(other).cur;
+        }
+    };
+
+    static souffle::range<iterator> wrap(const souffle::range<TrieIterator>& range) {
+        if (range.empty()) {
+            return {iterator(), iterator()};
+        }
+        return {iterator(mk<Cursor>(range.begin(), range.end()), Arity), iterator()};
     }
 
-Own<RelationWrapper> createBrieRelation(
-        const ram::Relation& id, const ram::analysis::IndexCluster& /* orderSet */) {
-    switch (id.getArity()) {
-        FOR_EACH_BRIE(CREATE_BRIE_REL);
+    /**
+     * Obtains the tuples starting with the first levels columns of the entry.
+     */
+    template <unsigned Levels = 0>
+    static souffle::range<TrieIterator> getBoundaries(
+            const Data& data, Entry entry, std::size_t levels, Hints& hints) {
+        if constexpr (Levels < Arity) {
+            if (levels > Levels) {
+                return getBoundaries<Levels + 1>(data, entry, levels, hints);
+            }
+        }
+        return data.template getBoundaries<Levels>(entry, hints);
+    }
+
+    class View : public DynamicIndex::View {
+        const Data& data;
+        Hints hints;
+
+    public:
+        View(const Data& data) : data(data) {}
+
+        bool contains(const RamDomain* entry) override {
+            return data.contains(Entry(entry, Arity), hints);
+        }
+
+        souffle::range<iterator> range(const RamDomain* low, const RamDomain* high) override {
+            // the bounds fix a prefix of the columns, the remaining ones are unbounded
+            std::size_t levels = 0;
+            while (levels < Arity && low[levels] == high[levels]) {
+                ++levels;
+            }
+            return wrap(getBoundaries(data, Entry(low, Arity), levels, hints));
+        }
+    };
+
+public:
+    using DynamicIndex::DynamicIndex;
 
-        default: fatal("Brie is not supported in the interpreter mode.");
+    Own<DynamicIndex::View> createView() const override {
+        return mk<View>(data);
     }
+
+    bool empty() const override {
+        return data.empty();
+    }
+
+    std::size_t size() const override {
+        return data.size();
+    }
+
+    std::size_t getMemoryUsage() const override {
+        return data.getMemoryUsage();
+    }
+
+    bool insert(const RamDomain* tuple) override {
+        RamDomain entry[Arity];
+        for (std::size_t i = 0; i < Arity; ++i) {
+            entry[i] = tuple[order[i]];
+        }
+        return data.insert(Entry(entry, Arity));
+    }
+
+    bool contains(const RamDomain* entry) const override {
+        return data.contains(Entry(entry, Arity));
+    }
+
+    souffle::range<iterator> scan() const override {
+        return wrap({data.begin(), data.end()});
+    }
+
+    std::vector<souffle::range<iterator>> partitionScan(int partitionCount) const override {
+        std::vector<souffle::range<iterator>> res;
+        for (const auto& chunk : data.partition(partitionCount)) {
+            res.push_back(wrap(chunk));
+        }
+        return res;
+    }
+
+    void clear() override {
+        data.clear();
+    }
+};
+
+}  // namespace
+
+#define CREATE_BRIE_INDEX(Arity)                       \
+    case (Arity): {                                    \
+        return mk<TrieIndex<Arity>>(std::move(order)); \
+    }
+
+Own<DynamicIndex> createBrieIndex(std::size_t arity, Order order) {
+    switch (arity) {
+        CREATE_BRIE_INDEX(1)
+        CREATE_BRIE_INDEX(2)
+        CREATE_BRIE_INDEX(3)
+        CREATE_BRIE_INDEX(4)
+        CREATE_BRIE_INDEX(5)
+        CREATE_BRIE_INDEX(6)
+        CREATE_BRIE_INDEX(7)
+        CREATE_BRIE_INDEX(8)
+        CREATE_BRIE_INDEX(9)
+        CREATE_BRIE_INDEX(10)
+        CREATE_BRIE_INDEX(11)
+        CREATE_BRIE_INDEX(12)
+        CREATE_BRIE_INDEX(13)
+        CREATE_BRIE_INDEX(14)
+        CREATE_BRIE_INDEX(15)
+        CREATE_BRIE_INDEX(16)
+        CREATE_BRIE_INDEX(17)
+        CREATE_BRIE_INDEX(18)
+        CREATE_BRIE_INDEX(19)
+        CREATE_BRIE_INDEX(20)
+
+        default: fatal("Requested arity not supported by Brie relations.");
+    }
+}
+
+#undef CREATE_BRIE_INDEX
+
+Own<RelationWrapper> createBrieRelation(
+        const ram::Relation& id, const ram::analysis::IndexCluster& indexSelection) {
+    return mk<Relation<Dynamic, Brie>>(id.getArity(), id.getAuxiliaryArity(), id.getName(), indexSelection);
 }
 
 }  // namespace souffle::interpreter
@@ -19,6 +19,7 @@
 #include "interpreter/Index.h"
 #include "interpreter/Relation.h"
 #include "souffle/RamTypes.h"
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <memory>
@@ -27,6 +28,79 @@
 
 namespace souffle::interpreter {
 
+/**
+ * Bump-pointer arena of the temporary tuples of the calling thread
+ *
+ * Tuples are released in the reverse order of their allocation, by the end of the
+ * scope in which they were allocated. The memory of the arena is kept for later
+ * scopes, such that an operation evaluated repeatedly allocates no memory once
+ * the arena has grown to fit it.
+ */
+class TupleArena {
+public:
+    /** @brief Return the arena of the calling thread */
+    static TupleArena& local() {
+        static thread_local TupleArena arena;
+        return arena;
+    }
+
+    /** @brief Allocate a tuple, which lives until the enclosing scope ends */
+    RamDomain* allocate(std::size_t size) {
+        if (blocks.empty() || offset + size > blocks[block].size) {
+            nextBlock(size);
+        }
+        RamDomain* tuple = blocks[block].data.get() + offset;
+        offset += size;
+        return tuple;
+    }
+
+    /**
+     * Scope of temporary tuples, releasing the tuples allocated in the arena of the
+     * calling thread since its construction at its destruction
+     */
+    class Scope {
+    public:
+        Scope() : arena(local()), block(arena.block), offset(arena.offset) {}
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope() {
+            arena.block = block;
+            arena.offset = offset;
+        }
+
+    private:
+        TupleArena& arena;
+        std::size_t block;
+        std::size_t offset;
+    };
+
+private:
+    /** Number of values of a block, unless a larger tuple is allocated */
+    static constexpr std::size_t BLOCK_SIZE = 4096;
+
+    struct Block {
+        Own<RamDomain[]> data;
+        std::size_t size;
+    };
+
+    /** Move to the next block which fits a tuple, inserting one if there is none */
+    void nextBlock(std::size_t size) {
+        std::size_t next = blocks.empty() ? 0 : block + 1;
+        if (next == blocks.size() || blocks[next].size < size) {
+            std::size_t capacity = std::max(BLOCK_SIZE, size);
+            blocks.insert(blocks.begin() + next, Block{Own<RamDomain[]>(new RamDomain[capacity]), capacity});
+        }
+        block = next;
+        offset = 0;
+    }
+
+    std::vector<Block> blocks;
+    /** Block and offset of the next tuple */
+    std::size_t block = 0;
+    std::size_t offset = 0;
+};
+
 /**
  * Evaluation context for Interpreter operations
  */
@@ -38,7 +112,8 @@ public:
 
     /** This constructor is used when program enter a new scope.
      * Only Subroutine value needs to be copied */
-    Context(Context& ctxt) : returnValues(ctxt.returnValues), args(ctxt.args) {}
+    Context(Context& ctxt)
+            : data(ctxt.data.size()), returnValues(ctxt.returnValues), args(ctxt.args) {}
     virtual ~Context() = default;
 
     const RamDomain*& operator[](std::size_t index) {
@@ -52,14 +127,10 @@ public:
         return data[index];
     }
 
-    /** @brief Allocate a tuple.
-     *  allocatedDataContainer has the ownership of those tuples. */
+    /** @brief Allocate a temporary tuple.
+     *  It lives in the arena of the calling thread until the enclosing TupleArena::Scope ends. */
     RamDomain* allocateNewTuple(std::size_t size) {
-        Own<RamDomain[]> newTuple(new RamDomain[size]);
-        allocatedDataContainer.push_back(std::move(newTuple));
-
-        // Return the reference as raw pointer.
-        return allocatedDataContainer.back().get();
+        return TupleArena::local().allocate(size);
     }
 
     /** @brief Get subroutine return value */
@@ -116,8 +187,6 @@ private:
     std::vector<RamDomain>* returnValues = nullptr;
     /** @brief Subroutine arguments */
     const std::vector<RamDomain>* args = nullptr;
-    /** @bref Allocated data */
-    VecOwn<RamDomain[]> allocatedDataContainer;
     /** @brief Views */
     VecOwn<ViewWrapper> views;
 };
@@ -0,0 +1,430 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file DynamicBTree.h
+ *
+ * A B+-tree of tuples whose arity is only known at runtime.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include "souffle/utility/Types.h"
+#include "souffle/utility/span.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace souffle::interpreter {
+
+/**
+ * A set of tuples of an arity given at runtime, stored in a B+-tree.
+ *
+ * The keys of a node are stored contiguously, each occupying arity consecutive
+ * columns, and are ordered lexicographically. The leaves are linked, such that
+ * ranges are scanned without revisiting the inner nodes. Nodes are only released
+ * when the tree is cleared.
+ *
+ * Optionally, each tuple carries a payload of a fixed number of columns, which is not part
+ * of its key. The payloads are stored in the leaves, parallel to the keys, and a key keeps
+ * the lexicographically least payload inserted for it.
+ *
+ * Insertions are serialised by a lock. Reads are not synchronised and must not run
+ * concurrently with insertions, which is the case for the relations of the interpreter.
+ */
+class DynamicBTree {
+    struct Node {
+        Node(bool leaf, std::size_t capacity, std::size_t arity, std::size_t payloadArity)
+                : leaf(leaf), keys((capacity + 1) * std::max<std::size_t>(arity, 1)) {
+            if (leaf) {
+                payloads.resize((capacity + 1) * payloadArity);
+            } else {
+                children.reserve(capacity + 2);
+            }
+        }
+
+        bool leaf;
+
+        // the number of keys of the node
+        std::size_t count = 0;
+
+        // the keys of the node, with room for one key above the capacity before a split; nullary
+        // keys share a column, so that each key has an address
+        std::vector<RamDomain> keys;
+
+        // the payloads of the keys of a leaf
+        std::vector<RamDomain> payloads;
+
+        // the count + 1 children of an inner node; the keys of children[i + 1] are not less
+        // than keys[i], the keys of children[i] are less than keys[i]
+        std::vector<Node*> children;
+
+        // the next leaf
+        Node* next = nullptr;
+    };
+
+public:
+    /**
+     * An iterator over the tuples of the tree in ascending order, yielding spans of its arity.
+     * A default constructed iterator marks the end of the tree.
+     */
+    class iterator {
+        const Node* node = nullptr;
+        std::size_t pos = 0;
+        std::size_t arity = 0;
+        std::size_t payloadArity = 0;
+
+    public:
+        iterator() = default;
+        iterator(const Node* node, std::size_t pos, std::size_t arity, std::size_t payloadArity)
+                : node(node), pos(pos), arity(arity), payloadArity(payloadArity) {
+            if (node != nullptr && pos == node->count) {
+                this->node = node->next;
+                this->pos = 0;
+            }
+        }
+
+        span<const RamDomain> operator*() const {
+            return {node->keys.data() + pos * arity, arity};
+        }
+
+        span<const RamDomain> payload() const {
+            return {node->payloads.data() + pos * payloadArity, payloadArity};
+        }
+
+        iterator& operator++() {
+            if (++pos == node->count) {
+                node = node->next;
+                pos = 0;
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return node == other.node && pos == other.pos;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    DynamicBTree(std::size_t arity, std::size_t payloadArity = 0)
+            : arity(arity), payloadArity(payloadArity), capacity(getCapacity(arity)), separator(arity) {}
+
+    DynamicBTree(const DynamicBTree&) = delete;
+    DynamicBTree& operator=(const DynamicBTree&) = delete;
+
+    std::size_t getArity() const {
+        return arity;
+    }
+
+    std::size_t getPayloadArity() const {
+        return payloadArity;
+    }
+
+    bool empty() const {
+        return numTuples == 0;
+    }
+
+    std::size_t size() const {
+        return numTuples;
+    }
+
+    /**
+     * Compares two tuples lexicographically, returning -1, 0 or 1.
+     */
+    int compare(const RamDomain* a, const RamDomain* b) const {
+        for (std::size_t i = 0; i < arity; ++i) {
+            if (a[i] != b[i]) {
+                return a[i] < b[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * Inserts a tuple with the given payload, which must be given if the tree has payloads.
+     * Returns whether the tuple has not been present or its payload has been lowered.
+     */
+    bool insert(const RamDomain* tuple, const RamDomain* payload = nullptr) {
+        assert((payloadArity == 0 || payload != nullptr) && "payload required");
+        std::lock_guard<std::mutex> guard(lock);
+        if (root == nullptr) {
+            root = createNode(true);
+        }
+
+        // descend to the leaf, recording the path
+        std::array<std::pair<Node*, std::size_t>, MAX_HEIGHT> path;
+        std::size_t height = 0;
+        Node* node = root;
+        while (!node->leaf) {
+            std::size_t pos = search(node, tuple, true);
+            assert(height < MAX_HEIGHT && "tree too high");
+            path[height++] = {node, pos};
+            node = node->children[pos];
+        }
+        std::size_t pos = search(node, tuple, false);
+        if (pos < node->count && compare(key(node, pos), tuple) == 0) {
+            RamDomain* old = getPayload(node, pos);
+            if (!std::lexicographical_compare(payload, payload + payloadArity, old, old + payloadArity)) {
+                return false;
+            }
+            std::copy_n(payload, payloadArity, old);
+            return true;
+        }
+        std::copy_backward(
+                getPayload(node, pos), getPayload(node, node->count), getPayload(node, node->count + 1));
+        std::copy_n(payload, payloadArity, getPayload(node, pos));
+        insertKey(node, pos, tuple);
+        ++numTuples;
+
+        // split overfull nodes bottom-up
+        while (node->count > capacity) {
+            Node* right = node->leaf ? splitLeaf(node) : splitInner(node);
+            if (height == 0) {
+                root = createNode(false);
+                root->children.push_back(node);
+                root->children.push_back(right);
+                insertKey(root, 0, separator.data());
+                break;
+            }
+            Node* parent = path[height - 1].first;
+            std::size_t childPos = path[height - 1].second;
+            --height;
+            insertKey(parent, childPos, separator.data());
+            parent->children.insert(parent->children.begin() + childPos + 1, right);
+            node = parent;
+        }
+        return true;
+    }
+
+    bool contains(const RamDomain* tuple) const {
+        return find(tuple) != end();
+    }
+
+    /**
+     * Obtains an iterator to the given tuple, or the end if it is not present.
+     */
+    iterator find(const RamDomain* tuple) const {
+        auto pos = lower_bound(tuple);
+        return pos != end() && compare((*pos).data(), tuple) == 0 ? pos : end();
+    }
+
+    iterator begin() const {
+        return {getFirstLeaf(), 0, arity, payloadArity};
+    }
+
+    iterator end() const {
+        return {};
+    }
+
+    /**
+     * Obtains an iterator to the first tuple not less than the given tuple.
+     */
+    iterator lower_bound(const RamDomain* tuple) const {
+        if (root == nullptr) {
+            return end();
+        }
+        const Node* leaf = findLeaf(tuple);
+        return {leaf, search(leaf, tuple, false), arity, payloadArity};
+    }
+
+    /**
+     * Obtains an iterator to the first tuple greater than the given tuple.
+     */
+    iterator upper_bound(const RamDomain* tuple) const {
+        if (root == nullptr) {
+            return end();
+        }
+        const Node* leaf = findLeaf(tuple);
+        return {leaf, search(leaf, tuple, true), arity, payloadArity};
+    }
+
+    /**
+     * Splits the tree into at most the given number of ranges of consecutive leaves.
+     */
+    std::vector<std::pair<iterator, iterator>> partition(std::size_t count) const {
+        std::vector<std::pair<iterator, iterator>> res;
+        std::vector<const Node*> leaves;
+        for (const Node* leaf = getFirstLeaf(); leaf != nullptr; leaf = leaf->next) {
+            leaves.push_back(leaf);
+        }
+        count = std::max<std::size_t>(std::min(count, leaves.size()), 1);
+        std::size_t first = 0;
+        for (std::size_t i = 1; i <= count && first < leaves.size(); ++i) {
+            std::size_t last = leaves.size() * i / count;
+            res.emplace_back(iterator(leaves[first], 0, arity, payloadArity),
+                    last < leaves.size() ? iterator(leaves[last], 0, arity, payloadArity) : end());
+            first = last;
+        }
+        return res;
+    }
+
+    /**
+     * Approximate number of bytes occupied by the nodes of the tree.
+     */
+    std::size_t getMemoryUsage() const {
+        return memoryUsage;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> guard(lock);
+        nodes.clear();
+        root = nullptr;
+        numTuples = 0;
+        memoryUsage = 0;
+    }
+
+private:
+    // The number of bytes of the keys of a node, unless it has less than MIN_CAPACITY keys
+    static constexpr std::size_t NODE_SIZE = 4096;
+
+    static constexpr std::size_t MIN_CAPACITY = 16;
+
+    // The maximal height of the tree, which is never reached as nodes are at least half full
+    static constexpr std::size_t MAX_HEIGHT = 64;
+
+    static std::size_t getCapacity(std::size_t arity) {
+        return std::max(MIN_CAPACITY, NODE_SIZE / (std::max<std::size_t>(arity, 1) * sizeof(RamDomain)));
+    }
+
+    Node* createNode(bool leaf) {
+        nodes.push_back(mk<Node>(leaf, capacity, arity, payloadArity));
+        Node* node = nodes.back().get();
+        memoryUsage += sizeof(Node) +
+                       (node->keys.capacity() + node->payloads.capacity()) * sizeof(RamDomain) +
+                       node->children.capacity() * sizeof(Node*);
+        return node;
+    }
+
+    RamDomain* key(Node* node, std::size_t pos) const {
+        return node->keys.data() + pos * arity;
+    }
+
+    const RamDomain* key(const Node* node, std::size_t pos) const {
+        return node->keys.data() + pos * arity;
+    }
+
+    RamDomain* getPayload(Node* node, std::size_t pos) const {
+        return node->payloads.data() + pos * payloadArity;
+    }
+
+    /**
+     * Obtains the position of the first key of the node which is not less than the tuple,
+     * or greater than the tuple if strict.
+     */
+    std::size_t search(const Node* node, const RamDomain* tuple, bool strict) const {
+        std::size_t low = 0;
+        std::size_t high = node->count;
+        while (low < high) {
+            std::size_t mid = low + (high - low) / 2;
+            int cmp = compare(key(node, mid), tuple);
+            if (cmp < 0 || (strict && cmp == 0)) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+    const Node* getFirstLeaf() const {
+        if (root == nullptr) {
+            return nullptr;
+        }
+        const Node* node = root;
+        while (!node->leaf) {
+            node = node->children.front();
+        }
+        return node;
+    }
+
+    /**
+     * Obtains the leaf whose keys enclose the given tuple.
+     */
+    const Node* findLeaf(const RamDomain* tuple) const {
+        const Node* node = root;
+        while (!node->leaf) {
+            node = node->children[search(node, tuple, true)];
+        }
+        return node;
+    }
+
+    void insertKey(Node* node, std::size_t pos, const RamDomain* tuple) {
+        std::copy_backward(key(node, pos), key(node, node->count), key(node, node->count + 1));
+        std::copy_n(tuple, arity, key(node, pos));
+        ++node->count;
+    }
+
+    /**
+     * Moves the upper half of the keys and payloads of a leaf into a new leaf, whose first key
+     * becomes the separator.
+     */
+    Node* splitLeaf(Node* node) {
+        Node* right = createNode(true);
+        std::size_t mid = node->count / 2;
+        std::copy(key(node, mid), key(node, node->count), key(right, 0));
+        std::copy(getPayload(node, mid), getPayload(node, node->count), getPayload(right, 0));
+        right->count = node->count - mid;
+        node->count = mid;
+        right->next = node->next;
+        node->next = right;
+        std::copy_n(key(right, 0), arity, separator.begin());
+        return right;
+    }
+
+    /**
+     * Moves the upper half of the keys and children of an inner node into a new node;
+     * the key in between becomes the separator.
+     */
+    Node* splitInner(Node* node) {
+        Node* right = createNode(false);
+        std::size_t mid = node->count / 2;
+        std::copy_n(key(node, mid), arity, separator.begin());
+        std::copy(key(node, mid + 1), key(node, node->count), key(right, 0));
+        right->count = node->count - mid - 1;
+        right->children.assign(node->children.begin() + mid + 1, node->children.end());
+        node->children.resize(mid + 1);
+        node->count = mid;
+        return right;
+    }
+
+    // the arity of the tuples
+    const std::size_t arity;
+
+    // the number of columns of the payloads
+    const std::size_t payloadArity;
+
+    // the maximal number of keys of a node
+    const std::size_t capacity;
+
+    // the nodes of the tree
+    VecOwn<Node> nodes;
+
+    Node* root = nullptr;
+
+    std::size_t numTuples = 0;
+
+    std::size_t memoryUsage = 0;
+
+    // the key separating the nodes of the last split
+    std::vector<RamDomain> separator;
+
+    // serialises insertions
+    std::mutex lock;
+};
+
+}  // namespace souffle::interpreter
@@ -36,6 +36,7 @@
 #include "ram/Extend.h"
 #include "ram/False.h"
 #include "ram/Filter.h"
+#include "ram/GroupAggregate.h"
 #include "ram/IO.h"
 #include "ram/IfExists.h"
 #include "ram/IndexAggregate.h"
@@ -43,6 +44,7 @@
 #include "ram/IndexScan.h"
 #include "ram/Insert.h"
 #include "ram/IntrinsicOperator.h"
+#include "ram/LogMemory.h"
 #include "ram/LogRelationTimer.h"
 #include "ram/LogSize.h"
 #include "ram/LogTimer.h"
@@ -86,9 +88,12 @@
 #include "souffle/io/IOSystem.h"
 #include "souffle/io/ReadStream.h"
 #include "souffle/io/WriteStream.h"
+#include "souffle/profile/HardwareCounters.h"
 #include "souffle/profile/Logger.h"
 #include "souffle/profile/ProfileEvent.h"
+#include "souffle/profile/ProfileSampler.h"
 #include "souffle/utility/EvaluatorUtil.h"
+#include "souffle/utility/Iteration.h"
 #include "souffle/utility/MiscUtil.h"
 #include "souffle/utility/ParallelUtil.h"
 #include "souffle/utility/StringUtil.h"
@@ -137,11 +142,18 @@ namespace souffle::interpreter {
 
 namespace {
 constexpr RamDomain RAM_BIT_SHIFT_MASK = RAM_DOMAIN_SIZE - 1;
+
+/** Number of values a batch of tuples holds, which limits the tuples of a batch of large arity */
+constexpr std::size_t BATCH_VALUES = 512;
+
+/** Number of tuples of a batch */
+constexpr std::size_t BATCH_SIZE = 64;
 }
 
 Engine::Engine(ram::TranslationUnit& tUnit)
         : profileEnabled(Global::config().has("profile")),
           frequencyCounterEnabled(Global::config().has("profile-frequency")),
+          samplingEnabled(profileEnabled && Global::config().has("profile-sampling")),
           isProvenance(Global::config().has("provenance")),
           numOfThreads(std::stoi(Global::config().get("jobs"))), tUnit(tUnit),
           isa(tUnit.getAnalysis<ram::analysis::IndexAnalysis>()) {
@@ -150,6 +162,12 @@ Engine::Engine(ram::TranslationUnit& tUnit)
         omp_set_num_threads(numOfThreads);
     }
 #endif
+    if (Global::config().has("memory-budget")) {
+        std::string directory = Global::config().has("spill-dir") ? Global::config().get("spill-dir")
+                                                                   : SpillManager::getDefaultDirectory();
+        spillManager = mk<SpillManager>(
+                SpillManager::parseSize(Global::config().get("memory-budget")), std::move(directory));
+    }
 }
 
 Engine::RelationHandle& Engine::getRelationHandle(const std::size_t idx) {
@@ -198,14 +216,25 @@ void Engine::createRelation(const ram::Relation& id, const std::size_t idx) {
 
     if (id.getRepresentation() == RelationRepresentation::EQREL) {
         res = createEqrelRelation(id, isa->getIndexSelection(id.getName()));
+    } else if (id.getRepresentation() == RelationRepresentation::MIN) {
+        res = createLatticeRelation(id, isa->getIndexSelection(id.getName()));
     } else {
-        if (isProvenance) {
+        if (isProvenance && hasCompactProvenance()) {
+            res = createCompactProvenanceRelation(id, isa->getIndexSelection(id.getName()));
+        } else if (isProvenance) {
             res = createProvenanceRelation(id, isa->getIndexSelection(id.getName()));
+        } else if (isBrie(id)) {
+            res = createBrieRelation(id, isa->getIndexSelection(id.getName()));
         } else {
             res = createBTreeRelation(id, isa->getIndexSelection(id.getName()));
         }
     }
     relations[idx] = mk<RelationHandle>(std::move(res));
+
+    // Equivalence relations are represented by a union-find and cannot be spilled tuple-wise
+    if (spillManager != nullptr && id.getRepresentation() != RelationRepresentation::EQREL) {
+        spillManager->registerRelation(idx, relations[idx].get());
+    }
 }
 
 const std::vector<void*>& Engine::loadDLL() {
@@ -274,6 +303,11 @@ void Engine::executeMain() {
 
     Context ctxt;
 
+    if (spillManager != nullptr) {
+        spillManager->start();
+        spillManager->acquire(mainRelations);
+    }
+
     if (!profileEnabled) {
         Context ctxt;
         execute(main.get(), ctxt);
@@ -289,6 +323,12 @@ void Engine::executeMain() {
         });
         // Enable profiling for execution of main
         ProfileEventSingleton::instance().startTimer();
+        if (samplingEnabled) {
+            ProfileSampler::instance().start(std::stoul(Global::config().get("profile-sampling")));
+        }
+        if (Global::config().has("profile-counters")) {
+            HardwareCounters::instance().enable();
+        }
         ProfileEventSingleton::instance().makeTimeEvent("@time;starttime");
         // Store configuration
         for (const auto& cur : Global::config().data()) {
@@ -299,7 +339,9 @@ void Engine::executeMain() {
         for (auto rel : tUnit.getProgram().getRelations()) {
             if (rel->getName()[0] != '@') {
                 ++relationCount;
-                reads[rel->getName()] = 0;
+                if (!samplingEnabled) {
+                    reads[rel->getName()] = 0;
+                }
             }
         }
         ProfileEventSingleton::instance().makeConfigRecord("relationCount", std::to_string(relationCount));
@@ -311,6 +353,7 @@ void Engine::executeMain() {
 
         Context ctxt;
         execute(main.get(), ctxt);
+        ProfileSampler::instance().stop();
         ProfileEventSingleton::instance().stopTimer();
         for (auto const& cur : frequencies) {
             for (std::size_t i = 0; i < cur.second.size(); ++i) {
@@ -322,6 +365,12 @@ void Engine::executeMain() {
                     "@relation-reads;" + cur.first, cur.second, 0);
         }
     }
+
+    // Relations remain accessible through the program interface, hence nothing is spilled anymore
+    if (spillManager != nullptr) {
+        spillManager->release(mainRelations);
+        spillManager->stop();
+    }
     SignalHandler::instance()->reset();
 }
 
@@ -331,10 +380,12 @@ void Engine::generateIR() {
     if (subroutine.empty()) {
         for (const auto& sub : program.getSubroutines()) {
             subroutine.push_back(generator.generateTree(*sub.second));
+            subroutineRelations.push_back(generator.getAccessedRelations());
         }
     }
     if (main == nullptr) {
         main = generator.generateTree(program.getMain());
+        mainRelations = generator.getAccessedRelations();
     }
 }
 
@@ -343,10 +394,20 @@ void Engine::executeSubroutine(
     Context ctxt;
     ctxt.setReturnValues(ret);
     ctxt.setArguments(args);
-    generateIR();
-    const ram::Program& program = tUnit.getProgram();
-    auto subs = program.getSubroutines();
-    std::size_t i = distance(subs.begin(), subs.find(name));
+    std::size_t i;
+    {
+        // the tree is generated once for all callers
+        std::lock_guard<std::mutex> guard(subroutineLock);
+        generateIR();
+        const ram::Program& program = tUnit.getProgram();
+        auto subs = program.getSubroutines();
+        i = distance(subs.begin(), subs.find(name));
+        if (i == subs.size()) {
+            fatal("unknown subroutine");
+        }
+    }
+    // relations are only spilled during the evaluation of the main program, hence those of the
+    // subroutines called through the program interface are resident
     execute(subroutine[i].get(), ctxt);
 }
 
@@ -379,9 +440,10 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
     ();            \
     }
 
+// Brie relations pass tuples in buffers which may be wider than the relation
 #define TUPLE_COPY_FROM(dst, src)     \
-    assert(dst.size() == src.size()); \
-    std::copy_n(src.begin(), dst.size(), dst.begin())
+    assert(dst.size() >= src.size()); \
+    std::copy_n(src.begin(), src.size(), dst.begin())
 
 #define CAL_SEARCH_BOUND(superInfo, low, high)                          \
     /** Unbounded and Constant */                                       \
@@ -478,7 +540,7 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
         getSymbolTable().decode(EVAL_CHILD(RamDomain, 0)));
             // clang-format on
 
-            const auto& args = cur.getArguments();
+            const auto& args = shadow.getChildren();
             switch (cur.getOperator()) {
                 /** Unary Functor Operators */
                 case FunctorOp::ORD: return execute(shadow.getChild(0), ctxt);
@@ -622,7 +684,8 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
         ESAC(IntrinsicOperator)
 
         CASE(NestedIntrinsicOperator)
-            auto numArgs = cur.getArguments().size();
+            // the last child is the nested operation
+            auto numArgs = shadow.getChildren().size() - 1;
             auto runNested = [&](auto&& tuple) {
                 ctxt[cur.getTupleId()] = tuple.data();
                 execute(shadow.getChild(numArgs), ctxt);
@@ -649,7 +712,7 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 
             auto fn = reinterpret_cast<void (*)()>(getMethodHandle(name));
             if (fn == nullptr) fatal("cannot find user-defined operator `%s`", name);
-            std::size_t arity = cur.getArguments().size();
+            std::size_t arity = shadow.getChildren().size();
 
             if (cur.isStateful()) {
                 // prepare dynamic call environment
@@ -761,8 +824,7 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
         ESAC(UserDefinedOperator)
 
         CASE(PackRecord)
-            auto values = cur.getArguments();
-            std::size_t arity = values.size();
+            std::size_t arity = shadow.getChildren().size();
             RamDomain data[arity];
             for (std::size_t i = 0; i < arity; ++i) {
                 data[i] = execute(shadow.getChild(i), ctxt);
@@ -822,6 +884,7 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
     ESAC(ProvenanceExistenceCheck)
 
         FOR_EACH_PROVENANCE(PROVENANCE_EXISTENCE_CHECK)
+        FOR_EACH_DYNAMIC_PROVENANCE(PROVENANCE_EXISTENCE_CHECK)
 #undef PROVENANCE_EXISTENCE_CHECK
 
         CASE(Constraint)
@@ -901,6 +964,13 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 #undef COMPARE_EQ_NE
         ESAC(Constraint)
 
+        // fused and typed nodes are evaluated by the functions selected for them by the generator, and
+        // have no RAM counterpart of their own
+        case I_FusedConstraint:
+        case I_FusedOperator: return static_cast<const FusedOperation*>(node)->evaluate(ctxt);
+        case I_TypedConstraint:
+        case I_TypedOperator: return static_cast<const TypedOperation*>(node)->evaluate(ctxt);
+
         CASE(TupleOperation)
             bool result = execute(shadow.getChild(), ctxt);
 
@@ -1023,7 +1093,8 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 
 #define PARALLEL_INDEX_AGGREGATE(Structure, Arity, ...)                \
     CASE(ParallelIndexAggregate, Structure, Arity)                     \
-        return evalParallelIndexAggregate<RelType>(cur, shadow, ctxt); \
+        const auto& rel = *static_cast<RelType*>(shadow.getRelation()); \
+        return evalParallelIndexAggregate(rel, cur, shadow, ctxt);      \
     ESAC(ParallelIndexAggregate)
 
         FOR_EACH(PARALLEL_INDEX_AGGREGATE)
@@ -1037,6 +1108,14 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
         FOR_EACH(INDEX_AGGREGATE)
 #undef INDEX_AGGREGATE
 
+#define GROUP_AGGREGATE(Structure, Arity, ...)                 \
+    CASE(GroupAggregate, Structure, Arity)                     \
+        return evalGroupAggregate<RelType>(cur, shadow, ctxt); \
+    ESAC(GroupAggregate)
+
+        FOR_EACH(GROUP_AGGREGATE)
+#undef GROUP_AGGREGATE
+
         CASE(Break)
             // check condition
             if (execute(shadow.getCondition(), ctxt)) {
@@ -1082,7 +1161,7 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 #undef INSERT
 
         CASE(SubroutineReturn)
-            for (std::size_t i = 0; i < cur.getValues().size(); ++i) {
+            for (std::size_t i = 0; i < shadow.getChildren().size(); ++i) {
                 if (shadow.getChild(i) == nullptr) {
                     ctxt.addReturnValue(0);
                 } else {
@@ -1124,6 +1203,12 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
         ESAC(Exit)
 
         CASE(LogRelationTimer)
+            if (samplingEnabled) {
+                RelationWrapper* relation = shadow.getRelation();
+                ProfileSampler::Scope scope(
+                        cur.getMessage(), getIterationNumber(), [relation]() { return relation->size(); });
+                return execute(shadow.getChild(), ctxt);
+            }
             Logger logger(cur.getMessage(), getIterationNumber(),
                     std::bind(&RelationWrapper::size, shadow.getRelation()));
             return execute(shadow.getChild(), ctxt);
@@ -1150,17 +1235,33 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 #undef CLEAR
 
         CASE(Call)
-            execute(subroutine[shadow.getSubroutineId()].get(), ctxt);
+            const std::size_t id = shadow.getSubroutineId();
+            if (spillManager != nullptr) {
+                spillManager->acquire(subroutineRelations[id]);
+            }
+            execute(subroutine[id].get(), ctxt);
+            if (spillManager != nullptr) {
+                spillManager->release(subroutineRelations[id]);
+            }
             return true;
         ESAC(Call)
 
         CASE(LogSize)
             const auto& rel = *shadow.getRelation();
-            ProfileEventSingleton::instance().makeQuantityEvent(
-                    cur.getMessage(), rel.size(), getIterationNumber());
+            ProfileSampler::instance().makeQuantityEvent(cur.getMessage(), rel.size(), getIterationNumber());
             return true;
         ESAC(LogSize)
 
+        CASE(LogMemory)
+            const auto& rel = *shadow.getRelation();
+            for (std::size_t i = 0; i < rel.getNumberOfIndexes(); ++i) {
+                ProfileEventSingleton::instance().makeQuantityEvent(
+                        cur.getMessage() + shadow.getStructure() + toString(rel.getIndexOrder(i)) + ";",
+                        rel.getIndexMemoryUsage(i), getIterationNumber());
+            }
+            return true;
+        ESAC(LogMemory)
+
         CASE(IO)
             const auto& directive = cur.getDirectives();
             const std::string& op = cur.get("operation");
@@ -1254,7 +1355,7 @@ RamDomain Engine::evalExistenceCheck(const ExistenceCheck& shadow, Context& ctxt
     constexpr std::size_t Arity = Rel::Arity;
     std::size_t viewPos = shadow.getViewId();
 
-    if (profileEnabled && !shadow.isTemp()) {
+    if (profileEnabled && !samplingEnabled && !shadow.isTemp()) {
         reads[shadow.getRelationName()]++;
     }
 
@@ -1299,6 +1400,9 @@ RamDomain Engine::evalProvenanceExistenceCheck(const ProvenanceExistenceCheck& s
     // construct the pattern tuple
     constexpr std::size_t Arity = Rel::Arity;
     const auto& superInfo = shadow.getSuperInst();
+    // the annotations are the last columns of the relation, which is narrower than Arity for
+    // dynamic relations
+    const std::size_t arity = superInfo.first.size();
 
     // for partial we search for lower and upper boundaries
     souffle::Tuple<RamDomain, Arity> low;
@@ -1319,10 +1423,10 @@ RamDomain Engine::evalProvenanceExistenceCheck(const ProvenanceExistenceCheck& s
         high[expr.first] = low[expr.first];
     }
 
-    low[Arity - 2] = MIN_RAM_SIGNED;
-    low[Arity - 1] = MIN_RAM_SIGNED;
-    high[Arity - 2] = MAX_RAM_SIGNED;
-    high[Arity - 1] = MAX_RAM_SIGNED;
+    low[arity - 2] = MIN_RAM_SIGNED;
+    low[arity - 1] = MIN_RAM_SIGNED;
+    high[arity - 2] = MAX_RAM_SIGNED;
+    high[arity - 1] = MAX_RAM_SIGNED;
 
     // obtain view
     std::size_t viewPos = shadow.getViewId();
@@ -1336,11 +1440,15 @@ RamDomain Engine::evalProvenanceExistenceCheck(const ProvenanceExistenceCheck& s
     }
 
     // check whether the height is less than the current height
-    return (*equalRange.begin())[Arity - 1] <= execute(shadow.getChild(), ctxt);
+    return (*equalRange.begin())[arity - 1] <= execute(shadow.getChild(), ctxt);
 }
 
 template <typename Rel>
 RamDomain Engine::evalScan(const Rel& rel, const ram::Scan& cur, const Scan& shadow, Context& ctxt) {
+    if (const auto* plan = shadow.getBatchPlan()) {
+        evalBatch(rel.scan(), cur.getTupleId(), *plan, ctxt);
+        return true;
+    }
     for (const auto& tuple : rel.scan()) {
         ctxt[cur.getTupleId()] = tuple.data();
         if (!execute(shadow.getNestedOperation(), ctxt)) {
@@ -1357,13 +1465,20 @@ RamDomain Engine::evalParallelScan(
 
     auto pStream = rel.partitionScan(numOfThreads);
 
+    Logger* logger = Logger::current();
     PARALLEL_START
+        Logger::ThreadTimer threadTimer(logger);
         Context newCtxt(ctxt);
-        auto viewInfo = viewContext->getViewInfoForNested();
+        const auto& viewInfo = viewContext->getViewInfoForNested();
         for (const auto& info : viewInfo) {
             newCtxt.createView(*getRelationHandle(info[0]), info[1], info[2]);
         }
         pfor(auto it = pStream.begin(); it < pStream.end(); it++) {
+            Logger::ThreadTimer::Chunk chunk(threadTimer);
+            if (const auto* plan = shadow.getBatchPlan()) {
+                evalBatch(*it, cur.getTupleId(), *plan, newCtxt);
+                continue;
+            }
             for (const auto& tuple : *it) {
                 newCtxt[cur.getTupleId()] = tuple.data();
                 if (!execute(shadow.getNestedOperation(), newCtxt)) {
@@ -1387,6 +1502,10 @@ RamDomain Engine::evalIndexScan(const ram::IndexScan& cur, const IndexScan& shad
     std::size_t viewId = shadow.getViewId();
     auto view = Rel::castView(ctxt.getView(viewId));
     // conduct range query
+    if (const auto* plan = shadow.getBatchPlan()) {
+        evalBatch(view->range(low, high), cur.getTupleId(), *plan, ctxt);
+        return true;
+    }
     for (const auto& tuple : view->range(low, high)) {
         ctxt[cur.getTupleId()] = tuple.data();
         if (!execute(shadow.getNestedOperation(), ctxt)) {
@@ -1396,6 +1515,64 @@ RamDomain Engine::evalIndexScan(const ram::IndexScan& cur, const IndexScan& shad
     return true;
 }
 
+template <typename Range>
+bool Engine::evalBatch(const Range& range, std::size_t tupleId, const BatchPlan& plan, Context& ctxt) {
+    const std::size_t arity = plan.arity;
+    const std::size_t capacity = std::min(BATCH_SIZE, BATCH_VALUES / arity);
+    TupleArena::Scope scope;
+    RamDomain* batch = ctxt.allocateNewTuple(capacity * arity);
+    std::size_t selection[BATCH_SIZE];
+
+    // evaluate a condition for the tuple of the context, calling fused and typed constraints without
+    // dispatch
+    auto test = [&](const Node* condition) -> bool {
+        if (condition->getType() == I_FusedConstraint) {
+            return static_cast<const FusedOperation*>(condition)->evaluate(ctxt);
+        }
+        if (condition->getType() == I_TypedConstraint) {
+            return static_cast<const TypedOperation*>(condition)->evaluate(ctxt);
+        }
+        return execute(condition, ctxt);
+    };
+
+    auto it = range.begin();
+    auto end = range.end();
+    while (it != end) {
+        // fill the batch with the tuples satisfying the first condition; they are copied since
+        // iterators of some structures reuse the storage of their tuple
+        std::size_t selected = 0;
+        for (; selected < capacity && it != end; ++it) {
+            const auto& tuple = *it;
+            ctxt[tupleId] = tuple.data();
+            if (test(plan.conditions.front())) {
+                std::copy_n(tuple.data(), arity, batch + selected * arity);
+                selection[selected] = selected;
+                ++selected;
+            }
+        }
+
+        // narrow the selection by each further condition
+        for (std::size_t c = 1; c < plan.conditions.size() && selected > 0; ++c) {
+            std::size_t kept = 0;
+            for (std::size_t i = 0; i < selected; ++i) {
+                ctxt[tupleId] = batch + selection[i] * arity;
+                if (test(plan.conditions[c])) {
+                    selection[kept++] = selection[i];
+                }
+            }
+            selected = kept;
+        }
+
+        for (std::size_t i = 0; i < selected; ++i) {
+            ctxt[tupleId] = batch + selection[i] * arity;
+            if (!execute(plan.nested, ctxt)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 template <typename Rel>
 RamDomain Engine::evalParallelIndexScan(
         const Rel& rel, const ram::ParallelIndexScan& cur, const ParallelIndexScan& shadow, Context& ctxt) {
@@ -1410,13 +1587,20 @@ RamDomain Engine::evalParallelIndexScan(
 
     std::size_t indexPos = shadow.getViewId();
     auto pStream = rel.partitionRange(indexPos, low, high, numOfThreads);
+    Logger* logger = Logger::current();
     PARALLEL_START
+        Logger::ThreadTimer threadTimer(logger);
         Context newCtxt(ctxt);
-        auto viewInfo = viewContext->getViewInfoForNested();
+        const auto& viewInfo = viewContext->getViewInfoForNested();
         for (const auto& info : viewInfo) {
             newCtxt.createView(*getRelationHandle(info[0]), info[1], info[2]);
         }
         pfor(auto it = pStream.begin(); it < pStream.end(); it++) {
+            Logger::ThreadTimer::Chunk chunk(threadTimer);
+            if (const auto* plan = shadow.getBatchPlan()) {
+                evalBatch(*it, cur.getTupleId(), *plan, newCtxt);
+                continue;
+            }
             for (const auto& tuple : *it) {
                 newCtxt[cur.getTupleId()] = tuple.data();
                 if (!execute(shadow.getNestedOperation(), newCtxt)) {
@@ -1448,13 +1632,16 @@ RamDomain Engine::evalParallelIfExists(
     auto viewContext = shadow.getViewContext();
 
     auto pStream = rel.partitionScan(numOfThreads);
-    auto viewInfo = viewContext->getViewInfoForNested();
+    const auto& viewInfo = viewContext->getViewInfoForNested();
+    Logger* logger = Logger::current();
     PARALLEL_START
+        Logger::ThreadTimer threadTimer(logger);
         Context newCtxt(ctxt);
         for (const auto& info : viewInfo) {
             newCtxt.createView(*getRelationHandle(info[0]), info[1], info[2]);
         }
         pfor(auto it = pStream.begin(); it < pStream.end(); it++) {
+            Logger::ThreadTimer::Chunk chunk(threadTimer);
             for (const auto& tuple : *it) {
                 newCtxt[cur.getTupleId()] = tuple.data();
                 if (execute(shadow.getCondition(), newCtxt)) {
@@ -1494,7 +1681,7 @@ RamDomain Engine::evalParallelIndexIfExists(const Rel& rel, const ram::ParallelI
         const ParallelIndexIfExists& shadow, Context& ctxt) {
     auto viewContext = shadow.getViewContext();
 
-    auto viewInfo = viewContext->getViewInfoForNested();
+    const auto& viewInfo = viewContext->getViewInfoForNested();
 
     // create pattern tuple for range query
     constexpr std::size_t Arity = Rel::Arity;
@@ -1506,12 +1693,15 @@ RamDomain Engine::evalParallelIndexIfExists(const Rel& rel, const ram::ParallelI
     std::size_t indexPos = shadow.getViewId();
     auto pStream = rel.partitionRange(indexPos, low, high, numOfThreads);
 
+    Logger* logger = Logger::current();
     PARALLEL_START
+        Logger::ThreadTimer threadTimer(logger);
         Context newCtxt(ctxt);
         for (const auto& info : viewInfo) {
             newCtxt.createView(*getRelationHandle(info[0]), info[1], info[2]);
         }
         pfor(auto it = pStream.begin(); it < pStream.end(); it++) {
+            Logger::ThreadTimer::Chunk chunk(threadTimer);
             for (const auto& tuple : *it) {
                 newCtxt[cur.getTupleId()] = tuple.data();
                 if (execute(shadow.getCondition(), newCtxt)) {
@@ -1525,50 +1715,80 @@ RamDomain Engine::evalParallelIndexIfExists(const Rel& rel, const ram::ParallelI
     return true;
 }
 
-template <typename Aggregate, typename Iter>
-RamDomain Engine::evalAggregate(const Aggregate& aggregate, const Node& filter, const Node* expression,
-        const Node& nestedOperation, const Iter& ranges, Context& ctxt) {
-    bool shouldRunNested = false;
-
-    // initialize result
-    RamDomain res = 0;
-
-    // Use for calculating mean.
-    std::pair<RamFloat, RamFloat> accumulateMean;
+Engine::AggregateState Engine::initAggregate(AggregateOp function) {
+    AggregateState state;
+    switch (function) {
+        case AggregateOp::MIN: state.res = ramBitCast(MAX_RAM_SIGNED); break;
+        case AggregateOp::UMIN: state.res = ramBitCast(MAX_RAM_UNSIGNED); break;
+        case AggregateOp::FMIN: state.res = ramBitCast(MAX_RAM_FLOAT); break;
 
-    switch (aggregate.getFunction()) {
-        case AggregateOp::MIN: res = ramBitCast(MAX_RAM_SIGNED); break;
-        case AggregateOp::UMIN: res = ramBitCast(MAX_RAM_UNSIGNED); break;
-        case AggregateOp::FMIN: res = ramBitCast(MAX_RAM_FLOAT); break;
-
-        case AggregateOp::MAX: res = ramBitCast(MIN_RAM_SIGNED); break;
-        case AggregateOp::UMAX: res = ramBitCast(MIN_RAM_UNSIGNED); break;
-        case AggregateOp::FMAX: res = ramBitCast(MIN_RAM_FLOAT); break;
+        case AggregateOp::MAX: state.res = ramBitCast(MIN_RAM_SIGNED); break;
+        case AggregateOp::UMAX: state.res = ramBitCast(MIN_RAM_UNSIGNED); break;
+        case AggregateOp::FMAX: state.res = ramBitCast(MIN_RAM_FLOAT); break;
 
         case AggregateOp::SUM:
-            res = ramBitCast(static_cast<RamSigned>(0));
-            shouldRunNested = true;
+            state.res = ramBitCast(static_cast<RamSigned>(0));
+            state.shouldRunNested = true;
             break;
         case AggregateOp::USUM:
-            res = ramBitCast(static_cast<RamUnsigned>(0));
-            shouldRunNested = true;
+            state.res = ramBitCast(static_cast<RamUnsigned>(0));
+            state.shouldRunNested = true;
             break;
         case AggregateOp::FSUM:
-            res = ramBitCast(static_cast<RamFloat>(0));
-            shouldRunNested = true;
+            state.res = ramBitCast(static_cast<RamFloat>(0));
+            state.shouldRunNested = true;
             break;
 
-        case AggregateOp::MEAN:
-            res = 0;
-            accumulateMean = {0, 0};
-            break;
+        case AggregateOp::MEAN: state.res = 0; break;
 
         case AggregateOp::COUNT:
-            res = 0;
-            shouldRunNested = true;
+            state.res = 0;
+            state.shouldRunNested = true;
             break;
     }
+    return state;
+}
+
+/** Fold a value into an aggregate result; a partial result is folded in like a single value */
+static RamDomain foldAggregate(AggregateOp function, RamDomain res, RamDomain val) {
+    switch (function) {
+        case AggregateOp::MIN: return std::min(res, val);
+        case AggregateOp::FMIN:
+            return ramBitCast(std::min(ramBitCast<RamFloat>(res), ramBitCast<RamFloat>(val)));
+        case AggregateOp::UMIN:
+            return ramBitCast(std::min(ramBitCast<RamUnsigned>(res), ramBitCast<RamUnsigned>(val)));
+
+        case AggregateOp::MAX: return std::max(res, val);
+        case AggregateOp::FMAX:
+            return ramBitCast(std::max(ramBitCast<RamFloat>(res), ramBitCast<RamFloat>(val)));
+        case AggregateOp::UMAX:
+            return ramBitCast(std::max(ramBitCast<RamUnsigned>(res), ramBitCast<RamUnsigned>(val)));
+
+        case AggregateOp::COUNT:
+        case AggregateOp::SUM: return res + val;
+        case AggregateOp::FSUM: return ramBitCast(ramBitCast<RamFloat>(res) + ramBitCast<RamFloat>(val));
+        case AggregateOp::USUM:
+            return ramBitCast(ramBitCast<RamUnsigned>(res) + ramBitCast<RamUnsigned>(val));
+
+        case AggregateOp::MEAN: fatal("mean is accumulated separately");
+    }
+    UNREACHABLE_BAD_CASE_ANALYSIS
+}
 
+void Engine::combineAggregate(AggregateOp function, AggregateState& into, const AggregateState& from) {
+    into.shouldRunNested = into.shouldRunNested || from.shouldRunNested;
+    if (function == AggregateOp::MEAN) {
+        into.meanSum += from.meanSum;
+        into.meanCount += from.meanCount;
+    } else {
+        into.res = foldAggregate(function, into.res, from.res);
+    }
+}
+
+template <typename Aggregate, typename Iter>
+void Engine::accumulateAggregate(const Aggregate& aggregate, const Node& filter, const Node* expression,
+        const Iter& ranges, AggregateState& state, Context& ctxt) {
+    const AggregateOp function = aggregate.getFunction();
     for (const auto& tuple : ranges) {
         ctxt[aggregate.getTupleId()] = tuple.data();
 
@@ -1576,11 +1796,11 @@ RamDomain Engine::evalAggregate(const Aggregate& aggregate, const Node& filter,
             continue;
         }
 
-        shouldRunNested = true;
+        state.shouldRunNested = true;
 
         // count is a special case.
-        if (aggregate.getFunction() == AggregateOp::COUNT) {
-            ++res;
+        if (function == AggregateOp::COUNT) {
+            ++state.res;
             continue;
         }
 
@@ -1588,81 +1808,94 @@ RamDomain Engine::evalAggregate(const Aggregate& aggregate, const Node& filter,
         assert(expression);  // only case where this is null is `COUNT`
         RamDomain val = execute(expression, ctxt);
 
-        switch (aggregate.getFunction()) {
-            case AggregateOp::MIN: res = std::min(res, val); break;
-            case AggregateOp::FMIN:
-                res = ramBitCast(std::min(ramBitCast<RamFloat>(res), ramBitCast<RamFloat>(val)));
-                break;
-            case AggregateOp::UMIN:
-                res = ramBitCast(std::min(ramBitCast<RamUnsigned>(res), ramBitCast<RamUnsigned>(val)));
-                break;
-
-            case AggregateOp::MAX: res = std::max(res, val); break;
-            case AggregateOp::FMAX:
-                res = ramBitCast(std::max(ramBitCast<RamFloat>(res), ramBitCast<RamFloat>(val)));
-                break;
-            case AggregateOp::UMAX:
-                res = ramBitCast(std::max(ramBitCast<RamUnsigned>(res), ramBitCast<RamUnsigned>(val)));
-                break;
-
-            case AggregateOp::SUM: res += val; break;
-            case AggregateOp::FSUM:
-                res = ramBitCast(ramBitCast<RamFloat>(res) + ramBitCast<RamFloat>(val));
-                break;
-            case AggregateOp::USUM:
-                res = ramBitCast(ramBitCast<RamUnsigned>(res) + ramBitCast<RamUnsigned>(val));
-                break;
-
-            case AggregateOp::MEAN:
-                accumulateMean.first += ramBitCast<RamFloat>(val);
-                accumulateMean.second++;
-                break;
-
-            case AggregateOp::COUNT: fatal("This should never be executed");
+        if (function == AggregateOp::MEAN) {
+            state.meanSum += ramBitCast<RamFloat>(val);
+            state.meanCount++;
+        } else {
+            state.res = foldAggregate(function, state.res, val);
         }
     }
+}
 
-    if (aggregate.getFunction() == AggregateOp::MEAN && accumulateMean.second != 0) {
-        res = ramBitCast(accumulateMean.first / accumulateMean.second);
+void Engine::completeAggregate(AggregateOp function, AggregateState& state) {
+    if (function == AggregateOp::MEAN && state.meanCount != 0) {
+        state.res = ramBitCast(state.meanSum / state.meanCount);
     }
+}
+
+template <typename Aggregate>
+RamDomain Engine::finishAggregate(
+        const Aggregate& aggregate, const Node& nestedOperation, AggregateState& state, Context& ctxt) {
+    completeAggregate(aggregate.getFunction(), state);
 
     // write result to environment
     souffle::Tuple<RamDomain, 1> tuple;
-    tuple[0] = res;
+    tuple[0] = state.res;
     ctxt[aggregate.getTupleId()] = tuple.data();
 
-    if (!shouldRunNested) {
+    if (!state.shouldRunNested) {
         return true;
     } else {
         return execute(&nestedOperation, ctxt);
     }
 }
-template <typename Rel>
-RamDomain Engine::evalParallelAggregate(
-        const Rel& rel, const ram::ParallelAggregate& cur, const ParallelAggregate& shadow, Context& ctxt) {
-    // TODO (rdowavic): make parallel
-    auto viewContext = shadow.getViewContext();
+
+template <typename Aggregate, typename Iter>
+RamDomain Engine::evalAggregate(const Aggregate& aggregate, const Node& filter, const Node* expression,
+        const Node& nestedOperation, const Iter& ranges, Context& ctxt) {
+    AggregateState state = initAggregate(aggregate.getFunction());
+    accumulateAggregate(aggregate, filter, expression, ranges, state, ctxt);
+    return finishAggregate(aggregate, nestedOperation, state, ctxt);
+}
+
+template <typename Aggregate, typename Partitions>
+RamDomain Engine::evalPartitionedAggregate(const Aggregate& aggregate, const Node& filter,
+        const Node* expression, const Node& nestedOperation, const Partitions& partitions,
+        ViewContext& viewContext, Context& ctxt) {
+    const AggregateOp function = aggregate.getFunction();
+
+    // each partition is accumulated into its own partial state by some thread
+    std::vector<AggregateState> partials(partitions.size(), initAggregate(function));
+    Logger* logger = Logger::current();
+    PARALLEL_START
+        Logger::ThreadTimer threadTimer(logger);
+        Context newCtxt(ctxt);
+        auto viewInfo = viewContext.getViewInfoForNested();
+        for (const auto& info : viewInfo) {
+            newCtxt.createView(*getRelationHandle(info[0]), info[1], info[2]);
+        }
+        pfor(std::size_t i = 0; i < partitions.size(); i++) {
+            Logger::ThreadTimer::Chunk chunk(threadTimer);
+            accumulateAggregate(aggregate, filter, expression, partitions[i], partials[i], newCtxt);
+        }
+    PARALLEL_END
+
+    // combine the partial states in partition order, which keeps floating-point results
+    // independent of the scheduling
+    AggregateState state = initAggregate(function);
+    for (const auto& partial : partials) {
+        combineAggregate(function, state, partial);
+    }
 
     Context newCtxt(ctxt);
-    auto viewInfo = viewContext->getViewInfoForNested();
+    auto viewInfo = viewContext.getViewInfoForNested();
     for (const auto& info : viewInfo) {
         newCtxt.createView(*getRelationHandle(info[0]), info[1], info[2]);
     }
-    return evalAggregate(
-            cur, *shadow.getCondition(), shadow.getExpr(), *shadow.getNestedOperation(), rel.scan(), newCtxt);
+    return finishAggregate(aggregate, nestedOperation, state, newCtxt);
 }
 
 template <typename Rel>
-RamDomain Engine::evalParallelIndexAggregate(
-        const ram::ParallelIndexAggregate& cur, const ParallelIndexAggregate& shadow, Context& ctxt) {
-    // TODO (rdowavic): make parallel
-    auto viewContext = shadow.getViewContext();
+RamDomain Engine::evalParallelAggregate(
+        const Rel& rel, const ram::ParallelAggregate& cur, const ParallelAggregate& shadow, Context& ctxt) {
+    return evalPartitionedAggregate(cur, *shadow.getCondition(), shadow.getExpr(),
+            *shadow.getNestedOperation(), rel.partitionScan(numOfThreads), *shadow.getViewContext(), ctxt);
+}
 
-    Context newCtxt(ctxt);
-    auto viewInfo = viewContext->getViewInfoForNested();
-    for (const auto& info : viewInfo) {
-        newCtxt.createView(*getRelationHandle(info[0]), info[1], info[2]);
-    }
+template <typename Rel>
+RamDomain Engine::evalParallelIndexAggregate(
+        const Rel& rel, const ram::ParallelIndexAggregate& cur, const ParallelIndexAggregate& shadow,
+        Context& ctxt) {
     // init temporary tuple for this level
     constexpr std::size_t Arity = Rel::Arity;
     const auto& superInfo = shadow.getSuperInst();
@@ -1671,11 +1904,10 @@ RamDomain Engine::evalParallelIndexAggregate(
     souffle::Tuple<RamDomain, Arity> high;
     CAL_SEARCH_BOUND(superInfo, low, high);
 
-    std::size_t viewId = shadow.getViewId();
-    auto view = Rel::castView(newCtxt.getView(viewId));
-
-    return evalAggregate(cur, *shadow.getCondition(), shadow.getExpr(), *shadow.getNestedOperation(),
-            view->range(low, high), newCtxt);
+    std::size_t indexPos = shadow.getViewId();
+    return evalPartitionedAggregate(cur, *shadow.getCondition(), shadow.getExpr(),
+            *shadow.getNestedOperation(), rel.partitionRange(indexPos, low, high, numOfThreads),
+            *shadow.getViewContext(), ctxt);
 }
 
 template <typename Rel>
@@ -1716,6 +1948,62 @@ RamDomain Engine::evalInsert(Rel& rel, const Insert& shadow, Context& ctxt) {
     return true;
 }
 
+template <typename Rel>
+RamDomain Engine::evalGroupAggregate(
+        const ram::GroupAggregate& cur, const GroupAggregate& shadow, Context& ctxt) {
+    constexpr std::size_t Arity = Rel::Arity;
+    const AggregateOp function = cur.getFunction();
+    const auto& positions = shadow.getGroupPositions();
+
+    // scan the whole index, whose order starts with the group columns
+    souffle::Tuple<RamDomain, Arity> low;
+    souffle::Tuple<RamDomain, Arity> high;
+    for (std::size_t i = 0; i < Arity; i++) {
+        low[i] = MIN_RAM_SIGNED;
+        high[i] = MAX_RAM_SIGNED;
+    }
+    std::size_t viewId = shadow.getViewId();
+    auto view = Rel::castView(ctxt.getView(viewId));
+    auto range = view->range(low, high);
+
+    // the tuple of the nested operation holds the result followed by the group columns
+    TupleArena::Scope scope;
+    RamDomain* group = ctxt.allocateNewTuple(positions.size() + 1);
+    auto sameGroup = [&](const auto& tuple) {
+        for (std::size_t i = 0; i < positions.size(); i++) {
+            if (tuple[positions[i]] != group[i + 1]) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    auto it = range.begin();
+    while (it != range.end()) {
+        for (std::size_t i = 0; i < positions.size(); i++) {
+            group[i + 1] = (*it)[positions[i]];
+        }
+        auto groupBegin = it;
+        while (it != range.end() && sameGroup(*it)) {
+            ++it;
+        }
+
+        AggregateState state = initAggregate(function);
+        accumulateAggregate(cur, *shadow.getCondition(), shadow.getExpr(), make_range(groupBegin, it),
+                state, ctxt);
+        completeAggregate(function, state);
+        if (!state.shouldRunNested) {
+            continue;
+        }
+        group[0] = state.res;
+        ctxt[cur.getTupleId()] = group;
+        if (!execute(shadow.getNestedOperation(), ctxt)) {
+            break;
+        }
+    }
+    return true;
+}
+
 template <typename Rel>
 RamDomain Engine::evalGuardedInsert(Rel& rel, const GuardedInsert& shadow, Context& ctxt) {
     if (!execute(shadow.getCondition(), ctxt)) {
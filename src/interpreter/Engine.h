@@ -16,12 +16,14 @@
 
 #pragma once
 
+#include "AggregateOp.h"
 #include "Global.h"
 #include "interpreter/Context.h"
 #include "interpreter/Generator.h"
 #include "interpreter/Index.h"
 #include "interpreter/Node.h"
 #include "interpreter/Relation.h"
+#include "interpreter/SpillManager.h"
 #include "ram/TranslationUnit.h"
 #include "ram/analysis/Index.h"
 #include "souffle/RamTypes.h"
@@ -33,6 +35,8 @@
 #include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 #ifdef _OPENMP
@@ -57,7 +61,7 @@ public:
 
     /** @brief Execute the main program */
     void executeMain();
-    /** @brief Execute the subroutine program */
+    /** @brief Execute the subroutine program; subroutines may be executed concurrently */
     void executeSubroutine(
             const std::string& name, const std::vector<RamDomain>& args, std::vector<RamDomain>& ret);
 
@@ -118,6 +122,10 @@ private:
     RamDomain evalParallelIndexScan(const Rel& rel, const ram::ParallelIndexScan& cur,
             const ParallelIndexScan& shadow, Context& ctxt);
 
+    /** Evaluate the tuples of a range a batch at a time, returning false if the nested operation breaks */
+    template <typename Range>
+    bool evalBatch(const Range& range, std::size_t tupleId, const BatchPlan& plan, Context& ctxt);
+
     template <typename Rel>
     RamDomain evalIfExists(const Rel& rel, const ram::IfExists& cur, const IfExists& shadow, Context& ctxt);
 
@@ -132,21 +140,55 @@ private:
     RamDomain evalParallelIndexIfExists(const Rel& rel, const ram::ParallelIndexIfExists& cur,
             const ParallelIndexIfExists& shadow, Context& ctxt);
 
+    /** Partial result of an aggregate, accumulated over a part of a relation */
+    struct AggregateState {
+        RamDomain res = 0;
+        /** Sum and number of values for calculating the mean */
+        RamFloat meanSum = 0;
+        RamFloat meanCount = 0;
+        bool shouldRunNested = false;
+    };
+
+    /** Create the neutral state of an aggregate function */
+    static AggregateState initAggregate(AggregateOp function);
+
+    /** Combine the partial state from into the partial state into */
+    static void combineAggregate(AggregateOp function, AggregateState& into, const AggregateState& from);
+
+    template <typename Aggregate, typename Iter>
+    void accumulateAggregate(const Aggregate& aggregate, const Node& filter, const Node* expression,
+            const Iter& ranges, AggregateState& state, Context& ctxt);
+
+    /** Compute the final result of an aggregate from its accumulated state */
+    static void completeAggregate(AggregateOp function, AggregateState& state);
+
+    template <typename Aggregate>
+    RamDomain finishAggregate(
+            const Aggregate& aggregate, const Node& nestedOperation, AggregateState& state, Context& ctxt);
+
     template <typename Aggregate, typename Iter>
     RamDomain evalAggregate(const Aggregate& aggregate, const Node& filter, const Node* expression,
             const Node& nestedOperation, const Iter& ranges, Context& ctxt);
 
+    template <typename Aggregate, typename Partitions>
+    RamDomain evalPartitionedAggregate(const Aggregate& aggregate, const Node& filter, const Node* expression,
+            const Node& nestedOperation, const Partitions& partitions, ViewContext& viewContext,
+            Context& ctxt);
+
     template <typename Rel>
     RamDomain evalParallelAggregate(const Rel& rel, const ram::ParallelAggregate& cur,
             const ParallelAggregate& shadow, Context& ctxt);
 
     template <typename Rel>
-    RamDomain evalParallelIndexAggregate(
-            const ram::ParallelIndexAggregate& cur, const ParallelIndexAggregate& shadow, Context& ctxt);
+    RamDomain evalParallelIndexAggregate(const Rel& rel, const ram::ParallelIndexAggregate& cur,
+            const ParallelIndexAggregate& shadow, Context& ctxt);
 
     template <typename Rel>
     RamDomain evalIndexAggregate(const ram::IndexAggregate& cur, const IndexAggregate& shadow, Context& ctxt);
 
+    template <typename Rel>
+    RamDomain evalGroupAggregate(const ram::GroupAggregate& cur, const GroupAggregate& shadow, Context& ctxt);
+
     template <typename Rel>
     RamDomain evalGuardedInsert(Rel& rel, const GuardedInsert& shadow, Context& ctxt);
 
@@ -156,6 +198,8 @@ private:
     /** If profile is enable in this program */
     const bool profileEnabled;
     const bool frequencyCounterEnabled;
+    /** If rules are sampled instead of timed when profiling */
+    const bool samplingEnabled;
     /** If running a provenance program */
     const bool isProvenance;
     /** subroutines */
@@ -182,6 +226,14 @@ private:
     RecordTable recordTable;
     /** Symbol table for relations */
     VecOwn<RelationHandle> relations;
+    /** Spills cold relations if a memory budget is given */
+    Own<SpillManager> spillManager;
+    /** Relations accessed by each subroutine */
+    std::vector<std::set<std::size_t>> subroutineRelations;
+    /** Serialises the preparation of subroutines executed concurrently */
+    std::mutex subroutineLock;
+    /** Relations accessed directly by the main program */
+    std::set<std::size_t> mainRelations;
     /** Symbol table */
     SymbolTable symbolTable;
 };
@@ -15,6 +15,8 @@
 
 #include "interpreter/Generator.h"
 #include "interpreter/Engine.h"
+#include <functional>
+#include <type_traits>
 
 namespace souffle::interpreter {
 
@@ -22,6 +24,200 @@ using NodePtr = Own<Node>;
 using NodePtrVec = std::vector<NodePtr>;
 using RelationHandle = Own<RelationWrapper>;
 
+namespace {
+
+/** Evaluate the operand of a fused node in the arithmetic of T */
+template <typename T, FusedShape Shape>
+inline T evalFusedTerm(const FusedTerm& term, Context& ctxt) {
+    if constexpr (Shape == FusedShape::Constant) {
+        return ramBitCast<T>(term.constant);
+    } else if constexpr (Shape == FusedShape::Element) {
+        return ramBitCast<T>(ctxt[term.tupleId][term.element]);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return ramBitCast<T>(ctxt[term.tupleId][term.element]) + ramBitCast<T>(term.constant);
+    } else {
+        // integral offsets wrap around, hence signed and unsigned ones agree
+        RamUnsigned value = ramBitCast<RamUnsigned>(ctxt[term.tupleId][term.element]);
+        return ramBitCast<T>(static_cast<RamUnsigned>(value + ramBitCast<RamUnsigned>(term.constant)));
+    }
+}
+
+template <typename T, typename Op, bool IsConstraint, FusedShape Lhs, FusedShape Rhs>
+RamDomain evalFused(const FusedOperation& node, Context& ctxt) {
+    T lhs = evalFusedTerm<T, Lhs>(node.getLhs(), ctxt);
+    T rhs = evalFusedTerm<T, Rhs>(node.getRhs(), ctxt);
+    if constexpr (IsConstraint) {
+        return Op()(lhs, rhs);
+    } else {
+        return ramBitCast(static_cast<T>(Op()(lhs, rhs)));
+    }
+}
+
+template <typename T, typename Op, bool IsConstraint, FusedShape Lhs>
+FusedOperation::Evaluator selectFusedRhs(FusedShape rhs) {
+    switch (rhs) {
+        case FusedShape::Constant: return evalFused<T, Op, IsConstraint, Lhs, FusedShape::Constant>;
+        case FusedShape::Element: return evalFused<T, Op, IsConstraint, Lhs, FusedShape::Element>;
+        case FusedShape::Offset: return evalFused<T, Op, IsConstraint, Lhs, FusedShape::Offset>;
+    }
+    UNREACHABLE_BAD_CASE_ANALYSIS
+}
+
+/** Select the evaluator specialised for the operator and the shapes of the operands */
+template <typename T, typename Op, bool IsConstraint>
+FusedOperation::Evaluator selectFused(FusedShape lhs, FusedShape rhs) {
+    switch (lhs) {
+        case FusedShape::Constant: return selectFusedRhs<T, Op, IsConstraint, FusedShape::Constant>(rhs);
+        case FusedShape::Element: return selectFusedRhs<T, Op, IsConstraint, FusedShape::Element>(rhs);
+        case FusedShape::Offset: return selectFusedRhs<T, Op, IsConstraint, FusedShape::Offset>(rhs);
+    }
+    UNREACHABLE_BAD_CASE_ANALYSIS
+}
+
+struct FusedMin {
+    template <typename T>
+    T operator()(T lhs, T rhs) const {
+        return std::min(lhs, rhs);
+    }
+};
+
+struct FusedMax {
+    template <typename T>
+    T operator()(T lhs, T rhs) const {
+        return std::max(lhs, rhs);
+    }
+};
+
+/** Numeric coercion to To, following C++ semantics as the engine does */
+template <typename To>
+struct TypedCast {
+    template <typename T>
+    To operator()(T value) const {
+        return static_cast<To>(value);
+    }
+};
+
+/** Evaluate the operand of a typed evaluator */
+template <typename T, TypedShape Shape>
+inline T evalTypedOperand(const TypedOperand<T>& operand, Context& ctxt) {
+    if constexpr (Shape == TypedShape::Constant) {
+        return operand.constant;
+    } else if constexpr (Shape == TypedShape::Element) {
+        return ramBitCast<T>(ctxt[operand.tupleId][operand.element]);
+    } else {
+        return operand.expression->evaluateTyped(ctxt);
+    }
+}
+
+/** Evaluator applying the binary Op to operands of type T, whose result is cast to Result */
+template <typename T, typename Result, typename Op, TypedShape Lhs, TypedShape Rhs>
+class TypedBinary : public TypedExpression<Result> {
+public:
+    TypedBinary(TypedOperand<T> lhs, TypedOperand<T> rhs) : lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+
+    Result evaluateTyped(Context& ctxt) const override {
+        T left = evalTypedOperand<T, Lhs>(lhs, ctxt);
+        T right = evalTypedOperand<T, Rhs>(rhs, ctxt);
+        return static_cast<Result>(Op()(left, right));
+    }
+
+private:
+    TypedOperand<T> lhs;
+    TypedOperand<T> rhs;
+};
+
+/** Evaluator applying the unary Op to an operand of type T, whose result is cast to Result */
+template <typename T, typename Result, typename Op, TypedShape Shape>
+class TypedUnary : public TypedExpression<Result> {
+public:
+    TypedUnary(TypedOperand<T> operand) : operand(std::move(operand)) {}
+
+    Result evaluateTyped(Context& ctxt) const override {
+        return static_cast<Result>(Op()(evalTypedOperand<T, Shape>(operand, ctxt)));
+    }
+
+private:
+    TypedOperand<T> operand;
+};
+
+template <typename T, typename Result, typename Op, TypedShape Lhs>
+Own<TypedExpression<Result>> makeTypedBinaryRhs(TypedOperand<T> lhs, TypedOperand<T> rhs) {
+    switch (rhs.shape) {
+        case TypedShape::Constant:
+            return mk<TypedBinary<T, Result, Op, Lhs, TypedShape::Constant>>(std::move(lhs), std::move(rhs));
+        case TypedShape::Element:
+            return mk<TypedBinary<T, Result, Op, Lhs, TypedShape::Element>>(std::move(lhs), std::move(rhs));
+        case TypedShape::Expression:
+            return mk<TypedBinary<T, Result, Op, Lhs, TypedShape::Expression>>(
+                    std::move(lhs), std::move(rhs));
+    }
+    UNREACHABLE_BAD_CASE_ANALYSIS
+}
+
+/** Make the binary evaluator specialised for the operator and the shapes of the operands */
+template <typename T, typename Result, typename Op>
+Own<TypedExpression<Result>> makeTypedBinary(TypedOperand<T> lhs, TypedOperand<T> rhs) {
+    switch (lhs.shape) {
+        case TypedShape::Constant:
+            return makeTypedBinaryRhs<T, Result, Op, TypedShape::Constant>(std::move(lhs), std::move(rhs));
+        case TypedShape::Element:
+            return makeTypedBinaryRhs<T, Result, Op, TypedShape::Element>(std::move(lhs), std::move(rhs));
+        case TypedShape::Expression:
+            return makeTypedBinaryRhs<T, Result, Op, TypedShape::Expression>(std::move(lhs), std::move(rhs));
+    }
+    UNREACHABLE_BAD_CASE_ANALYSIS
+}
+
+/** Make the unary evaluator specialised for the operator and the shape of the operand */
+template <typename T, typename Result, typename Op>
+Own<TypedExpression<Result>> makeTypedUnary(TypedOperand<T> operand) {
+    switch (operand.shape) {
+        case TypedShape::Constant:
+            return mk<TypedUnary<T, Result, Op, TypedShape::Constant>>(std::move(operand));
+        case TypedShape::Element:
+            return mk<TypedUnary<T, Result, Op, TypedShape::Element>>(std::move(operand));
+        case TypedShape::Expression:
+            return mk<TypedUnary<T, Result, Op, TypedShape::Expression>>(std::move(operand));
+    }
+    UNREACHABLE_BAD_CASE_ANALYSIS
+}
+
+/**
+ * Whether a condition can be evaluated ahead of the nested operation of a scan for the preceding tuples
+ * of a batch, i.e. it reads none of the given relations written by the nested operation, and calls no
+ * functor which could observe the order of evaluation.
+ */
+bool isBatchable(const ram::Condition& condition, const std::set<std::string>& written) {
+    bool batchable = true;
+    visit(condition, [&](const ram::Node& node) {
+        if (const auto* exists = as<ram::AbstractExistenceCheck>(node)) {
+            batchable = batchable && !contains(written, exists->getRelation());
+        } else if (const auto* emptiness = as<ram::EmptinessCheck>(node)) {
+            batchable = batchable && !contains(written, emptiness->getRelation());
+        } else if (const auto* size = as<ram::RelationSize>(node)) {
+            batchable = batchable && !contains(written, size->getRelation());
+        } else if (const auto* functor = as<ram::UserDefinedOperator>(node)) {
+            batchable = batchable && !functor->isStateful();
+        } else if (isA<ram::AutoIncrement>(node)) {
+            batchable = false;
+        }
+    });
+    return batchable;
+}
+
+/** Collect the conjunctive terms of a condition */
+void addConjunctiveTerms(const Node* condition, std::vector<const Node*>& terms) {
+    if (condition->getType() == I_Conjunction) {
+        const auto& conj = *static_cast<const Conjunction*>(condition);
+        addConjunctiveTerms(conj.getLhs(), terms);
+        addConjunctiveTerms(conj.getRhs(), terms);
+    } else {
+        terms.push_back(condition);
+    }
+}
+
+}  // namespace
+
 NodeGenerator::NodeGenerator(Engine& engine) : engine(engine) {
     visit(engine.tUnit.getProgram(), [&](const ram::Relation& relation) {
         assert(relationMap.find(relation.getName()) == relationMap.end() && "double-naming of relations");
@@ -30,6 +226,7 @@ NodeGenerator::NodeGenerator(Engine& engine) : engine(engine) {
 }
 
 NodePtr NodeGenerator::generateTree(const ram::Node& root) {
+    accessedRelations.clear();
     // Encode all relation, indexPos and viewId.
     visit(root, [&](const ram::Node& node) {
         if (isA<ram::Query>(&node)) {
@@ -44,6 +241,9 @@ NodePtr NodeGenerator::generateTree(const ram::Node& root) {
         } else if (const auto* provExists = as<ram::ProvenanceExistenceCheck>(node)) {
             encodeIndexPos(*provExists);
             encodeView(provExists);
+        } else if (const auto* group = as<ram::GroupAggregate>(node)) {
+            encodeIndexPos(*group);
+            encodeView(group);
         }
     });
     // Parse program
@@ -71,6 +271,12 @@ NodePtr NodeGenerator::visit_(type_identity<ram::AutoIncrement>, const ram::Auto
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::IntrinsicOperator>, const ram::IntrinsicOperator& op) {
+    if (auto fused = fuseOperator(op)) {
+        return fused;
+    }
+    if (auto typed = compileOperator(op)) {
+        return typed;
+    }
     NodePtrVec children;
     for (const auto& arg : op.getArguments()) {
         children.push_back(dispatch(*arg));
@@ -165,6 +371,12 @@ NodePtr NodeGenerator::visit_(
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::Constraint>, const ram::Constraint& relOp) {
+    if (auto fused = fuseConstraint(relOp)) {
+        return fused;
+    }
+    if (auto typed = compileConstraint(relOp)) {
+        return typed;
+    }
     return mk<Constraint>(I_Constraint, &relOp, dispatch(relOp.getLHS()), dispatch(relOp.getRHS()));
 }
 
@@ -184,7 +396,9 @@ NodePtr NodeGenerator::visit_(type_identity<ram::Scan>, const ram::Scan& scan) {
     std::size_t relId = encodeRelation(scan.getRelation());
     auto rel = getRelationHandle(relId);
     NodeType type = constructNodeType("Scan", lookup(scan.getRelation()));
-    return mk<Scan>(type, &scan, rel, visit_(type_identity<ram::TupleOperation>(), scan));
+    auto res = mk<Scan>(type, &scan, rel, visit_(type_identity<ram::TupleOperation>(), scan));
+    res->setBatchPlan(planBatch(scan, res->getNestedOperation()));
+    return res;
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::ParallelScan>, const ram::ParallelScan& pScan) {
@@ -194,6 +408,7 @@ NodePtr NodeGenerator::visit_(type_identity<ram::ParallelScan>, const ram::Paral
     NodeType type = constructNodeType("ParallelScan", lookup(pScan.getRelation()));
     auto res = mk<ParallelScan>(type, &pScan, rel, visit_(type_identity<ram::TupleOperation>(), pScan));
     res->setViewContext(parentQueryViewContext);
+    res->setBatchPlan(planBatch(pScan, res->getNestedOperation()));
     return res;
 }
 
@@ -201,8 +416,10 @@ NodePtr NodeGenerator::visit_(type_identity<ram::IndexScan>, const ram::IndexSca
     orderingContext.addTupleWithIndexOrder(iScan.getTupleId(), iScan);
     SuperInstruction indexOperation = getIndexSuperInstInfo(iScan);
     NodeType type = constructNodeType("IndexScan", lookup(iScan.getRelation()));
-    return mk<IndexScan>(type, &iScan, nullptr, visit_(type_identity<ram::TupleOperation>(), iScan),
+    auto res = mk<IndexScan>(type, &iScan, nullptr, visit_(type_identity<ram::TupleOperation>(), iScan),
             encodeView(&iScan), std::move(indexOperation));
+    res->setBatchPlan(planBatch(iScan, res->getNestedOperation()));
+    return res;
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::ParallelIndexScan>, const ram::ParallelIndexScan& piscan) {
@@ -214,6 +431,7 @@ NodePtr NodeGenerator::visit_(type_identity<ram::ParallelIndexScan>, const ram::
     auto res = mk<ParallelIndexScan>(type, &piscan, rel, visit_(type_identity<ram::TupleOperation>(), piscan),
             encodeIndexPos(piscan), std::move(indexOperation));
     res->setViewContext(parentQueryViewContext);
+    res->setBatchPlan(planBatch(piscan, res->getNestedOperation()));
     return res;
 }
 
@@ -324,11 +542,29 @@ NodePtr NodeGenerator::visit_(
     auto rel = getRelationHandle(relId);
     NodeType type = constructNodeType("ParallelIndexAggregate", lookup(piAggregate.getRelation()));
     auto res = mk<ParallelIndexAggregate>(type, &piAggregate, rel, std::move(expr), std::move(cond),
-            std::move(nested), encodeView(&piAggregate), std::move(indexOperation));
+            std::move(nested), encodeIndexPos(piAggregate), std::move(indexOperation));
     res->setViewContext(parentQueryViewContext);
     return res;
 }
 
+NodePtr NodeGenerator::visit_(type_identity<ram::GroupAggregate>, const ram::GroupAggregate& gAggregate) {
+    orderingContext.addTupleWithIndexOrder(gAggregate.getTupleId(), gAggregate);
+    std::vector<std::size_t> groupPositions;
+    for (std::size_t column : gAggregate.getGroupColumns()) {
+        groupPositions.push_back(orderingContext.mapOrder(gAggregate.getTupleId(), column));
+    }
+    NodePtr expr = dispatch(gAggregate.getExpression());
+    NodePtr cond = dispatch(gAggregate.getCondition());
+    // the nested operation sees the result followed by the group columns
+    orderingContext.addNewTuple(gAggregate.getTupleId(), gAggregate.getGroupColumns().size() + 1);
+    NodePtr nested = visit_(type_identity<ram::TupleOperation>(), gAggregate);
+    std::size_t relId = encodeRelation(gAggregate.getRelation());
+    auto rel = getRelationHandle(relId);
+    NodeType type = constructNodeType("GroupAggregate", lookup(gAggregate.getRelation()));
+    return mk<GroupAggregate>(type, &gAggregate, rel, std::move(expr), std::move(cond), std::move(nested),
+            encodeView(&gAggregate), std::move(groupPositions));
+}
+
 NodePtr NodeGenerator::visit_(type_identity<ram::Break>, const ram::Break& breakOp) {
     return mk<Break>(I_Break, &breakOp, dispatch(breakOp.getCondition()), dispatch(breakOp.getOperation()));
 }
@@ -425,6 +661,24 @@ NodePtr NodeGenerator::visit_(type_identity<ram::LogSize>, const ram::LogSize& s
     return mk<LogSize>(I_LogSize, &size, rel);
 }
 
+NodePtr NodeGenerator::visit_(type_identity<ram::LogMemory>, const ram::LogMemory& memory) {
+    std::size_t relId = encodeRelation(memory.getRelation());
+    auto rel = getRelationHandle(relId);
+    std::string structure;
+    const ram::Relation& relation = lookup(memory.getRelation());
+    switch (relation.getRepresentation()) {
+        case RelationRepresentation::EQREL: structure = "eqrel"; break;
+        case RelationRepresentation::MIN: structure = "min"; break;
+        default:
+            if (Global::config().has("provenance")) {
+                structure = "provenance";
+            } else {
+                structure = isBrie(relation) ? "brie" : "btree";
+            }
+    }
+    return mk<LogMemory>(I_LogMemory, &memory, rel, structure);
+}
+
 NodePtr NodeGenerator::visit_(type_identity<ram::IO>, const ram::IO& io) {
     std::size_t relId = encodeRelation(io.getRelation());
     auto rel = getRelationHandle(relId);
@@ -516,7 +770,7 @@ std::size_t NodeGenerator::encodeIndexPos(RamNode& node) {
     ram::analysis::SearchSignature signature = engine.isa->getSearchSignature(&node);
     // A zero signature is equivalent as a full order signature.
     if (signature.empty()) {
-        signature = ram::analysis::SearchSignature::getFullSearchSignature(signature.arity());
+        signature = engine.isa->getSearchSignature(&lookup(name));
     }
     auto i = engine.isa->getIndexSelection(name).getLexOrderNum(signature);
     indexTable[&node] = i;
@@ -547,10 +801,12 @@ std::size_t NodeGenerator::getArity(const std::string& relName) {
 std::size_t NodeGenerator::encodeRelation(const std::string& relName) {
     auto pos = relTable.find(relName);
     if (pos != relTable.end()) {
+        accessedRelations.insert(pos->second);
         return pos->second;
     }
     std::size_t id = getNewRelId();
     relTable[relName] = id;
+    accessedRelations.insert(id);
     engine.createRelation(lookup(relName), id);
     return id;
 }
@@ -564,6 +820,8 @@ bool NodeGenerator::requireView(const ram::Node* node) {
         return true;
     } else if (isA<ram::IndexOperation>(node)) {
         return true;
+    } else if (isA<ram::GroupAggregate>(node)) {
+        return true;
     }
     return false;
 }
@@ -573,11 +831,44 @@ const std::string& NodeGenerator::getViewRelation(const ram::Node* node) {
         return exist->getRelation();
     } else if (const auto* index = as<ram::IndexOperation>(node)) {
         return index->getRelation();
+    } else if (const auto* group = as<ram::GroupAggregate>(node)) {
+        return group->getRelation();
     }
 
     fatal("The ram::Node does not require a view.");
 }
 
+BatchPlan NodeGenerator::planBatch(const ram::RelationOperation& scan, const Node* nested) {
+    BatchPlan plan;
+    plan.arity = lookup(scan.getRelation()).getArity();
+    if (!batchingEnabled || plan.arity == 0 || (engine.profileEnabled && engine.frequencyCounterEnabled)) {
+        return plan;
+    }
+
+    // the scanned relation and the relations written by the nested operation, which batched
+    // conditions must not read
+    std::set<std::string> written{scan.getRelation()};
+    visit(scan.getOperation(), [&](const ram::Insert& insert) { written.insert(insert.getRelation()); });
+
+    // batch the leading filters, up to the first whose condition cannot be evaluated ahead
+    const ram::Operation* op = &scan.getOperation();
+    std::vector<const Node*> conditions;
+    while (const auto* filter = as<ram::Filter>(op)) {
+        if (nested->getType() != I_Filter || !isBatchable(filter->getCondition(), written)) {
+            break;
+        }
+        const auto& shadow = *static_cast<const Filter*>(nested);
+        addConjunctiveTerms(shadow.getCondition(), conditions);
+        op = &filter->getOperation();
+        nested = shadow.getNestedOperation();
+    }
+    if (!conditions.empty()) {
+        plan.conditions = std::move(conditions);
+        plan.nested = nested;
+    }
+    return plan;
+}
+
 SuperInstruction NodeGenerator::getIndexSuperInstInfo(const ram::IndexOperation& ramIndex) {
     std::size_t arity = getArity(ramIndex.getRelation());
     auto interpreterRel = encodeRelation(ramIndex.getRelation());
@@ -722,6 +1013,324 @@ SuperInstruction NodeGenerator::getInsertSuperInstInfo(const ram::Insert& exist)
     return superOp;
 }
 
+NodePtr NodeGenerator::fuseConstraint(const ram::Constraint& constraint) {
+    const auto& lhs = constraint.getLHS();
+    const auto& rhs = constraint.getRHS();
+    // clang-format off
+#define FUSE_EQ_NE(opCode, op)                                                               \
+    case BinaryConstraintOp::   opCode: return fuse<RamDomain, op, true>(constraint, lhs, rhs); \
+    case BinaryConstraintOp::F##opCode: return fuse<RamFloat , op, true>(constraint, lhs, rhs);
+#define FUSE_COMPARE(opCode, op)                                                               \
+    case BinaryConstraintOp::   opCode: return fuse<RamSigned  , op, true>(constraint, lhs, rhs); \
+    case BinaryConstraintOp::U##opCode: return fuse<RamUnsigned, op, true>(constraint, lhs, rhs); \
+    case BinaryConstraintOp::F##opCode: return fuse<RamFloat   , op, true>(constraint, lhs, rhs);
+    // clang-format on
+
+    switch (constraint.getOperator()) {
+        FUSE_EQ_NE(EQ, std::equal_to<>)
+        FUSE_EQ_NE(NE, std::not_equal_to<>)
+        FUSE_COMPARE(LT, std::less<>)
+        FUSE_COMPARE(LE, std::less_equal<>)
+        FUSE_COMPARE(GT, std::greater<>)
+        FUSE_COMPARE(GE, std::greater_equal<>)
+        // comparisons of symbols and string matching are not fused
+        default: return nullptr;
+    }
+
+#undef FUSE_COMPARE
+#undef FUSE_EQ_NE
+}
+
+NodePtr NodeGenerator::fuseOperator(const ram::IntrinsicOperator& op) {
+    const auto& args = op.getArguments();
+    if (args.size() != 2) {
+        return nullptr;
+    }
+    // clang-format off
+#define FUSE_INTEGRAL(opCode, op)                                                          \
+    case FunctorOp::   opCode: return fuse<RamSigned  , op, false>(node, *args[0], *args[1]); \
+    case FunctorOp::U##opCode: return fuse<RamUnsigned, op, false>(node, *args[0], *args[1]);
+#define FUSE_NUMERIC(opCode, op)                                                        \
+    FUSE_INTEGRAL(opCode, op)                                                           \
+    case FunctorOp::F##opCode: return fuse<RamFloat, op, false>(node, *args[0], *args[1]);
+    // clang-format on
+
+    const ram::Node& node = op;
+    switch (op.getOperator()) {
+        FUSE_NUMERIC(ADD, std::plus<>)
+        FUSE_NUMERIC(SUB, std::minus<>)
+        FUSE_NUMERIC(MUL, std::multiplies<>)
+        FUSE_NUMERIC(MAX, FusedMax)
+        FUSE_NUMERIC(MIN, FusedMin)
+        FUSE_INTEGRAL(BAND, std::bit_and<>)
+        FUSE_INTEGRAL(BOR, std::bit_or<>)
+        FUSE_INTEGRAL(BXOR, std::bit_xor<>)
+        default: return nullptr;
+    }
+
+#undef FUSE_NUMERIC
+#undef FUSE_INTEGRAL
+}
+
+template <typename T, typename Op, bool IsConstraint>
+NodePtr NodeGenerator::fuse(const ram::Node& node, const ram::Expression& lhs, const ram::Expression& rhs) {
+    if (!fusionEnabled) {
+        return nullptr;
+    }
+    FusedShape lhsShape;
+    FusedShape rhsShape;
+    FusedTerm lhsTerm;
+    FusedTerm rhsTerm;
+    if (!encodeFusedTerm<T>(lhs, lhsShape, lhsTerm) || !encodeFusedTerm<T>(rhs, rhsShape, rhsTerm)) {
+        return nullptr;
+    }
+    // operations over constants only are rare, and not worth an evaluator of their own
+    if (lhsShape == FusedShape::Constant && rhsShape == FusedShape::Constant) {
+        return nullptr;
+    }
+    auto evaluator = selectFused<T, Op, IsConstraint>(lhsShape, rhsShape);
+    if constexpr (IsConstraint) {
+        return mk<FusedConstraint>(I_FusedConstraint, &node, evaluator, lhsTerm, rhsTerm);
+    } else {
+        return mk<FusedOperator>(I_FusedOperator, &node, evaluator, lhsTerm, rhsTerm);
+    }
+}
+
+template <typename T>
+bool NodeGenerator::encodeFusedTerm(const ram::Expression& expr, FusedShape& shape, FusedTerm& term) {
+    if (const auto* constant = as<ram::NumericConstant>(expr)) {
+        shape = FusedShape::Constant;
+        term.constant = constant->getConstant();
+        return true;
+    }
+    if (const auto* constant = as<ram::StringConstant>(expr)) {
+        shape = FusedShape::Constant;
+        term.constant = engine.getSymbolTable().encode(constant->getConstant());
+        return true;
+    }
+
+    // an element plus or minus a constant is an offset element, if computed in the arithmetic of T
+    const ram::TupleElement* element = as<ram::TupleElement>(expr);
+    const ram::NumericConstant* offset = nullptr;
+    bool isSubtraction = false;
+    if (const auto* op = as<ram::IntrinsicOperator>(expr)) {
+        const auto& args = op->getArguments();
+        FunctorOp functor = op->getOperator();
+        bool isAddition;
+        if constexpr (std::is_floating_point_v<T>) {
+            isAddition = functor == FunctorOp::FADD;
+            isSubtraction = functor == FunctorOp::FSUB;
+        } else {
+            isAddition = functor == FunctorOp::ADD || functor == FunctorOp::UADD;
+            isSubtraction = functor == FunctorOp::SUB || functor == FunctorOp::USUB;
+        }
+        if (args.size() != 2 || (!isAddition && !isSubtraction)) {
+            return false;
+        }
+        element = as<ram::TupleElement>(args[0]);
+        offset = as<ram::NumericConstant>(args[1]);
+        if (isAddition && element == nullptr) {
+            element = as<ram::TupleElement>(args[1]);
+            offset = as<ram::NumericConstant>(args[0]);
+        }
+        if (offset == nullptr) {
+            return false;
+        }
+    }
+    if (element == nullptr) {
+        return false;
+    }
+
+    term.tupleId = element->getTupleId();
+    term.element = orderingContext.mapOrder(term.tupleId, element->getElement());
+    if (offset == nullptr) {
+        shape = FusedShape::Element;
+    } else {
+        shape = FusedShape::Offset;
+        term.constant = offset->getConstant();
+        if (isSubtraction && std::is_floating_point_v<T>) {
+            term.constant = ramBitCast(-ramBitCast<RamFloat>(term.constant));
+        } else if (isSubtraction) {
+            term.constant = ramBitCast(static_cast<RamUnsigned>(0 - ramBitCast<RamUnsigned>(term.constant)));
+        }
+    }
+    return true;
+}
+
+NodePtr NodeGenerator::compileConstraint(const ram::Constraint& constraint) {
+    if (!fusionEnabled) {
+        return nullptr;
+    }
+    // clang-format off
+#define COMPILE_EQ_NE(opCode, op)                                                   \
+    case BinaryConstraintOp::   opCode: return compileComparison<RamDomain, op>(constraint); \
+    case BinaryConstraintOp::F##opCode: return compileComparison<RamFloat , op>(constraint);
+#define COMPILE_COMPARE(opCode, op)                                                   \
+    case BinaryConstraintOp::   opCode: return compileComparison<RamSigned  , op>(constraint); \
+    case BinaryConstraintOp::U##opCode: return compileComparison<RamUnsigned, op>(constraint); \
+    case BinaryConstraintOp::F##opCode: return compileComparison<RamFloat   , op>(constraint);
+    // clang-format on
+
+    switch (constraint.getOperator()) {
+        COMPILE_EQ_NE(EQ, std::equal_to<>)
+        COMPILE_EQ_NE(NE, std::not_equal_to<>)
+        COMPILE_COMPARE(LT, std::less<>)
+        COMPILE_COMPARE(LE, std::less_equal<>)
+        COMPILE_COMPARE(GT, std::greater<>)
+        COMPILE_COMPARE(GE, std::greater_equal<>)
+        default: return nullptr;
+    }
+
+#undef COMPILE_COMPARE
+#undef COMPILE_EQ_NE
+}
+
+NodePtr NodeGenerator::compileOperator(const ram::IntrinsicOperator& op) {
+    if (!fusionEnabled) {
+        return nullptr;
+    }
+    // the operator determines the type of the functor, hence at most one of them compiles
+    if (auto signedExpr = compileTyped<RamSigned>(op)) {
+        return mk<TypedOperator>(I_TypedOperator, &op, std::move(signedExpr));
+    }
+    if (auto unsignedExpr = compileTyped<RamUnsigned>(op)) {
+        return mk<TypedOperator>(I_TypedOperator, &op, std::move(unsignedExpr));
+    }
+    if (auto floatExpr = compileTyped<RamFloat>(op)) {
+        return mk<TypedOperator>(I_TypedOperator, &op, std::move(floatExpr));
+    }
+    return nullptr;
+}
+
+template <typename T, typename Op>
+NodePtr NodeGenerator::compileComparison(const ram::Constraint& constraint) {
+    TypedOperand<T> lhs;
+    TypedOperand<T> rhs;
+    if (!compileTypedOperand(constraint.getLHS(), lhs) || !compileTypedOperand(constraint.getRHS(), rhs)) {
+        return nullptr;
+    }
+    auto evaluator = makeTypedBinary<T, RamDomain, Op>(std::move(lhs), std::move(rhs));
+    return mk<TypedConstraint>(I_TypedConstraint, &constraint, std::move(evaluator));
+}
+
+template <typename T>
+Own<TypedExpression<T>> NodeGenerator::compileTyped(const ram::IntrinsicOperator& op) {
+    const auto& args = op.getArguments();
+    // clang-format off
+#define COMPILE_FOLD(opCode, ty, op)                               \
+    case FunctorOp::opCode:                                         \
+        if constexpr (std::is_same_v<T, ty>) {                      \
+            return compileTypedFold<T, op>(args);                   \
+        }                                                           \
+        return nullptr;
+#define COMPILE_INTEGRAL(opCode, op)          \
+    COMPILE_FOLD(   opCode, RamSigned  , op) \
+    COMPILE_FOLD(U##opCode, RamUnsigned, op)
+#define COMPILE_NUMERIC(opCode, op)        \
+    COMPILE_INTEGRAL(opCode, op)           \
+    COMPILE_FOLD(F##opCode, RamFloat, op)
+#define COMPILE_UNARY(opCode, from, to, op)                         \
+    case FunctorOp::opCode:                                         \
+        if constexpr (std::is_same_v<T, to>) {                      \
+            return compileTypedUnary<from, to, op>(*args[0]);       \
+        }                                                           \
+        return nullptr;
+#define COMPILE_CAST(opCode, from, to) COMPILE_UNARY(opCode, from, to, TypedCast<to>)
+
+    switch (op.getOperator()) {
+        COMPILE_NUMERIC(ADD, std::plus<>)
+        COMPILE_NUMERIC(SUB, std::minus<>)
+        COMPILE_NUMERIC(MUL, std::multiplies<>)
+        COMPILE_NUMERIC(DIV, std::divides<>)
+        COMPILE_NUMERIC(MAX, FusedMax)
+        COMPILE_NUMERIC(MIN, FusedMin)
+        COMPILE_INTEGRAL(MOD, std::modulus<>)
+        COMPILE_INTEGRAL(BAND, std::bit_and<>)
+        COMPILE_INTEGRAL(BOR, std::bit_or<>)
+        COMPILE_INTEGRAL(BXOR, std::bit_xor<>)
+
+        COMPILE_UNARY(NEG  , RamSigned  , RamSigned  , std::negate<>)
+        COMPILE_UNARY(FNEG , RamFloat   , RamFloat   , std::negate<>)
+        COMPILE_UNARY(BNOT , RamSigned  , RamSigned  , std::bit_not<>)
+        COMPILE_UNARY(UBNOT, RamUnsigned, RamUnsigned, std::bit_not<>)
+
+        COMPILE_CAST(I2I, RamSigned  , RamSigned)
+        COMPILE_CAST(I2U, RamSigned  , RamUnsigned)
+        COMPILE_CAST(I2F, RamSigned  , RamFloat)
+        COMPILE_CAST(U2U, RamUnsigned, RamUnsigned)
+        COMPILE_CAST(U2I, RamUnsigned, RamSigned)
+        COMPILE_CAST(U2F, RamUnsigned, RamFloat)
+        COMPILE_CAST(F2F, RamFloat   , RamFloat)
+        COMPILE_CAST(F2I, RamFloat   , RamSigned)
+        COMPILE_CAST(F2U, RamFloat   , RamUnsigned)
+
+        // functors over symbols, exponents, shifts and logical functors are evaluated by the engine
+        default: return nullptr;
+    }
+    // clang-format on
+
+#undef COMPILE_CAST
+#undef COMPILE_UNARY
+#undef COMPILE_NUMERIC
+#undef COMPILE_INTEGRAL
+#undef COMPILE_FOLD
+}
+
+template <typename T, typename Op>
+Own<TypedExpression<T>> NodeGenerator::compileTypedFold(const std::vector<ram::Expression*>& args) {
+    // min and max take any number of arguments, which the engine folds from the left
+    TypedOperand<T> lhs;
+    if (args.size() < 2 || !compileTypedOperand(*args[0], lhs)) {
+        return nullptr;
+    }
+    for (std::size_t i = 1; i < args.size(); ++i) {
+        TypedOperand<T> rhs;
+        if (!compileTypedOperand(*args[i], rhs)) {
+            return nullptr;
+        }
+        auto folded = makeTypedBinary<T, T, Op>(std::move(lhs), std::move(rhs));
+        lhs = TypedOperand<T>();
+        lhs.shape = TypedShape::Expression;
+        lhs.expression = std::move(folded);
+    }
+    return std::move(lhs.expression);
+}
+
+template <typename From, typename To, typename Op>
+Own<TypedExpression<To>> NodeGenerator::compileTypedUnary(const ram::Expression& arg) {
+    TypedOperand<From> operand;
+    if (!compileTypedOperand(arg, operand)) {
+        return nullptr;
+    }
+    return makeTypedUnary<From, To, Op>(std::move(operand));
+}
+
+template <typename T>
+bool NodeGenerator::compileTypedOperand(const ram::Expression& expr, TypedOperand<T>& operand) {
+    if (const auto* constant = as<ram::NumericConstant>(expr)) {
+        operand.shape = TypedShape::Constant;
+        operand.constant = ramBitCast<T>(constant->getConstant());
+        return true;
+    }
+    if (const auto* constant = as<ram::StringConstant>(expr)) {
+        operand.shape = TypedShape::Constant;
+        operand.constant = ramBitCast<T>(engine.getSymbolTable().encode(constant->getConstant()));
+        return true;
+    }
+    if (const auto* element = as<ram::TupleElement>(expr)) {
+        operand.shape = TypedShape::Element;
+        operand.tupleId = element->getTupleId();
+        operand.element = orderingContext.mapOrder(operand.tupleId, element->getElement());
+        return true;
+    }
+    if (const auto* op = as<ram::IntrinsicOperator>(expr)) {
+        operand.shape = TypedShape::Expression;
+        operand.expression = compileTyped<T>(*op);
+        return operand.expression != nullptr;
+    }
+    return false;
+}
+
 // -- Definition of OrderingContext --
 
 NodeGenerator::OrderingContext::OrderingContext(NodeGenerator& generator) : generator(generator) {}
@@ -40,6 +40,7 @@
 #include "ram/Extend.h"
 #include "ram/False.h"
 #include "ram/Filter.h"
+#include "ram/GroupAggregate.h"
 #include "ram/IO.h"
 #include "ram/IfExists.h"
 #include "ram/IndexAggregate.h"
@@ -48,6 +49,7 @@
 #include "ram/IndexScan.h"
 #include "ram/Insert.h"
 #include "ram/IntrinsicOperator.h"
+#include "ram/LogMemory.h"
 #include "ram/LogRelationTimer.h"
 #include "ram/LogSize.h"
 #include "ram/LogTimer.h"
@@ -70,6 +72,7 @@
 #include "ram/ProvenanceExistenceCheck.h"
 #include "ram/Query.h"
 #include "ram/Relation.h"
+#include "ram/RelationOperation.h"
 #include "ram/RelationSize.h"
 #include "ram/Scan.h"
 #include "ram/Sequence.h"
@@ -97,6 +100,7 @@
 #include <map>
 #include <memory>
 #include <queue>
+#include <set>
 #include <string>
 #include <typeinfo>
 #include <unordered_map>
@@ -124,6 +128,13 @@ public:
      */
     NodePtr generateTree(const ram::Node& root);
 
+    /**
+     * @brief Return the ids of the relations accessed by the most recently generated tree.
+     */
+    const std::set<std::size_t>& getAccessedRelations() const {
+        return accessedRelations;
+    }
+
     NodePtr visit_(type_identity<ram::NumericConstant>, const ram::NumericConstant& num) override;
 
     NodePtr visit_(type_identity<ram::StringConstant>, const ram::StringConstant& num) override;
@@ -194,6 +205,8 @@ public:
     NodePtr visit_(type_identity<ram::ParallelIndexAggregate>,
             const ram::ParallelIndexAggregate& piAggregate) override;
 
+    NodePtr visit_(type_identity<ram::GroupAggregate>, const ram::GroupAggregate& gAggregate) override;
+
     NodePtr visit_(type_identity<ram::Break>, const ram::Break& breakOp) override;
 
     NodePtr visit_(type_identity<ram::Filter>, const ram::Filter& filter) override;
@@ -224,6 +237,8 @@ public:
 
     NodePtr visit_(type_identity<ram::LogSize>, const ram::LogSize& size) override;
 
+    NodePtr visit_(type_identity<ram::LogMemory>, const ram::LogMemory& memory) override;
+
     NodePtr visit_(type_identity<ram::IO>, const ram::IO& io) override;
 
     NodePtr visit_(type_identity<ram::Query>, const ram::Query& query) override;
@@ -335,6 +350,80 @@ private:
      */
     SuperInstruction getInsertSuperInstInfo(const ram::Insert& exist);
 
+    /**
+     * @brief Return a fused node for a numeric constraint over simple operands, or nullptr.
+     */
+    NodePtr fuseConstraint(const ram::Constraint& constraint);
+
+    /**
+     * @brief Return a fused node for a binary functor over simple operands, or nullptr.
+     */
+    NodePtr fuseOperator(const ram::IntrinsicOperator& op);
+
+    /**
+     * @brief Return a fused node applying Op in the arithmetic of T to the given operands, or nullptr
+     * if an operand is not a simple term.
+     */
+    template <typename T, typename Op, bool IsConstraint>
+    NodePtr fuse(const ram::Node& node, const ram::Expression& lhs, const ram::Expression& rhs);
+
+    /**
+     * @brief Encode an expression as the operand of a fused node in the arithmetic of T, returning
+     * false if it is not a constant, a tuple element, or a tuple element plus or minus a constant.
+     */
+    template <typename T>
+    bool encodeFusedTerm(const ram::Expression& expr, FusedShape& shape, FusedTerm& term);
+
+    /**
+     * @brief Return a typed node for a numeric constraint whose operands compile to typed evaluators,
+     * or nullptr.
+     */
+    NodePtr compileConstraint(const ram::Constraint& constraint);
+
+    /**
+     * @brief Return a typed node for a numeric functor whose arguments compile to typed evaluators,
+     * or nullptr.
+     */
+    NodePtr compileOperator(const ram::IntrinsicOperator& op);
+
+    /**
+     * @brief Return a typed node comparing the operands of a constraint with Op in the type T, or nullptr.
+     */
+    template <typename T, typename Op>
+    NodePtr compileComparison(const ram::Constraint& constraint);
+
+    /**
+     * @brief Compile a functor yielding a T to a typed evaluator, returning nullptr if the functor
+     * yields another type, or if it or one of its arguments has no typed evaluator.
+     */
+    template <typename T>
+    Own<TypedExpression<T>> compileTyped(const ram::IntrinsicOperator& op);
+
+    /**
+     * @brief Compile the left fold of the arguments of a functor with Op in the type T, or nullptr.
+     */
+    template <typename T, typename Op>
+    Own<TypedExpression<T>> compileTypedFold(const std::vector<ram::Expression*>& args);
+
+    /**
+     * @brief Compile the application of the unary Op to an argument of type From, or nullptr.
+     */
+    template <typename From, typename To, typename Op>
+    Own<TypedExpression<To>> compileTypedUnary(const ram::Expression& arg);
+
+    /**
+     * @brief Compile an expression to an operand of a typed evaluator in the type T, returning false
+     * if it is not a constant, a tuple element, or a functor compiling to a typed evaluator.
+     */
+    template <typename T>
+    bool compileTypedOperand(const ram::Expression& expr, TypedOperand<T>& operand);
+
+    /**
+     * @brief Return the plan for evaluating a scan a batch of tuples at a time, given the node generated
+     * for its nested operation. The plan has no nested operation if the scan is evaluated tuple at a time.
+     */
+    BatchPlan planBatch(const ram::RelationOperation& scan, const Node* nested);
+
     /** Environment encoding, store a mapping from ram::Node to its operation index id. */
     std::unordered_map<const ram::Node*, std::size_t> indexTable;
     /** Points to the current viewContext during the generation.
@@ -349,11 +438,18 @@ private:
     std::unordered_map<const ram::Node*, std::size_t> viewTable;
     /** Environment encoding, store a mapping from ram::Relation to its id */
     std::unordered_map<std::string, std::size_t> relTable;
+    /** Ids of the relations accessed by the tree under generation */
+    std::set<std::size_t> accessedRelations;
     /** name / relation mapping */
     std::unordered_map<std::string, const ram::Relation*> relationMap;
     /** ordering context */
     OrderingContext orderingContext = OrderingContext(*this);
     /** Reference to the engine instance */
     Engine& engine;
+    /** Whether constraints and functors are fused, or compiled to typed evaluators, unless disabled by
+     * the key "disable-fusion" */
+    bool fusionEnabled = !Global::config().has("disable-fusion");
+    /** Whether scans are evaluated a batch at a time, unless disabled by the key "disable-batching" */
+    bool batchingEnabled = !Global::config().has("disable-batching");
 };
 }  // namespace souffle::interpreter
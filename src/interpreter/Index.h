@@ -22,6 +22,7 @@
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/MiscUtil.h"
 #include "souffle/utility/StreamUtil.h"
+#include "souffle/utility/span.h"
 #include <array>
 #include <atomic>
 #include <cassert>
@@ -229,6 +230,13 @@ public:
         return data.size();
     }
 
+    /**
+     * Determines the amount of memory used by this index.
+     */
+    std::size_t getMemoryUsage() const {
+        return data.getMemoryUsage();
+    }
+
     /**
      * Inserts a tuple into this index.
      */
@@ -401,6 +409,10 @@ public:
         return data ? 1 : 0;
     }
 
+    std::size_t getMemoryUsage() const {
+        return sizeof(data);
+    }
+
     bool insert(const Tuple& /* t */) {
         return data = true;
     }
@@ -459,6 +471,185 @@ public:
     void extend(EqrelIndex* otherIndex) {
         this->data.extend(otherIndex->data);
     }
+
+    /**
+     * Visit each element with the representative of its class.
+     */
+    template <typename F>
+    void forEachClassMember(F&& f) const {
+        this->data.forEachClassMember(std::forward<F>(f));
+    }
+
+    /**
+     * Insert an element together with a member of its class.
+     */
+    void insertClassMember(RamDomain element, RamDomain representative) {
+        this->data.insertClassMember(element, representative);
+    }
+};
+
+/**
+ * An index of a relation whose arity is only known at runtime.
+ *
+ * The engine is not instantiated per arity for such relations. Instead, this interface
+ * forwards to a data structure of the actual arity and passes tuples as pointers to their
+ * columns in the order of the index. Brie relations are stored in tries of the actual arity,
+ * instantiated in BrieIndex.cpp, and btree relations of the arities not instantiated by the
+ * engine in a runtime-arity btree, see BTreeIndex.cpp. Provenance relations with compact
+ * annotations are stored in runtime-arity btrees as well, see ProvenanceIndex.cpp.
+ */
+class DynamicIndex {
+public:
+    /**
+     * A position within a range of the data structure, implemented per data structure.
+     */
+    class Cursor {
+    public:
+        virtual ~Cursor() = default;
+
+        /** Returns the current tuple, or nullptr at the end of the range. */
+        virtual const RamDomain* get() const = 0;
+
+        /** Advances to the next tuple and returns it, or nullptr at the end of the range. */
+        virtual const RamDomain* next() = 0;
+
+        virtual Own<Cursor> clone() const = 0;
+
+        /** Tests whether both cursors are at the same position of the data structure. */
+        virtual bool equal(const Cursor& other) const = 0;
+    };
+
+    /**
+     * An iterator over the tuples of a range, yielding spans of the arity of the index.
+     * A default constructed iterator marks the end of any range.
+     */
+    class iterator {
+        Own<Cursor> cursor;
+        const RamDomain* current = nullptr;
+        std::size_t arity = 0;
+
+    public:
+        iterator() = default;
+        iterator(Own<Cursor> cursor, std::size_t arity)
+                : cursor(std::move(cursor)), current(this->cursor->get()), arity(arity) {}
+        iterator(const iterator& other)
+                : cursor(other.cursor ? other.cursor->clone() : nullptr), current(nullptr),
+                  arity(other.arity) {
+            current = cursor ? cursor->get() : nullptr;
+        }
+        iterator(iterator&& other) = default;
+
+        iterator& operator=(const iterator& other) {
+            if (this != &other) {
+                cursor = other.cursor ? other.cursor->clone() : nullptr;
+                current = cursor ? cursor->get() : nullptr;
+                arity = other.arity;
+            }
+            return *this;
+        }
+        iterator& operator=(iterator&& other) = default;
+
+        span<const RamDomain> operator*() const {
+            return {current, arity};
+        }
+
+        iterator& operator++() {
+            current = cursor->next();
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            if (current == nullptr || other.current == nullptr) {
+                return current == other.current;
+            }
+            return cursor->equal(*other.cursor);
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * A view on the index caching the access patterns of a thread in its operation hints.
+     * For Brie relations, the bounds of a range must fix a prefix of the columns and leave
+     * the others unbounded, as only equality searches are indexed for them.
+     */
+    class View : public ViewWrapper {
+    public:
+        virtual bool contains(const RamDomain* entry) = 0;
+
+        virtual souffle::range<iterator> range(const RamDomain* low, const RamDomain* high) = 0;
+
+        template <std::size_t Arity>
+        bool contains(const Tuple<RamDomain, Arity>& entry) {
+            return contains(entry.data());
+        }
+
+        template <std::size_t Arity>
+        bool contains(const Tuple<RamDomain, Arity>& low, const Tuple<RamDomain, Arity>& high) {
+            return !range(low.data(), high.data()).empty();
+        }
+
+        template <std::size_t Arity>
+        souffle::range<iterator> range(
+                const Tuple<RamDomain, Arity>& low, const Tuple<RamDomain, Arity>& high) {
+            return range(low.data(), high.data());
+        }
+    };
+
+    DynamicIndex(Order order) : order(std::move(order)) {}
+    virtual ~DynamicIndex() = default;
+
+    Order getOrder() const {
+        return order;
+    }
+
+    std::size_t getArity() const {
+        return order.size();
+    }
+
+    virtual Own<View> createView() const = 0;
+
+    virtual bool empty() const = 0;
+
+    virtual std::size_t size() const = 0;
+
+    virtual std::size_t getMemoryUsage() const = 0;
+
+    /** Inserts a tuple given in the order of the relation. */
+    virtual bool insert(const RamDomain* tuple) = 0;
+
+    /** Tests whether a tuple given in the order of the index is present. */
+    virtual bool contains(const RamDomain* entry) const = 0;
+
+    virtual souffle::range<iterator> scan() const = 0;
+
+    virtual std::vector<souffle::range<iterator>> partitionScan(int partitionCount) const = 0;
+
+    virtual void clear() = 0;
+
+protected:
+    Order order;
 };
 
+/**
+ * Creates a trie index of the given arity, which must be between 1 and MAX_BRIE_ARITY.
+ */
+Own<DynamicIndex> createBrieIndex(std::size_t arity, Order order);
+
+/**
+ * Creates a runtime-arity btree index of the given arity, which must not exceed MAX_DYNAMIC_ARITY.
+ */
+Own<DynamicIndex> createDynamicBTreeIndex(std::size_t arity, Order order);
+
+/**
+ * Creates an index of a provenance relation whose annotations, i.e. its auxiliary columns, are
+ * not part of the keys. The main index, created first and given to the others, stores the
+ * annotations next to its keys; the other indexes only store the remaining columns and look
+ * the annotations up in the main index.
+ */
+Own<DynamicIndex> createCompactProvenanceIndex(
+        std::size_t auxiliaryArity, Order order, const DynamicIndex* main = nullptr);
+
 }  // namespace souffle::interpreter
@@ -0,0 +1,36 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file LatticeIndex.cpp
+ *
+ * Interpreter index for relations retaining the least last column per key.
+ *
+ ***********************************************************************/
+
+#include "interpreter/Relation.h"
+
+namespace souffle::interpreter {
+
+#define CREATE_LATTICE_REL(Structure, Arity, ...)                      \
+    case (Arity): {                                                    \
+        return mk<Relation<Arity, interpreter::Lattice>>(              \
+                id.getAuxiliaryArity(), id.getName(), indexSelection); \
+    }
+
+Own<RelationWrapper> createLatticeRelation(
+        const ram::Relation& id, const ram::analysis::IndexCluster& indexSelection) {
+    switch (id.getArity()) {
+        FOR_EACH_LATTICE(CREATE_LATTICE_REL);
+
+        default: fatal("Requested arity not yet supported for min relations. Feel free to add it.");
+    }
+}
+
+}  // namespace souffle::interpreter
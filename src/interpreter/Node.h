@@ -43,6 +43,7 @@ class Node;
 }
 
 namespace interpreter {
+class Context;
 class ViewContext;
 struct RelationWrapper;
 
@@ -70,7 +71,12 @@ struct RelationWrapper;
     FOR_EACH(Expand, RelationSize)\
     FOR_EACH(Expand, ExistenceCheck)\
     FOR_EACH_PROVENANCE(Expand, ProvenanceExistenceCheck)\
+    FOR_EACH_DYNAMIC_PROVENANCE(Expand, ProvenanceExistenceCheck)\
     Forward(Constraint)\
+    Forward(FusedConstraint)\
+    Forward(FusedOperator)\
+    Forward(TypedConstraint)\
+    Forward(TypedOperator)\
     Forward(TupleOperation)\
     FOR_EACH(Expand, Scan)\
     FOR_EACH(Expand, ParallelScan)\
@@ -85,6 +91,7 @@ struct RelationWrapper;
     FOR_EACH(Expand, ParallelAggregate)\
     FOR_EACH(Expand, IndexAggregate)\
     FOR_EACH(Expand, ParallelIndexAggregate)\
+    FOR_EACH(Expand, GroupAggregate)\
     Forward(Break)\
     Forward(Filter)\
     FOR_EACH(Expand, GuardedInsert)\
@@ -99,6 +106,7 @@ struct RelationWrapper;
     Forward(DebugInfo)\
     FOR_EACH(Expand, Clear)\
     Forward(LogSize)\
+    Forward(LogMemory)\
     Forward(IO)\
     Forward(Query)\
     Forward(Extend)\
@@ -132,6 +140,23 @@ enum NodeType {
  *
  * Add reflective from string to NodeType.
  */
+/**
+ * Whether a relation is stored in tries, which is the case for Brie relations of the arities
+ * supported by Relation<Dynamic, Brie>; the others are stored in btrees.
+ */
+inline bool isBrie(const ram::Relation& rel) {
+    return rel.getRepresentation() == RelationRepresentation::BRIE && rel.getArity() > 0 &&
+           rel.getArity() <= MAX_BRIE_ARITY && !Global::config().has("provenance");
+}
+
+/**
+ * Whether the annotations of provenance relations are stored out of line, i.e. provenance
+ * relations are evaluated as Relation<Dynamic, Provenance>.
+ */
+inline bool hasCompactProvenance() {
+    return Global::config().has("provenance") && Global::config().get("provenance-storage") == "compact";
+}
+
 inline NodeType constructNodeType(std::string tokBase, const ram::Relation& rel) {
     static bool isProvenance = Global::config().has("provenance");
 
@@ -142,8 +167,16 @@ inline NodeType constructNodeType(std::string tokBase, const ram::Relation& rel)
     std::string arity = std::to_string(rel.getArity());
     if (rel.getRepresentation() == RelationRepresentation::EQREL) {
         return map.at("I_" + tokBase + "_Eqrel_" + arity);
+    } else if (rel.getRepresentation() == RelationRepresentation::MIN) {
+        return map.at("I_" + tokBase + "_Lattice_" + arity);
+    } else if (isProvenance && hasCompactProvenance()) {
+        return map.at("I_" + tokBase + "_Provenance_Dynamic");
     } else if (isProvenance) {
         return map.at("I_" + tokBase + "_Provenance_" + arity);
+    } else if (isBrie(rel)) {
+        return map.at("I_" + tokBase + "_Brie_Dynamic");
+    } else if (!isBTreeArity(rel.getArity())) {
+        return map.at("I_" + tokBase + "_Btree_Dynamic");
     } else {
         return map.at("I_" + tokBase + "_Btree_" + arity);
     }
@@ -585,6 +618,145 @@ class Constraint : public BinaryNode {
     using BinaryNode::BinaryNode;
 };
 
+/**
+ * @brief Shapes of the operands of fused nodes, see FusedTerm
+ */
+enum class FusedShape { Constant, Element, Offset };
+
+/**
+ * @class FusedTerm
+ * @brief Operand of a fused node: a constant, a tuple element, or a tuple element offset by a constant.
+ *        Which of them it is, is encoded in the evaluator of the node.
+ */
+struct FusedTerm {
+    std::size_t tupleId = 0;
+    std::size_t element = 0;
+    RamDomain constant = 0;
+};
+
+/**
+ * @class FusedOperation
+ * @brief A binary constraint or functor over two simple operands, which is evaluated by a function
+ *        specialised for its operator and the shapes of its operands, such that the operands are
+ *        not dispatched through the interpreter.
+ */
+class FusedOperation : public Node {
+public:
+    using Evaluator = RamDomain (*)(const FusedOperation&, Context&);
+
+    FusedOperation(enum NodeType ty, const ram::Node* sdw, Evaluator evaluator, FusedTerm lhs, FusedTerm rhs)
+            : Node(ty, sdw), evaluator(evaluator), lhs(lhs), rhs(rhs) {}
+
+    inline RamDomain evaluate(Context& ctxt) const {
+        return evaluator(*this, ctxt);
+    }
+
+    inline const FusedTerm& getLhs() const {
+        return lhs;
+    }
+
+    inline const FusedTerm& getRhs() const {
+        return rhs;
+    }
+
+private:
+    Evaluator evaluator;
+    FusedTerm lhs;
+    FusedTerm rhs;
+};
+
+/**
+ * @class FusedConstraint
+ */
+class FusedConstraint : public FusedOperation {
+    using FusedOperation::FusedOperation;
+};
+
+/**
+ * @class FusedOperator
+ */
+class FusedOperator : public FusedOperation {
+    using FusedOperation::FusedOperation;
+};
+
+/**
+ * @class TypedEvaluator
+ * @brief Root of a tree of evaluator objects, which the generator compiles from a numeric expression
+ *        or constraint. The objects of the tree are specialised for their operator and type, and
+ *        pass values in that type, such that only the root converts its value to a RamDomain.
+ */
+class TypedEvaluator {
+public:
+    virtual ~TypedEvaluator() = default;
+
+    virtual RamDomain evaluate(Context& ctxt) const = 0;
+};
+
+/**
+ * @class TypedExpression
+ * @brief An evaluator of an expression in the type T, which is RamSigned, RamUnsigned, or RamFloat.
+ */
+template <typename T>
+class TypedExpression : public TypedEvaluator {
+public:
+    virtual T evaluateTyped(Context& ctxt) const = 0;
+
+    RamDomain evaluate(Context& ctxt) const override {
+        return ramBitCast(evaluateTyped(ctxt));
+    }
+};
+
+/**
+ * @brief Shapes of the operands of typed evaluators, see TypedOperand
+ */
+enum class TypedShape { Constant, Element, Expression };
+
+/**
+ * @class TypedOperand
+ * @brief Operand of a typed evaluator: a constant, a tuple element, or a nested typed expression.
+ *        Constants and tuple elements are read by the evaluator itself, and which of them it is,
+ *        is encoded in the type of the evaluator.
+ */
+template <typename T>
+struct TypedOperand {
+    TypedShape shape = TypedShape::Constant;
+    T constant = 0;
+    std::size_t tupleId = 0;
+    std::size_t element = 0;
+    Own<TypedExpression<T>> expression;
+};
+
+/**
+ * @class TypedOperation
+ * @brief A constraint or functor evaluated by its compiled tree of typed evaluators.
+ */
+class TypedOperation : public Node {
+public:
+    TypedOperation(enum NodeType ty, const ram::Node* sdw, Own<TypedEvaluator> evaluator)
+            : Node(ty, sdw), evaluator(std::move(evaluator)) {}
+
+    inline RamDomain evaluate(Context& ctxt) const {
+        return evaluator->evaluate(ctxt);
+    }
+
+private:
+    Own<TypedEvaluator> evaluator;
+};
+
+/**
+ * @class TypedConstraint
+ */
+class TypedConstraint : public TypedOperation {
+    using TypedOperation::TypedOperation;
+};
+
+/**
+ * @class TypedOperator
+ */
+class TypedOperator : public TypedOperation {
+    using TypedOperation::TypedOperation;
+};
+
 /**
  * @class TupleOperation
  */
@@ -595,10 +767,37 @@ class TupleOperation : public UnaryNode {
 /**
  * @class Scan
  */
+/**
+ * @class BatchPlan
+ * @brief Plan of a scan which is evaluated a batch of tuples at a time. The conditions of the filters
+ *        leading its nested operation narrow a selection of the tuples of a batch, one condition at a
+ *        time, before the operation following the filters is executed for each selected tuple.
+ */
+struct BatchPlan {
+    /** Arity of the scanned relation */
+    std::size_t arity = 0;
+    /** Conjunctive terms of the conditions of the filters, owned by the nested operation */
+    std::vector<const Node*> conditions;
+    /** Operation following the filters, owned by the nested operation */
+    const Node* nested = nullptr;
+};
+
 class Scan : public Node, public NestedOperation, public RelationalOperation {
 public:
     Scan(enum NodeType ty, const ram::Node* sdw, RelationHandle* relHandle, Own<Node> nested)
             : Node(ty, sdw), NestedOperation(std::move(nested)), RelationalOperation(relHandle) {}
+
+    /** @brief Return the plan for batch-at-a-time evaluation, or nullptr if the scan has none */
+    inline const BatchPlan* getBatchPlan() const {
+        return batchPlan.nested == nullptr ? nullptr : &batchPlan;
+    }
+
+    void setBatchPlan(BatchPlan plan) {
+        batchPlan = std::move(plan);
+    }
+
+private:
+    BatchPlan batchPlan;
 };
 
 /**
@@ -728,6 +927,25 @@ class ParallelIndexAggregate : public IndexAggregate, public AbstractParallel {
     using IndexAggregate::IndexAggregate;
 };
 
+/**
+ * @class GroupAggregate
+ */
+class GroupAggregate : public Aggregate, public ViewOperation {
+public:
+    GroupAggregate(enum NodeType ty, const ram::Node* sdw, RelationHandle* relHandle, Own<Node> expr,
+            Own<Node> filter, Own<Node> nested, std::size_t viewId, std::vector<std::size_t> groupPositions)
+            : Aggregate(ty, sdw, relHandle, std::move(expr), std::move(filter), std::move(nested)),
+              ViewOperation(viewId), groupPositions(std::move(groupPositions)) {}
+
+    /** @brief Get the positions of the group columns in the tuples of the index */
+    const std::vector<std::size_t>& getGroupPositions() const {
+        return groupPositions;
+    }
+
+protected:
+    const std::vector<std::size_t> groupPositions;
+};
+
 /**
  * @class Break
  */
@@ -857,6 +1075,23 @@ public:
             : Node(ty, sdw), RelationalOperation(handle) {}
 };
 
+/**
+ * @class LogMemory
+ */
+class LogMemory : public Node, public RelationalOperation {
+public:
+    LogMemory(enum NodeType ty, const ram::Node* sdw, RelationHandle* handle, std::string structure)
+            : Node(ty, sdw), RelationalOperation(handle), structure(std::move(structure)) {}
+
+    /** @brief get the name of the data structure of the indexes */
+    const std::string& getStructure() const {
+        return structure;
+    }
+
+private:
+    const std::string structure;
+};
+
 /**
  * @class IO
  */
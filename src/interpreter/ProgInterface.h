@@ -23,12 +23,14 @@
 #include "ram/Node.h"
 #include "ram/Program.h"
 #include "ram/Relation.h"
+#include "ram/SubroutineArgument.h"
 #include "ram/TranslationUnit.h"
 #include "ram/utility/Visitor.h"
 #include "souffle/RamTypes.h"
 #include "souffle/SouffleInterface.h"
 #include "souffle/SymbolTable.h"
 #include "souffle/utility/MiscUtil.h"
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -73,6 +75,11 @@ public:
         return RelInterface::iterator(mk<RelInterface::iterator_base>(id, this, relation.end()));
     }
 
+    /** Visit tuples block-wise */
+    void forEachBlock(const block_callback& callback, std::size_t blockSize = 1024) const override {
+        relation.forEachBlock(callback, blockSize);
+    }
+
     /** Get name */
     std::string getName() const override {
         return name;
@@ -247,6 +254,14 @@ public:
             addRelation(rel.getName(), *interface, input, output);
             id++;
         }
+
+        for (const auto& sub : prog.getSubroutines()) {
+            std::size_t numArgs = 0;
+            visit(*sub.second, [&](const ram::SubroutineArgument& arg) {
+                numArgs = std::max(numArgs, arg.getArgument() + 1);
+            });
+            addSubroutine(sub.first, numArgs);
+        }
     }
     ~ProgInterface() override {
         for (auto* interface : interfaces) {
@@ -14,10 +14,226 @@
  *
  ***********************************************************************/
 
+#include "interpreter/DynamicBTree.h"
 #include "interpreter/Relation.h"
+#include "ram/Relation.h"
+#include "ram/analysis/Index.h"
+#include "souffle/utility/MiscUtil.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
 
 namespace souffle::interpreter {
 
+namespace {
+
+/**
+ * An index of a provenance relation storing the annotations out of line.
+ *
+ * The annotations are the auxiliary columns of the relation, i.e. the rule number and the
+ * height of the proof of a tuple. As they are never searched for, they follow the other
+ * columns in the order of every index, which is keyed by the other columns only: the main
+ * index stores the annotations as payloads of its keys, retaining the least annotation per
+ * key as Provenance does, and the other indexes look them up in the main index. Tuples are
+ * yielded with their annotations, assembled in a buffer of the cursor.
+ */
+class CompactProvenanceIndex : public DynamicIndex {
+    using TreeIterator = DynamicBTree::iterator;
+
+    // the number of columns preceding the annotations
+    const std::size_t keyArity;
+
+    const std::size_t auxiliaryArity;
+
+    // the index storing the annotations, or nullptr for the main index
+    const CompactProvenanceIndex* main;
+
+    // the positions of the key columns of the main index within the keys of this index
+    std::vector<std::size_t> toMain;
+
+    DynamicBTree data;
+
+    class Cursor : public DynamicIndex::Cursor {
+        const CompactProvenanceIndex& index;
+        TreeIterator cur;
+        TreeIterator last;
+        std::vector<RamDomain> tuple;
+
+        void load() {
+            if (cur != last) {
+                std::copy_n((*cur).data(), index.keyArity, tuple.begin());
+                index.loadAnnotation(cur, tuple.data() + index.keyArity);
+            }
+        }
+
+    public:
+        Cursor(const CompactProvenanceIndex& index, TreeIterator cur, TreeIterator last)
+                : index(index), cur(cur), last(last), tuple(index.getArity()) {
+            load();
+        }
+
+        const RamDomain* get() const override {
+            return cur == last ? nullptr : tuple.data();
+        }
+
+        const RamDomain* next() override {
+            ++cur;
+            load();
+            return get();
+        }
+
+        Own<DynamicIndex::Cursor> clone() const override {
+            return mk<Cursor>(index, cur, last);
+        }
+
+        bool equal(const DynamicIndex::Cursor& other) const override {
+            return cur == static_cast<const Cursor&>(other).cur;
+        }
+    };
+
+    souffle::range<iterator> wrap(TreeIterator begin, TreeIterator end) const {
+        if (begin == end) {
+            return {iterator(), iterator()};
+        }
+        return {iterator(mk<Cursor>(*this, begin, end), getArity()), iterator()};
+    }
+
+    class View : public DynamicIndex::View {
+        const CompactProvenanceIndex& index;
+
+    public:
+        View(const CompactProvenanceIndex& index) : index(index) {}
+
+        bool contains(const RamDomain* entry) override {
+            return index.contains(entry);
+        }
+
+        souffle::range<iterator> range(const RamDomain* low, const RamDomain* high) override {
+            return index.range(low, high);
+        }
+    };
+
+    /**
+     * Copies the annotation of the tuple at the given position to the given address.
+     */
+    void loadAnnotation(TreeIterator pos, RamDomain* annotation) const {
+        if (main == nullptr) {
+            std::copy_n(pos.payload().data(), auxiliaryArity, annotation);
+            return;
+        }
+        RamDomain key[MAX_DYNAMIC_ARITY];
+        for (std::size_t i = 0; i < keyArity; ++i) {
+            key[i] = (*pos)[toMain[i]];
+        }
+        auto found = main->data.find(key);
+        assert(found != main->data.end() && "tuple missing in main index");
+        std::copy_n(found.payload().data(), auxiliaryArity, annotation);
+    }
+
+public:
+    CompactProvenanceIndex(std::size_t auxiliaryArity, Order order, const CompactProvenanceIndex* main)
+            : DynamicIndex(order), keyArity(order.size() - auxiliaryArity), auxiliaryArity(auxiliaryArity),
+              main(main), data(keyArity, main == nullptr ? auxiliaryArity : 0) {
+        if (main != nullptr) {
+            std::vector<std::size_t> positions(order.size());
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                positions[order[i]] = i;
+            }
+            for (std::size_t i = 0; i < keyArity; ++i) {
+                toMain.push_back(positions[main->order[i]]);
+            }
+        }
+    }
+
+    Own<DynamicIndex::View> createView() const override {
+        return mk<View>(*this);
+    }
+
+    bool empty() const override {
+        return data.empty();
+    }
+
+    std::size_t size() const override {
+        return data.size();
+    }
+
+    std::size_t getMemoryUsage() const override {
+        return data.getMemoryUsage();
+    }
+
+    bool insert(const RamDomain* tuple) override {
+        RamDomain entry[MAX_DYNAMIC_ARITY];
+        for (std::size_t i = 0; i < keyArity; ++i) {
+            entry[i] = tuple[order[i]];
+        }
+        // the annotations are the last columns of the relation
+        return data.insert(entry, main == nullptr ? tuple + keyArity : nullptr);
+    }
+
+    bool contains(const RamDomain* entry) const override {
+        auto pos = data.find(entry);
+        if (pos == data.end()) {
+            return false;
+        }
+        RamDomain annotation[MAX_DYNAMIC_ARITY];
+        loadAnnotation(pos, annotation);
+        return std::equal(annotation, annotation + auxiliaryArity, entry + keyArity);
+    }
+
+    souffle::range<iterator> range(const RamDomain* low, const RamDomain* high) const {
+        // the annotations are not searched for, hence unbounded
+        for (std::size_t i = keyArity; i < getArity(); ++i) {
+            assert(low[i] == MIN_RAM_SIGNED && high[i] == MAX_RAM_SIGNED && "annotation searched for");
+        }
+        if (data.compare(low, high) > 0) {
+            return {iterator(), iterator()};
+        }
+        return wrap(data.lower_bound(low), data.upper_bound(high));
+    }
+
+    souffle::range<iterator> scan() const override {
+        return wrap(data.begin(), data.end());
+    }
+
+    std::vector<souffle::range<iterator>> partitionScan(int partitionCount) const override {
+        std::vector<souffle::range<iterator>> res;
+        for (const auto& chunk : data.partition(partitionCount)) {
+            res.push_back(wrap(chunk.first, chunk.second));
+        }
+        return res;
+    }
+
+    void clear() override {
+        data.clear();
+    }
+};
+
+}  // namespace
+
+Own<DynamicIndex> createCompactProvenanceIndex(
+        std::size_t auxiliaryArity, Order order, const DynamicIndex* main) {
+    if (order.size() > MAX_DYNAMIC_ARITY) {
+        fatal("Requested arity not supported by compact provenance relations.");
+    }
+    for (std::size_t i = order.size() - auxiliaryArity; i < order.size(); ++i) {
+        if (order[i] != i) {
+            fatal("Auxiliary columns of compact provenance relations cannot be searched for.");
+        }
+    }
+    return mk<CompactProvenanceIndex>(
+            auxiliaryArity, std::move(order), static_cast<const CompactProvenanceIndex*>(main));
+}
+
+Own<RelationWrapper> createCompactProvenanceRelation(
+        const ram::Relation& id, const ram::analysis::IndexCluster& indexSelection) {
+    if (id.getArity() > MAX_DYNAMIC_ARITY) {
+        fatal("Requested arity not yet supported. Feel free to add it.");
+    }
+    return mk<Relation<Dynamic, interpreter::Provenance>>(
+            id.getArity(), id.getAuxiliaryArity(), id.getName(), indexSelection);
+}
+
 #define CREATE_PROVENANCE_REL(Structure, Arity, ...)                   \
     case (Arity): {                                                    \
         return mk<Relation<Arity, interpreter::Provenance>>(           \
@@ -21,9 +21,12 @@
 #include "souffle/RamTypes.h"
 #include "souffle/SouffleInterface.h"
 #include "souffle/utility/MiscUtil.h"
+#include <algorithm>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <deque>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <set>
@@ -113,6 +116,31 @@ public:
 
     virtual void purge() = 0;
 
+    /**
+     * Approximate number of bytes occupied by the tuples of all indexes.
+     */
+    virtual std::size_t getMemoryUsage() const = 0;
+
+    /**
+     * Visit all tuples in blocks of decoded, contiguously stored tuples.
+     */
+    virtual void forEachBlock(
+            const souffle::Relation::block_callback& callback, std::size_t blockSize) const = 0;
+
+    /**
+     * Visit each element of an equivalence relation with the representative of its class.
+     */
+    virtual void forEachClassMember(const std::function<void(RamDomain, RamDomain)>&) const {
+        fatal("relation %s is not an equivalence relation", relName);
+    }
+
+    /**
+     * Insert an element of an equivalence relation together with a member of its class.
+     */
+    virtual void insertClassMember(RamDomain, RamDomain) {
+        fatal("relation %s is not an equivalence relation", relName);
+    }
+
     const std::string& getName() const {
         return relName;
     }
@@ -134,6 +162,16 @@ public:
      */
     virtual Order getIndexOrder(std::size_t) const = 0;
 
+    /**
+     * Return the number of indexes.
+     */
+    virtual std::size_t getNumberOfIndexes() const = 0;
+
+    /**
+     * Return the number of bytes used by an index.
+     */
+    virtual std::size_t getIndexMemoryUsage(std::size_t) const = 0;
+
     /**
      * Obtains a view on an index of this relation, facilitating hint-supported accesses.
      *
@@ -229,10 +267,22 @@ public:
         return __size();
     }
 
+    std::size_t getMemoryUsage() const override {
+        return __size() * Arity * sizeof(RamDomain) * indexes.size();
+    }
+
     Order getIndexOrder(std::size_t idx) const override {
         return indexes[idx]->getOrder();
     }
 
+    std::size_t getNumberOfIndexes() const override {
+        return indexes.size();
+    }
+
+    std::size_t getIndexMemoryUsage(std::size_t idx) const override {
+        return indexes[idx]->getMemoryUsage();
+    }
+
     class iterator_base : public RelationWrapper::iterator_base {
         iterator iter;
         Order order;
@@ -276,6 +326,28 @@ public:
         return Iterator(new iterator_base(main->end(), main->getOrder()));
     }
 
+    void forEachBlock(
+            const souffle::Relation::block_callback& callback, std::size_t blockSize) const override {
+        const Order& order = main->getOrder();
+        blockSize = std::max<std::size_t>(blockSize, 1);
+        std::vector<RamDomain> buffer(blockSize * Arity);
+        std::size_t rows = 0;
+        for (const auto& tuple : main->scan()) {
+            RamDomain* row = buffer.data() + rows * Arity;
+            // Not using constexpr Arity to avoid compiler warning. (When Arity == 0)
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                row[order[i]] = tuple[i];
+            }
+            if (++rows == blockSize) {
+                callback(buffer.data(), rows);
+                rows = 0;
+            }
+        }
+        if (rows > 0) {
+            callback(buffer.data(), rows);
+        }
+    }
+
     // -----
     // Following section defines and implement interfaces for interpreter execution.
     //
@@ -403,6 +475,284 @@ protected:
     Index* main;
 };
 
+/**
+ * A relation whose arity is only known at runtime.
+ *
+ * Relations of this type share their evaluation code, so that the engine is only
+ * instantiated once for them. The engine passes tuples in buffers of MAX_DYNAMIC_ARITY
+ * columns, of which the first getArity() are used, and iterates them as spans; the
+ * indexes forward to data structures of the actual arity, see DynamicIndex.
+ */
+class DynamicRelation : public RelationWrapper {
+public:
+    static constexpr std::size_t Arity = MAX_DYNAMIC_ARITY;
+    using Index = DynamicIndex;
+    using Tuple = souffle::Tuple<RamDomain, Arity>;
+    using View = DynamicIndex::View;
+    using iterator = DynamicIndex::iterator;
+
+    // The type of index factory functions.
+    using IndexFactory = Own<DynamicIndex> (*)(std::size_t arity, Order order);
+
+    /**
+     * Cast an abstract view into a view of a dynamic index.
+     */
+    static View* castView(ViewWrapper* view) {
+        return static_cast<View*>(view);
+    }
+
+    DynamicRelation(arity_type arity, std::size_t auxiliaryArity, const std::string& name,
+            const ram::analysis::IndexCluster& indexSelection, IndexFactory createIndex)
+            : DynamicRelation(arity, auxiliaryArity, name) {
+        for (const auto& order : getTotalOrders(indexSelection)) {
+            indexes.push_back(createIndex(arity, order));
+        }
+
+        // Use the first index as default main index
+        main = indexes[0].get();
+    }
+
+    DynamicRelation(DynamicRelation& other) = delete;
+
+    // -- Implement all virtual interface from Wrapper. --
+public:
+    void purge() override {
+        __purge();
+    }
+
+    void insert(const RamDomain* data) override {
+        for (auto& index : indexes) {
+            index->insert(data);
+        }
+    }
+
+    bool contains(const RamDomain* data) const override {
+        RamDomain entry[Arity];
+        const Order& order = main->getOrder();
+        for (std::size_t i = 0; i < arity; ++i) {
+            entry[i] = data[order[i]];
+        }
+        return main->contains(entry);
+    }
+
+    IndexViewPtr createView(const std::size_t& indexPos) const override {
+        return indexes[indexPos]->createView();
+    }
+
+    std::size_t size() const override {
+        return main->size();
+    }
+
+    std::size_t getMemoryUsage() const override {
+        // as for the other relations, the tuples are accounted for, but not the empty tries
+        if (main->empty()) {
+            return 0;
+        }
+        std::size_t res = 0;
+        for (const auto& index : indexes) {
+            res += index->getMemoryUsage();
+        }
+        return res;
+    }
+
+    Order getIndexOrder(std::size_t idx) const override {
+        return indexes[idx]->getOrder();
+    }
+
+    std::size_t getNumberOfIndexes() const override {
+        return indexes.size();
+    }
+
+    std::size_t getIndexMemoryUsage(std::size_t idx) const override {
+        return indexes[idx]->getMemoryUsage();
+    }
+
+    class iterator_base : public RelationWrapper::iterator_base {
+        iterator iter;
+        Order order;
+        RamDomain data[Arity];
+
+    public:
+        iterator_base(iterator iter, Order order) : iter(std::move(iter)), order(std::move(order)) {}
+
+        iterator_base& operator++() override {
+            ++iter;
+            return *this;
+        }
+
+        const RamDomain* operator*() override {
+            const auto& tuple = *iter;
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                data[order[i]] = tuple[i];
+            }
+            return data;
+        }
+
+        iterator_base* clone() const override {
+            return new iterator_base(iter, order);
+        }
+
+        bool equal(const RelationWrapper::iterator_base& other) const override {
+            if (auto* o = as<iterator_base>(other)) {
+                return iter == o->iter;
+            }
+            return false;
+        }
+    };
+
+    Iterator begin() const override {
+        return Iterator(new iterator_base(main->scan().begin(), main->getOrder()));
+    }
+
+    Iterator end() const override {
+        return Iterator(new iterator_base(iterator(), main->getOrder()));
+    }
+
+    void forEachBlock(
+            const souffle::Relation::block_callback& callback, std::size_t blockSize) const override {
+        const Order& order = main->getOrder();
+        blockSize = std::max<std::size_t>(blockSize, 1);
+        std::vector<RamDomain> buffer(blockSize * arity);
+        std::size_t rows = 0;
+        for (const auto& tuple : main->scan()) {
+            RamDomain* row = buffer.data() + rows * arity;
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                row[order[i]] = tuple[i];
+            }
+            if (++rows == blockSize) {
+                callback(buffer.data(), rows);
+                rows = 0;
+            }
+        }
+        if (rows > 0) {
+            callback(buffer.data(), rows);
+        }
+    }
+
+    // -- Interfaces for interpreter execution, matching those of the other relations. --
+public:
+    /**
+     * Add the given tuple to this relation.
+     */
+    bool insert(const Tuple& tuple) {
+        // for provenance relations, the main index reports lowered annotations as insertions,
+        // which the other indexes ignore
+        if (!main->insert(tuple.data())) {
+            return false;
+        }
+        for (std::size_t i = 1; i < indexes.size(); ++i) {
+            indexes[i]->insert(tuple.data());
+        }
+        return true;
+    }
+
+    souffle::range<iterator> scan() const {
+        return main->scan();
+    }
+
+    std::vector<souffle::range<iterator>> partitionScan(std::size_t partitionCount) const {
+        return main->partitionScan(partitionCount);
+    }
+
+    /**
+     * Returns a partitioned list of iterators coving elements in range [low, high]
+     */
+    std::vector<souffle::range<iterator>> partitionRange(const std::size_t& indexPos, const Tuple& low,
+            const Tuple& high, std::size_t partitionCount) const {
+        auto view = indexes[indexPos]->createView();
+        return view->range(low, high).partition(partitionCount);
+    }
+
+    std::size_t __size() const {
+        return main->size();
+    }
+
+    bool empty() const {
+        return main->empty();
+    }
+
+    void __purge() {
+        for (auto& index : indexes) {
+            index->clear();
+        }
+    }
+
+protected:
+    /**
+     * Creates a relation without indexes, which are added by the subclass.
+     */
+    DynamicRelation(arity_type arity, std::size_t auxiliaryArity, const std::string& name)
+            : RelationWrapper(arity, auxiliaryArity, name) {
+        assert(arity <= MAX_DYNAMIC_ARITY && "arity not supported by dynamic relations");
+    }
+
+    /**
+     * Expands the orders of the selected indexes to total orders.
+     */
+    std::vector<Order> getTotalOrders(const ram::analysis::IndexCluster& indexSelection) const {
+        std::vector<Order> res;
+        for (const auto& order : indexSelection.getAllOrders()) {
+            ram::analysis::LexOrder fullOrder = order;
+            ram::analysis::AttributeSet set{order.begin(), order.end()};
+            for (std::size_t i = 0; i < arity; ++i) {
+                if (set.find(i) == set.end()) {
+                    fullOrder.push_back(i);
+                }
+            }
+            res.push_back(fullOrder);
+        }
+        return res;
+    }
+
+    // a map of managed indexes
+    VecOwn<DynamicIndex> indexes;
+
+    // a pointer to the main index within the managed index
+    DynamicIndex* main = nullptr;
+};
+
+/**
+ * A Brie relation of any arity, stored in tries of the actual arity.
+ */
+template <>
+class Relation<Dynamic, Brie> : public DynamicRelation {
+public:
+    Relation(arity_type arity, std::size_t auxiliaryArity, const std::string& name,
+            const ram::analysis::IndexCluster& indexSelection)
+            : DynamicRelation(arity, auxiliaryArity, name, indexSelection, createBrieIndex) {}
+};
+
+/**
+ * A btree relation of an arity for which the engine is not instantiated, stored in
+ * runtime-arity btrees.
+ */
+template <>
+class Relation<Dynamic, Btree> : public DynamicRelation {
+public:
+    Relation(arity_type arity, std::size_t auxiliaryArity, const std::string& name,
+            const ram::analysis::IndexCluster& indexSelection)
+            : DynamicRelation(arity, auxiliaryArity, name, indexSelection, createDynamicBTreeIndex) {}
+};
+
+/**
+ * A provenance relation whose annotations are stored out of line, such that its indexes
+ * have the width of the relation without the auxiliary columns, see
+ * createCompactProvenanceIndex. Provenance relations of all arities are evaluated as this
+ * relation type if the storage of annotations is compact, see hasCompactProvenance.
+ */
+template <>
+class Relation<Dynamic, Provenance> : public DynamicRelation {
+public:
+    Relation(arity_type arity, std::size_t auxiliaryArity, const std::string& name,
+            const ram::analysis::IndexCluster& indexSelection)
+            : DynamicRelation(arity, auxiliaryArity, name) {
+        for (const auto& order : getTotalOrders(indexSelection)) {
+            indexes.push_back(createCompactProvenanceIndex(auxiliaryArity, order, main));
+            main = indexes[0].get();
+        }
+    }
+};
+
 class EqrelRelation : public Relation<2, Eqrel> {
 public:
     using Relation<2, Eqrel>::Relation;
@@ -412,23 +762,40 @@ public:
         auto trg = static_cast<EqrelIndex*>(rel.main);
         src->extend(trg);
     }
+
+    void forEachClassMember(const std::function<void(RamDomain, RamDomain)>& f) const override {
+        static_cast<EqrelIndex*>(this->main)->forEachClassMember(f);
+    }
+
+    void insertClassMember(RamDomain element, RamDomain representative) override {
+        for (auto& index : this->indexes) {
+            static_cast<EqrelIndex*>(index.get())->insertClassMember(element, representative);
+        }
+    }
 };
 
 // The type of relation factory functions.
 using RelationFactory = Own<RelationWrapper> (*)(
         const ram::Relation& id, const ram::analysis::IndexCluster& indexSelection);
 
-// A factory for BTree based relation.
+// A factory for BTree based relation, falling back to Relation<Dynamic, Btree> for the
+// arities not instantiated by FOR_EACH_BTREE.
 Own<RelationWrapper> createBTreeRelation(
         const ram::Relation& id, const ram::analysis::IndexCluster& indexSelection);
 
 // A factory for BTree provenance index.
 Own<RelationWrapper> createProvenanceRelation(
         const ram::Relation& id, const ram::analysis::IndexCluster& indexSelection);
-// A factory for Brie based index.
+// A factory for provenance relations storing their annotations out of line.
+Own<RelationWrapper> createCompactProvenanceRelation(
+        const ram::Relation& id, const ram::analysis::IndexCluster& indexSelection);
+// A factory for Brie based relation, for arities between 1 and MAX_BRIE_ARITY.
 Own<RelationWrapper> createBrieRelation(
         const ram::Relation& id, const ram::analysis::IndexCluster& indexSelection);
 // A factory for Eqrel index.
 Own<RelationWrapper> createEqrelRelation(
         const ram::Relation& id, const ram::analysis::IndexCluster& indexSelection);
+// A factory for BTree index retaining the least last column per key.
+Own<RelationWrapper> createLatticeRelation(
+        const ram::Relation& id, const ram::analysis::IndexCluster& indexSelection);
 }  // namespace souffle::interpreter
@@ -0,0 +1,236 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file SpillManager.cpp
+ *
+ * Implements the spilling of interpreter relations to disk.
+ *
+ ***********************************************************************/
+
+#include "interpreter/SpillManager.h"
+#include "Global.h"
+#include "souffle/RamTypes.h"
+#include "souffle/utility/MiscUtil.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace souffle::interpreter {
+
+SpillManager::SpillManager(std::size_t budget, std::string directory)
+        : budget(budget), directory(std::move(directory)), verbose(Global::config().has("verbose")) {}
+
+SpillManager::~SpillManager() {
+    for (auto& [id, entry] : entries) {
+        if (!entry.file.empty()) {
+            unlink(entry.file.c_str());
+        }
+    }
+}
+
+std::size_t SpillManager::parseSize(const std::string& size) {
+    const std::size_t limit = std::numeric_limits<std::size_t>::max();
+    std::size_t value = 0;
+    std::size_t end = 0;
+    for (; end < size.size() && std::isdigit(static_cast<unsigned char>(size[end])); ++end) {
+        std::size_t digit = size[end] - '0';
+        if (value > (limit - digit) / 10) {
+            throw std::invalid_argument("memory size " + size + " is too large");
+        }
+        value = value * 10 + digit;
+    }
+    if (end == 0) {
+        throw std::invalid_argument("invalid memory size " + size);
+    }
+
+    std::string unit = size.substr(end);
+    std::transform(unit.begin(), unit.end(), unit.begin(),
+            [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    std::size_t scale = 1;
+    if (unit.empty() || unit == "B") {
+        scale = 1;
+    } else if (unit == "K" || unit == "KB") {
+        scale = std::size_t(1) << 10;
+    } else if (unit == "M" || unit == "MB") {
+        scale = std::size_t(1) << 20;
+    } else if (unit == "G" || unit == "GB") {
+        scale = std::size_t(1) << 30;
+    } else if (unit == "T" || unit == "TB") {
+        scale = std::size_t(1) << 40;
+    } else {
+        throw std::invalid_argument("invalid memory size " + size);
+    }
+    if (value > limit / scale) {
+        throw std::invalid_argument("memory size " + size + " is too large");
+    }
+    return value * scale;
+}
+
+std::string SpillManager::getDefaultDirectory() {
+    const char* directory = std::getenv("TMPDIR");
+    return directory != nullptr ? directory : "/tmp";
+}
+
+void SpillManager::registerRelation(std::size_t id, RelationHandle* handle) {
+    Entry entry;
+    entry.handle = handle;
+    entries[id] = entry;
+}
+
+void SpillManager::acquire(const std::set<std::size_t>& ids) {
+    ++tick;
+    for (std::size_t id : ids) {
+        auto it = entries.find(id);
+        if (it == entries.end()) {
+            continue;
+        }
+        Entry& entry = it->second;
+        if (!entry.file.empty()) {
+            restore(entry);
+        }
+        entry.pinned++;
+        entry.lastUse = tick;
+    }
+}
+
+void SpillManager::release(const std::set<std::size_t>& ids) {
+    for (std::size_t id : ids) {
+        auto it = entries.find(id);
+        if (it == entries.end()) {
+            continue;
+        }
+        Entry& entry = it->second;
+        if (entry.pinned > 0) {
+            entry.pinned--;
+        }
+        // only the released relations may have changed since their usage was cached
+        entry.usage = (*entry.handle)->getMemoryUsage();
+    }
+    if (started) {
+        enforceBudget();
+    }
+}
+
+void SpillManager::start() {
+    started = true;
+}
+
+void SpillManager::stop() {
+    started = false;
+    for (auto& [id, entry] : entries) {
+        if (!entry.file.empty()) {
+            restore(entry);
+        }
+    }
+}
+
+void SpillManager::enforceBudget() {
+    std::size_t usage = 0;
+    for (const auto& [id, entry] : entries) {
+        usage += entry.usage;
+    }
+
+    while (usage > budget) {
+        // find the least recently used relation that can be spilled
+        Entry* victim = nullptr;
+        for (auto& [id, entry] : entries) {
+            if (entry.pinned > 0 || entry.usage == 0) {
+                continue;
+            }
+            if (victim == nullptr || entry.lastUse < victim->lastUse) {
+                victim = &entry;
+            }
+        }
+        if (victim == nullptr) {
+            return;
+        }
+        usage -= victim->usage;
+        spill(*victim);
+    }
+}
+
+void SpillManager::spill(Entry& entry) {
+    RelationWrapper& rel = **entry.handle;
+    std::string path = directory + "/souffle-spill-XXXXXX";
+    std::vector<char> templ(path.begin(), path.end());
+    templ.push_back('\0');
+    int fd = mkstemp(templ.data());
+    if (fd < 0) {
+        fatal("cannot create spill file in %s: %s", directory, std::strerror(errno));
+    }
+
+    // tuples are written in the order of the main index, i.e., as a sorted run
+    rel.forEachBlock(
+            [&](const RamDomain* data, std::size_t rows) {
+                const char* bytes = reinterpret_cast<const char*>(data);
+                std::size_t length = rows * rel.getArity() * sizeof(RamDomain);
+                while (length > 0) {
+                    ssize_t written = write(fd, bytes, length);
+                    if (written < 0) {
+                        fatal("cannot spill relation %s: %s", rel.getName(), std::strerror(errno));
+                    }
+                    bytes += written;
+                    length -= written;
+                }
+            },
+            4096);
+    close(fd);
+
+    entry.file = templ.data();
+    entry.tuples = rel.size();
+    rel.purge();
+    entry.usage = 0;
+    if (verbose) {
+        std::cout << "Spilled relation " << rel.getName() << " (" << entry.tuples << " tuples) to "
+                  << entry.file << "\n";
+    }
+}
+
+void SpillManager::restore(Entry& entry) {
+    RelationWrapper& rel = **entry.handle;
+    const std::size_t arity = rel.getArity();
+    const std::size_t length = entry.tuples * arity * sizeof(RamDomain);
+
+    // only relations occupying memory are spilled, hence the run is never empty
+    int fd = open(entry.file.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fatal("cannot open spill file %s: %s", entry.file, std::strerror(errno));
+    }
+    void* data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        fatal("cannot map spill file %s: %s", entry.file, std::strerror(errno));
+    }
+    madvise(data, length, MADV_SEQUENTIAL);
+    const auto* tuples = static_cast<const RamDomain*>(data);
+    for (std::size_t i = 0; i < entry.tuples; ++i) {
+        rel.insert(tuples + i * arity);
+    }
+    munmap(data, length);
+    close(fd);
+
+    unlink(entry.file.c_str());
+    entry.file.clear();
+    entry.usage = rel.getMemoryUsage();
+    if (verbose) {
+        std::cout << "Restored relation " << rel.getName() << " (" << entry.tuples << " tuples)\n";
+    }
+}
+
+}  // namespace souffle::interpreter
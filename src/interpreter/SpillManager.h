@@ -0,0 +1,114 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file SpillManager.h
+ *
+ * Declares the SpillManager, which bounds the memory of interpreter
+ * relations by spilling cold relations to disk.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "interpreter/Relation.h"
+#include "souffle/utility/ContainerUtil.h"
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+
+namespace souffle::interpreter {
+
+/**
+ * @class SpillManager
+ * @brief Keeps the memory occupied by relations within a budget.
+ *
+ * Relations are acquired before a subroutine (e.g. a stratum) accessing them is executed and
+ * released afterwards. While the manager is started, i.e. during the evaluation of the main
+ * program, the least recently used relations that are not acquired are spilled whenever the
+ * relations exceed the memory budget after a release: their tuples are written to a file as a
+ * sorted run and the relation is purged. A spilled relation is restored from its memory-mapped
+ * run as soon as it is acquired again. Once the manager is stopped, all relations are restored
+ * and stay resident, since the program interface reads them without acquiring them.
+ */
+class SpillManager {
+    using RelationHandle = Own<RelationWrapper>;
+
+public:
+    SpillManager(std::size_t budget, std::string directory);
+
+    ~SpillManager();
+
+    /** @brief Register a relation which may be spilled */
+    void registerRelation(std::size_t id, RelationHandle* handle);
+
+    /** @brief Restore the given relations and protect them from being spilled */
+    void acquire(const std::set<std::size_t>& ids);
+
+    /** @brief Allow the given relations to be spilled again, and enforce the budget if started */
+    void release(const std::set<std::size_t>& ids);
+
+    /** @brief Start enforcing the budget */
+    void start();
+
+    /** @brief Stop enforcing the budget, and restore all spilled relations */
+    void stop();
+
+    /**
+     * @brief Parse a memory size, e.g. 512M or 64g.
+     *
+     * Throws std::invalid_argument if the size is malformed or does not fit into a std::size_t.
+     */
+    static std::size_t parseSize(const std::string& size);
+
+    /** @brief Return the directory for spilled runs if none is given, i.e. $TMPDIR or /tmp */
+    static std::string getDefaultDirectory();
+
+private:
+    /** Spill state of a relation */
+    struct Entry {
+        /** Handle of the relation; stays valid when relations are swapped */
+        RelationHandle* handle;
+        /** Number of subroutines currently accessing the relation */
+        std::size_t pinned = 0;
+        /** Tick of the last acquisition */
+        std::size_t lastUse = 0;
+        /** File holding the tuples of the spilled relation; empty if resident */
+        std::string file;
+        /** Number of spilled tuples */
+        std::size_t tuples = 0;
+        /** Memory occupied by the relation when it was last released, spilled or restored */
+        std::size_t usage = 0;
+    };
+
+    /** @brief Write the tuples of a relation to a file and purge it */
+    void spill(Entry& entry);
+
+    /** @brief Reload the tuples of a spilled relation */
+    void restore(Entry& entry);
+
+    /** @brief Spill least recently used relations until the budget is met, judged by the cached usages */
+    void enforceBudget();
+
+    /** Memory budget in bytes */
+    std::size_t budget;
+    /** Directory holding the spilled runs */
+    std::string directory;
+    /** Relations that may be spilled */
+    std::map<std::size_t, Entry> entries;
+    /** Logical clock for the least recently used policy */
+    std::size_t tick = 0;
+    /** Whether the budget is enforced */
+    bool started = false;
+    /** Report spills and restores */
+    bool verbose;
+};
+
+}  // namespace souffle::interpreter
@@ -18,10 +18,11 @@
 #include "Global.h"
 #include "souffle/RamTypes.h"
 #include "souffle/datastructure/BTree.h"
-#include "souffle/datastructure/Brie.h"
 #include "souffle/datastructure/EquivalenceRelation.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/MiscUtil.h"
+#include <cstddef>
+#include <limits>
 
 namespace souffle::interpreter {
 // clang-format off
@@ -58,61 +59,191 @@ namespace souffle::interpreter {
     func(Provenance, 30, __VA_ARGS__)
 
 
+// Btree relations are instantiated for the arities 0 to 20. Configuring with
+// --enable-interpreter-arities=LIST defines SOUFFLE_INTERPRETER_ARITIES and, for each arity of
+// the list, SOUFFLE_INTERPRETER_ARITY_<arity>, restricting the instantiations to these arities.
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_0)
+#define FOR_BTREE_0(func, ...) func(Btree, 0, __VA_ARGS__)
+#else
+#define FOR_BTREE_0(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_1)
+#define FOR_BTREE_1(func, ...) func(Btree, 1, __VA_ARGS__)
+#else
+#define FOR_BTREE_1(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_2)
+#define FOR_BTREE_2(func, ...) func(Btree, 2, __VA_ARGS__)
+#else
+#define FOR_BTREE_2(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_3)
+#define FOR_BTREE_3(func, ...) func(Btree, 3, __VA_ARGS__)
+#else
+#define FOR_BTREE_3(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_4)
+#define FOR_BTREE_4(func, ...) func(Btree, 4, __VA_ARGS__)
+#else
+#define FOR_BTREE_4(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_5)
+#define FOR_BTREE_5(func, ...) func(Btree, 5, __VA_ARGS__)
+#else
+#define FOR_BTREE_5(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_6)
+#define FOR_BTREE_6(func, ...) func(Btree, 6, __VA_ARGS__)
+#else
+#define FOR_BTREE_6(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_7)
+#define FOR_BTREE_7(func, ...) func(Btree, 7, __VA_ARGS__)
+#else
+#define FOR_BTREE_7(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_8)
+#define FOR_BTREE_8(func, ...) func(Btree, 8, __VA_ARGS__)
+#else
+#define FOR_BTREE_8(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_9)
+#define FOR_BTREE_9(func, ...) func(Btree, 9, __VA_ARGS__)
+#else
+#define FOR_BTREE_9(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_10)
+#define FOR_BTREE_10(func, ...) func(Btree, 10, __VA_ARGS__)
+#else
+#define FOR_BTREE_10(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_11)
+#define FOR_BTREE_11(func, ...) func(Btree, 11, __VA_ARGS__)
+#else
+#define FOR_BTREE_11(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_12)
+#define FOR_BTREE_12(func, ...) func(Btree, 12, __VA_ARGS__)
+#else
+#define FOR_BTREE_12(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_13)
+#define FOR_BTREE_13(func, ...) func(Btree, 13, __VA_ARGS__)
+#else
+#define FOR_BTREE_13(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_14)
+#define FOR_BTREE_14(func, ...) func(Btree, 14, __VA_ARGS__)
+#else
+#define FOR_BTREE_14(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_15)
+#define FOR_BTREE_15(func, ...) func(Btree, 15, __VA_ARGS__)
+#else
+#define FOR_BTREE_15(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_16)
+#define FOR_BTREE_16(func, ...) func(Btree, 16, __VA_ARGS__)
+#else
+#define FOR_BTREE_16(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_17)
+#define FOR_BTREE_17(func, ...) func(Btree, 17, __VA_ARGS__)
+#else
+#define FOR_BTREE_17(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_18)
+#define FOR_BTREE_18(func, ...) func(Btree, 18, __VA_ARGS__)
+#else
+#define FOR_BTREE_18(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_19)
+#define FOR_BTREE_19(func, ...) func(Btree, 19, __VA_ARGS__)
+#else
+#define FOR_BTREE_19(func, ...)
+#endif
+
+#if !defined(SOUFFLE_INTERPRETER_ARITIES) || defined(SOUFFLE_INTERPRETER_ARITY_20)
+#define FOR_BTREE_20(func, ...) func(Btree, 20, __VA_ARGS__)
+#else
+#define FOR_BTREE_20(func, ...)
+#endif
+
 #define FOR_EACH_BTREE(func, ...)\
-    func(Btree, 0, __VA_ARGS__) \
-    func(Btree, 1, __VA_ARGS__) \
-    func(Btree, 2, __VA_ARGS__) \
-    func(Btree, 3, __VA_ARGS__) \
-    func(Btree, 4, __VA_ARGS__) \
-    func(Btree, 5, __VA_ARGS__) \
-    func(Btree, 6, __VA_ARGS__) \
-    func(Btree, 7, __VA_ARGS__) \
-    func(Btree, 8, __VA_ARGS__) \
-    func(Btree, 9, __VA_ARGS__) \
-    func(Btree, 10, __VA_ARGS__) \
-    func(Btree, 11, __VA_ARGS__) \
-    func(Btree, 12, __VA_ARGS__) \
-    func(Btree, 13, __VA_ARGS__) \
-    func(Btree, 14, __VA_ARGS__) \
-    func(Btree, 15, __VA_ARGS__) \
-    func(Btree, 16, __VA_ARGS__) \
-    func(Btree, 17, __VA_ARGS__) \
-    func(Btree, 18, __VA_ARGS__) \
-    func(Btree, 19, __VA_ARGS__) \
-    func(Btree, 20, __VA_ARGS__)
-
-// Brie is disabled for now.
-#define FOR_EACH_BRIE(func, ...)
-    /* func(Brie, 0, __VA_ARGS__) \ */
-    /* func(Brie, 1, __VA_ARGS__) \ */
-    /* func(Brie, 2, __VA_ARGS__) \ */
-    /* func(Brie, 3, __VA_ARGS__) \ */
-    /* func(Brie, 4, __VA_ARGS__) \ */
-    /* func(Brie, 5, __VA_ARGS__) \ */
-    /* func(Brie, 6, __VA_ARGS__) \ */
-    /* func(Brie, 7, __VA_ARGS__) \ */
-    /* func(Brie, 8, __VA_ARGS__) \ */
-    /* func(Brie, 9, __VA_ARGS__) \ */
-    /* func(Brie, 10, __VA_ARGS__) \ */
-    /* func(Brie, 11, __VA_ARGS__) \ */
-    /* func(Brie, 12, __VA_ARGS__) \ */
-    /* func(Brie, 13, __VA_ARGS__) \ */
-    /* func(Brie, 14, __VA_ARGS__) \ */
-    /* func(Brie, 15, __VA_ARGS__) \ */
-    /* func(Brie, 16, __VA_ARGS__) \ */
-    /* func(Brie, 17, __VA_ARGS__) \ */
-    /* func(Brie, 18, __VA_ARGS__) \ */
-    /* func(Brie, 19, __VA_ARGS__) \ */
-    /* func(Brie, 20, __VA_ARGS__)   */
+    FOR_BTREE_0(func, __VA_ARGS__) \
+    FOR_BTREE_1(func, __VA_ARGS__) \
+    FOR_BTREE_2(func, __VA_ARGS__) \
+    FOR_BTREE_3(func, __VA_ARGS__) \
+    FOR_BTREE_4(func, __VA_ARGS__) \
+    FOR_BTREE_5(func, __VA_ARGS__) \
+    FOR_BTREE_6(func, __VA_ARGS__) \
+    FOR_BTREE_7(func, __VA_ARGS__) \
+    FOR_BTREE_8(func, __VA_ARGS__) \
+    FOR_BTREE_9(func, __VA_ARGS__) \
+    FOR_BTREE_10(func, __VA_ARGS__) \
+    FOR_BTREE_11(func, __VA_ARGS__) \
+    FOR_BTREE_12(func, __VA_ARGS__) \
+    FOR_BTREE_13(func, __VA_ARGS__) \
+    FOR_BTREE_14(func, __VA_ARGS__) \
+    FOR_BTREE_15(func, __VA_ARGS__) \
+    FOR_BTREE_16(func, __VA_ARGS__) \
+    FOR_BTREE_17(func, __VA_ARGS__) \
+    FOR_BTREE_18(func, __VA_ARGS__) \
+    FOR_BTREE_19(func, __VA_ARGS__) \
+    FOR_BTREE_20(func, __VA_ARGS__)
+
+// Btree relations of the other arities are evaluated as a single relation type, see Relation<Dynamic, Btree>
+#define FOR_EACH_DYNAMIC_BTREE(func, ...)\
+    func(Btree, Dynamic, __VA_ARGS__)
+
+// Provenance relations with compact annotations are evaluated as a single relation type, see
+// Relation<Dynamic, Provenance>
+#define FOR_EACH_DYNAMIC_PROVENANCE(func, ...)\
+    func(Provenance, Dynamic, __VA_ARGS__)
+
+// Brie relations of all arities are evaluated as a single relation type, see Relation<Dynamic, Brie>
+#define FOR_EACH_BRIE(func, ...)\
+    func(Brie, Dynamic, __VA_ARGS__)
 
 #define FOR_EACH_EQREL(func, ...)\
     func(Eqrel, 2, __VA_ARGS__)
 
+#define FOR_EACH_LATTICE(func, ...)\
+    func(Lattice, 2, __VA_ARGS__) \
+    func(Lattice, 3, __VA_ARGS__) \
+    func(Lattice, 4, __VA_ARGS__) \
+    func(Lattice, 5, __VA_ARGS__) \
+    func(Lattice, 6, __VA_ARGS__) \
+    func(Lattice, 7, __VA_ARGS__) \
+    func(Lattice, 8, __VA_ARGS__)
+
 #define FOR_EACH(func, ...)                 \
     FOR_EACH_BTREE(func, __VA_ARGS__)       \
+    FOR_EACH_DYNAMIC_BTREE(func, __VA_ARGS__) \
     FOR_EACH_BRIE(func, __VA_ARGS__)        \
     FOR_EACH_PROVENANCE(func, __VA_ARGS__)  \
-    FOR_EACH_EQREL(func, __VA_ARGS__)
+    FOR_EACH_DYNAMIC_PROVENANCE(func, __VA_ARGS__) \
+    FOR_EACH_EQREL(func, __VA_ARGS__)       \
+    FOR_EACH_LATTICE(func, __VA_ARGS__)
 
 // clang-format on
 
@@ -214,9 +345,33 @@ using comparator = typename index_utils::get_full_index<Arity>::type::comparator
 template <std::size_t Arity>
 using Btree = btree_set<t_tuple<Arity>, comparator<Arity>>;
 
-// Alias for Trie
+// Tag for Brie relations, whose tries are only instantiated in BrieIndex.cpp
 template <std::size_t Arity>
-using Brie = Trie<Arity>;
+struct Brie;
+
+// Pseudo-arity of the relation types serving relations of any arity, see DynamicRelation
+constexpr std::size_t Dynamic = std::numeric_limits<std::size_t>::max();
+
+// Largest arity of relations supported by the interpreter, which passes tuples of dynamic
+// relations in buffers of this width
+constexpr std::size_t MAX_DYNAMIC_ARITY = 128;
+
+// Largest arity of Brie relations; Brie relations of other arities are stored in btrees
+constexpr std::size_t MAX_BRIE_ARITY = 20;
+
+/**
+ * Whether the engine is instantiated for btree relations of the given arity, see FOR_EACH_BTREE;
+ * btree relations of the other arities are evaluated as Relation<Dynamic, Btree>.
+ */
+inline bool isBTreeArity(std::size_t arity) {
+#define IS_BTREE_ARITY(Structure, Arity, ...) \
+    if (arity == Arity) {                     \
+        return true;                          \
+    }
+    FOR_EACH_BTREE(IS_BTREE_ARITY)
+#undef IS_BTREE_ARITY
+    return false;
+}
 
 // Updater for Provenance
 template <std::size_t Arity>
@@ -233,6 +388,24 @@ using Provenance = btree_set<t_tuple<Arity>, comparator<Arity>, std::allocator<t
         typename detail::default_strategy<t_tuple<Arity>>::type, comparator<Arity - 2>,
         ProvenanceUpdater<Arity>>;
 
+// Updater for Lattice
+template <std::size_t Arity>
+struct LatticeUpdater {
+    void update(t_tuple<Arity>& old_t, const t_tuple<Arity>& new_t) {
+        old_t[Arity - 1] = new_t[Arity - 1];
+    }
+};
+
+/**
+ * A btree keeping a single tuple per key, i.e. per prefix of the first Arity - 1 columns,
+ * whose last column is the least inserted so far. Inserting a tuple with a smaller last
+ * column replaces the stored one in place, while inserting a larger one has no effect.
+ */
+template <std::size_t Arity>
+using Lattice = btree_set<t_tuple<Arity>, comparator<Arity>, std::allocator<t_tuple<Arity>>, 256,
+        typename detail::default_strategy<t_tuple<Arity>>::type, comparator<Arity - 1>,
+        LatticeUpdater<Arity>>;
+
 // Alias for Eqrel
 // Note: require Arity = 2.
 template <std::size_t Arity>
@@ -0,0 +1,159 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file dynamic_btree_test.cpp
+ *
+ * Tests the runtime-arity btree of the interpreter.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "interpreter/DynamicBTree.h"
+#include "souffle/RamTypes.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace souffle::interpreter::test {
+
+TEST(DynamicBTree, Nullary) {
+    DynamicBTree tree(0);
+    EXPECT_TRUE(tree.empty());
+    EXPECT_TRUE(tree.begin() == tree.end());
+    EXPECT_TRUE(tree.insert(nullptr));
+    EXPECT_FALSE(tree.insert(nullptr));
+    EXPECT_EQ(1, tree.size());
+    EXPECT_TRUE(tree.contains(nullptr));
+    EXPECT_FALSE(tree.begin() == tree.end());
+    EXPECT_EQ(0, (*tree.begin()).size());
+}
+
+TEST(DynamicBTree, Order) {
+    // insert many tuples in random order, such that the nodes are split on all levels
+    constexpr std::size_t arity = 3;
+    DynamicBTree tree(arity);
+    std::set<std::vector<RamDomain>> expected;
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<RamDomain> dist(-50, 50);
+    for (int i = 0; i < 20000; ++i) {
+        std::vector<RamDomain> tuple{dist(gen), dist(gen), dist(gen)};
+        EXPECT_EQ(expected.insert(tuple).second, tree.insert(tuple.data()));
+    }
+    EXPECT_EQ(expected.size(), tree.size());
+    EXPECT_LT(0, tree.getMemoryUsage());
+
+    // scans yield the tuples in lexicographical order
+    auto pos = expected.begin();
+    for (auto it = tree.begin(); it != tree.end(); ++it, ++pos) {
+        ASSERT_TRUE(pos != expected.end());
+        EXPECT_TRUE(std::equal(pos->begin(), pos->end(), (*it).begin()));
+    }
+    EXPECT_TRUE(pos == expected.end());
+
+    // bounds agree with the ordered set
+    for (RamDomain first = -51; first <= 51; first += 17) {
+        std::vector<RamDomain> low{first, 0, MIN_RAM_SIGNED};
+        std::vector<RamDomain> high{first, 10, MAX_RAM_SIGNED};
+        std::size_t count = 0;
+        for (auto it = tree.lower_bound(low.data()); it != tree.upper_bound(high.data()); ++it) {
+            EXPECT_EQ(first, (*it)[0]);
+            ++count;
+        }
+        auto begin = expected.lower_bound(low);
+        auto end = expected.upper_bound(high);
+        EXPECT_EQ(static_cast<std::size_t>(std::distance(begin, end)), count);
+        EXPECT_EQ(begin != expected.end() && *begin == low, tree.contains(low.data()));
+    }
+
+    // partitions cover the tree in order
+    auto partitions = tree.partition(7);
+    EXPECT_EQ(7, partitions.size());
+    pos = expected.begin();
+    for (const auto& partition : partitions) {
+        for (auto it = partition.first; it != partition.second; ++it, ++pos) {
+            EXPECT_TRUE(std::equal(pos->begin(), pos->end(), (*it).begin()));
+        }
+    }
+    EXPECT_TRUE(pos == expected.end());
+
+    tree.clear();
+    EXPECT_TRUE(tree.empty());
+    EXPECT_TRUE(tree.begin() == tree.end());
+    EXPECT_EQ(0, tree.getMemoryUsage());
+}
+
+TEST(DynamicBTree, Payload) {
+    // each key keeps the least payload inserted for it
+    constexpr std::size_t arity = 2;
+    DynamicBTree tree(arity, 2);
+    std::map<std::vector<RamDomain>, std::vector<RamDomain>> expected;
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<RamDomain> dist(0, 40);
+    for (int i = 0; i < 10000; ++i) {
+        std::vector<RamDomain> tuple{dist(gen), dist(gen)};
+        std::vector<RamDomain> payload{dist(gen) % 3, dist(gen)};
+        auto pos = expected.find(tuple);
+        bool changed = pos == expected.end() || payload < pos->second;
+        if (changed) {
+            expected[tuple] = payload;
+        }
+        EXPECT_EQ(changed, tree.insert(tuple.data(), payload.data()));
+    }
+    EXPECT_EQ(expected.size(), tree.size());
+
+    auto pos = expected.begin();
+    for (auto it = tree.begin(); it != tree.end(); ++it, ++pos) {
+        ASSERT_TRUE(pos != expected.end());
+        EXPECT_TRUE(std::equal(pos->first.begin(), pos->first.end(), (*it).begin()));
+        EXPECT_TRUE(std::equal(pos->second.begin(), pos->second.end(), it.payload().begin()));
+    }
+    EXPECT_TRUE(pos == expected.end());
+
+    for (const auto& entry : expected) {
+        auto found = tree.find(entry.first.data());
+        ASSERT_TRUE(found != tree.end());
+        EXPECT_TRUE(std::equal(entry.second.begin(), entry.second.end(), found.payload().begin()));
+    }
+    std::vector<RamDomain> missing{41, 0};
+    EXPECT_TRUE(tree.find(missing.data()) == tree.end());
+}
+
+TEST(DynamicBTree, ParallelInsert) {
+    constexpr std::size_t arity = 30;
+    constexpr RamDomain n = 2000;
+    DynamicBTree tree(arity);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&tree]() {
+            for (RamDomain i = 0; i < n; ++i) {
+                std::vector<RamDomain> tuple(arity, n - i);
+                tree.insert(tuple.data());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(n, tree.size());
+    RamDomain last = 0;
+    for (auto it = tree.begin(); it != tree.end(); ++it) {
+        EXPECT_EQ(last + 1, (*it)[arity - 1]);
+        last = (*it)[arity - 1];
+    }
+    EXPECT_EQ(n, last);
+}
+
+}  // namespace souffle::interpreter::test
@@ -19,6 +19,7 @@
 #include "interpreter/ProgInterface.h"
 #include "interpreter/Relation.h"
 #include "ram/analysis/Index.h"
+#include "souffle/RamTypes.h"
 #include "souffle/SouffleInterface.h"
 #include "souffle/SymbolTable.h"
 #include <iosfwd>
@@ -287,4 +288,219 @@ TEST(Reordering, Iteration) {
     }
 }
 
+TEST(Reordering, BlockIteration) {
+    // create a relation, with a non-default ordering.
+    SymbolTable symbolTable;
+
+    SignatureOrderMap mapping;
+    SearchSignature existenceCheck = SearchSignature::getFullSearchSignature(3);
+    SearchSet searches = {existenceCheck};
+    // create an index of order {0, 2, 1}
+    LexOrder fullOrder = {0, 2, 1};
+    OrderCollection orders = {fullOrder};
+    mapping.insert({existenceCheck, fullOrder});
+    IndexCluster indexSelection(mapping, searches, orders);
+
+    Relation<3, interpreter::Btree> rel(0, "test", indexSelection);
+    for (RamDomain i = 0; i < 10; ++i) {
+        rel.insert(souffle::Tuple<RamDomain, 3>{i, i + 1, i + 2});
+    }
+
+    RelInterface relInt(rel, symbolTable, "test", {"i", "i", "i"}, {"i", "i", "i"}, 3);
+
+    // Blocks should hold decoded tuples and respect the block size.
+    std::size_t count = 0;
+    std::size_t blocks = 0;
+    relInt.forEachBlock(
+            [&](const RamDomain* data, std::size_t rows) {
+                EXPECT_TRUE(rows <= 4);
+                for (std::size_t i = 0; i < rows; ++i) {
+                    const RamDomain* row = data + i * 3;
+                    EXPECT_EQ(RamDomain(count), row[0]);
+                    EXPECT_EQ(RamDomain(count + 1), row[1]);
+                    EXPECT_EQ(RamDomain(count + 2), row[2]);
+                    ++count;
+                }
+                ++blocks;
+            },
+            4);
+    EXPECT_EQ(10, count);
+    EXPECT_EQ(3, blocks);
+}
+
+TEST(Brie, Reordering) {
+    // create a Brie relation of arity 3 with an index of order {1, 0, 2}
+    SymbolTable symbolTable;
+
+    SignatureOrderMap mapping;
+    SearchSignature existenceCheck = SearchSignature::getFullSearchSignature(3);
+    SearchSet searches = {existenceCheck};
+    LexOrder fullOrder = {1, 0, 2};
+    OrderCollection orders = {fullOrder};
+    mapping.insert({existenceCheck, fullOrder});
+    IndexCluster indexSelection(mapping, searches, orders);
+
+    Relation<Dynamic, interpreter::Brie> rel(3, 0, "test", indexSelection);
+    EXPECT_TRUE(rel.empty());
+    for (RamDomain i = 0; i < 10; ++i) {
+        rel.insert(Relation<Dynamic, interpreter::Brie>::Tuple{i, i % 3, -i});
+    }
+    rel.insert(Relation<Dynamic, interpreter::Brie>::Tuple{0, 0, 0});
+    EXPECT_EQ(10, rel.size());
+    EXPECT_TRUE(rel.contains(Tuple<RamDomain, 3>{4, 1, -4}.data()));
+    EXPECT_FALSE(rel.contains(Tuple<RamDomain, 3>{4, 2, -4}.data()));
+
+    // Scan should give undecoded tuples of the arity of the relation.
+    {
+        // the tuple is only valid as long as the iterator
+        auto scan = rel.scan();
+        const auto t = *scan.begin();
+        EXPECT_EQ(3, t.size());
+        EXPECT_EQ(0, t[0]);
+        EXPECT_EQ(0, t[1]);
+        EXPECT_EQ(0, t[2]);
+    }
+
+    // A range fixing the first column of the index.
+    auto view = rel.createView(0);
+    auto* brieView = Relation<Dynamic, interpreter::Brie>::castView(view.get());
+    Relation<Dynamic, interpreter::Brie>::Tuple low{1, MIN_RAM_SIGNED, MIN_RAM_SIGNED};
+    Relation<Dynamic, interpreter::Brie>::Tuple high{1, MAX_RAM_SIGNED, MAX_RAM_SIGNED};
+    std::size_t count = 0;
+    for (const auto& t : brieView->range(low, high)) {
+        EXPECT_EQ(1, t[0]);
+        EXPECT_EQ(1, t[1] % 3);
+        EXPECT_EQ(-t[1], t[2]);
+        ++count;
+    }
+    EXPECT_EQ(3, count);
+    EXPECT_TRUE(brieView->contains(Relation<Dynamic, interpreter::Brie>::Tuple{1, 4, -4}));
+    EXPECT_FALSE(brieView->contains(low, low));
+
+    // Partitions should cover the range.
+    count = 0;
+    for (const auto& partition : rel.partitionRange(0, low, high, 2)) {
+        for (const auto& t : partition) {
+            EXPECT_EQ(1, t[0]);
+            ++count;
+        }
+    }
+    EXPECT_EQ(3, count);
+
+    // Blocks should hold decoded tuples.
+    RelInterface relInt(rel, symbolTable, "test", {"i", "i", "i"}, {"i", "i", "i"}, 3);
+    count = 0;
+    relInt.forEachBlock(
+            [&](const RamDomain* data, std::size_t rows) {
+                for (std::size_t i = 0; i < rows; ++i) {
+                    const RamDomain* row = data + i * 3;
+                    EXPECT_EQ(row[0] % 3, row[1]);
+                    EXPECT_EQ(-row[0], row[2]);
+                    ++count;
+                }
+            },
+            4);
+    EXPECT_EQ(10, count);
+
+    rel.purge();
+    EXPECT_TRUE(rel.empty());
+    EXPECT_EQ(0, rel.getMemoryUsage());
+}
+
+
+TEST(DynamicBtree, Reordering) {
+    // create a btree relation of an arity not instantiated by the engine, with an index of
+    // order {2, 0, 1, ...}
+    constexpr std::size_t arity = 25;
+    using Rel = Relation<Dynamic, interpreter::Btree>;
+    SymbolTable symbolTable;
+
+    SignatureOrderMap mapping;
+    SearchSignature existenceCheck = SearchSignature::getFullSearchSignature(arity);
+    SearchSet searches = {existenceCheck};
+    LexOrder fullOrder = {2, 0, 1};
+    for (std::size_t i = 3; i < arity; ++i) {
+        fullOrder.push_back(i);
+    }
+    OrderCollection orders = {fullOrder};
+    mapping.insert({existenceCheck, fullOrder});
+    IndexCluster indexSelection(mapping, searches, orders);
+
+    Rel rel(arity, 0, "test", indexSelection);
+    EXPECT_TRUE(rel.empty());
+    auto makeTuple = [&](RamDomain i) {
+        Rel::Tuple tuple;
+        for (std::size_t j = 0; j < arity; ++j) {
+            tuple[j] = i + static_cast<RamDomain>(j);
+        }
+        tuple[2] = i % 7;
+        return tuple;
+    };
+    for (RamDomain i = 0; i < 1000; ++i) {
+        rel.insert(makeTuple(i));
+    }
+    rel.insert(makeTuple(0));
+    EXPECT_EQ(1000, rel.size());
+    EXPECT_TRUE(rel.contains(makeTuple(500).data()));
+    Rel::Tuple absent = makeTuple(500);
+    absent[3] = -1;
+    EXPECT_FALSE(rel.contains(absent.data()));
+
+    // Scan should give undecoded tuples of the arity of the relation, ordered by the index.
+    {
+        auto scan = rel.scan();
+        const auto t = *scan.begin();
+        EXPECT_EQ(arity, t.size());
+        EXPECT_EQ(0, t[0]);
+        EXPECT_EQ(0, t[1]);
+        EXPECT_EQ(1, t[2]);
+    }
+
+    // A range on the first column of the index and an inequality on the second one.
+    auto view = rel.createView(0);
+    auto* btreeView = Rel::castView(view.get());
+    Rel::Tuple low;
+    Rel::Tuple high;
+    for (std::size_t j = 0; j < arity; ++j) {
+        low[j] = MIN_RAM_SIGNED;
+        high[j] = MAX_RAM_SIGNED;
+    }
+    low[0] = high[0] = 3;
+    low[1] = 100;
+    high[1] = 199;
+    std::size_t count = 0;
+    for (const auto& t : btreeView->range(low, high)) {
+        EXPECT_EQ(3, t[0]);
+        EXPECT_EQ(3, t[1] % 7);
+        EXPECT_TRUE(100 <= t[1] && t[1] <= 199);
+        ++count;
+    }
+    EXPECT_EQ(15, count);
+    EXPECT_FALSE(btreeView->contains(high, low));
+
+    // Partitions should cover the relation.
+    count = 0;
+    for (const auto& partition : rel.partitionScan(4)) {
+        for (const auto& t : partition) {
+            EXPECT_EQ(t[1] % 7, t[0]);
+            ++count;
+        }
+    }
+    EXPECT_EQ(1000, count);
+
+    // Iteration should give decoded tuples.
+    count = 0;
+    for (auto it = rel.begin(); it != rel.end(); ++it) {
+        const RamDomain* row = *it;
+        EXPECT_EQ(row[0] % 7, row[2]);
+        EXPECT_EQ(row[0] + 24, row[24]);
+        ++count;
+    }
+    EXPECT_EQ(1000, count);
+
+    rel.purge();
+    EXPECT_TRUE(rel.empty());
+    EXPECT_EQ(0, rel.getMemoryUsage());
+}
+
 }  // namespace souffle::interpreter::test
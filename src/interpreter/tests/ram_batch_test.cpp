@@ -0,0 +1,74 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ram_batch_test.cpp
+ *
+ * Tests that the batch-at-a-time evaluation of scans of the Interpreter
+ * agrees with the evaluation a tuple at a time.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "FunctorOps.h"
+#include "RelationTag.h"
+#include "interpreter/tests/ram_eval.h"
+#include "ram/ExistenceCheck.h"
+#include "ram/Expression.h"
+#include "ram/Filter.h"
+#include "ram/Insert.h"
+#include "ram/Negation.h"
+#include "ram/Operation.h"
+#include "ram/Scan.h"
+#include "souffle/RamTypes.h"
+
+namespace souffle::interpreter::test {
+
+/** Check that a query yields the same results with and without batching */
+bool batchingAgrees(RelationRepresentation representation, const QueryPattern& pattern) {
+    auto batched = evalQuery(representation, pattern(), true);
+    auto single = evalQuery(representation, pattern(), false);
+    return batched.first.size() == 4 && batched.first == single.first;
+}
+
+/** for t0 in a: if t0[1] < 0: if not (t0[0] - 1, t0[1], t0[2]) in b: insert (t0[0], t0[1], t0[1]) into b */
+Own<ram::Operation> written() {
+    VecOwn<ram::Expression> values;
+    values.push_back(functor(FunctorOp::SUB, elem(0, 0), num(1)));
+    values.push_back(elem(0, 1));
+    values.push_back(elem(0, 2));
+    auto missing = mk<ram::Negation>(mk<ram::ExistenceCheck>("b", std::move(values)));
+    VecOwn<ram::Expression> tuple;
+    tuple.push_back(elem(0, 0));
+    tuple.push_back(elem(0, 1));
+    tuple.push_back(elem(0, 1));
+    auto insert = mk<ram::Filter>(std::move(missing), mk<ram::Insert>("b", std::move(tuple)));
+    return mk<ram::Scan>("a", 0, mk<ram::Filter>(less(elem(0, 1), num(0)), std::move(insert)));
+}
+
+TEST(Batching, Filter) {
+    for (RamDomain bound : {-600, -500, -499, -300, 0, 499, 500}) {
+        EXPECT_TRUE(batchingAgrees(RelationRepresentation::BTREE, selective(bound)));
+        EXPECT_TRUE(batchingAgrees(RelationRepresentation::BRIE, selective(bound)));
+    }
+}
+
+TEST(Batching, Existence) {
+    EXPECT_TRUE(batchingAgrees(RelationRepresentation::BTREE, negation));
+    EXPECT_TRUE(batchingAgrees(RelationRepresentation::BRIE, negation));
+    // conditions reading a relation written by the scan are evaluated a tuple at a time
+    EXPECT_TRUE(batchingAgrees(RelationRepresentation::BTREE, written));
+}
+
+TEST(Batching, Nested) {
+    EXPECT_TRUE(batchingAgrees(RelationRepresentation::BTREE, join));
+}
+
+}  // namespace souffle::interpreter::test
@@ -0,0 +1,133 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ram_benchmark.cpp
+ *
+ * Measures the optimisations of the Interpreter against its unoptimised
+ * evaluation. This is not a unit test, and is built on demand only.
+ *
+ ***********************************************************************/
+
+#include "AggregateOp.h"
+#include "FunctorOps.h"
+#include "RelationTag.h"
+#include "interpreter/tests/ram_eval.h"
+#include "ram/Constraint.h"
+#include "ram/SignedConstant.h"
+#include "ram/True.h"
+#include "souffle/BinaryConstraintOps.h"
+#include <iostream>
+#include <string>
+#include <utility>
+
+namespace souffle::interpreter::test {
+
+/** Whether all measured evaluations yielded the same results with and without an optimisation */
+bool agreed = true;
+
+/** Measure a pattern with and without fusion */
+void measureFusion(const std::string& name, char type, const Pattern& pattern) {
+    // warm up
+    evalStatement(type, pattern(), true);
+    auto fused = evalStatement(type, pattern(), true);
+    auto generic = evalStatement(type, pattern(), false);
+    std::cout << name << ": generic " << generic.second * 1000 << "ms, fused " << fused.second * 1000
+              << "ms\n";
+    agreed = agreed && fused.first == generic.first;
+}
+
+/** Measure fused constraints and functors */
+void benchmarkFusion() {
+    Pattern equality =
+            count([]() { return mk<ram::Constraint>(BinaryConstraintOp::EQ, elem(0, 0), elem(1, 1)); });
+    measureFusion("t0[0] = t1[1]", 'i', equality);
+
+    Pattern offset = count([]() {
+        auto lhs = functor(FunctorOp::ADD, elem(1, 2), mk<ram::SignedConstant>(3));
+        return mk<ram::Constraint>(BinaryConstraintOp::LT, std::move(lhs), elem(1, 1));
+    });
+    measureFusion("t1[2] + 3 < t1[1]", 'i', offset);
+
+    Pattern bound = count([]() {
+        return mk<ram::Constraint>(BinaryConstraintOp::FLE, elem(1, 1), constant('f', 100));
+    });
+    measureFusion("t1[1] <= 25.0", 'f', bound);
+
+    Pattern product = aggregate(
+            AggregateOp::SUM, []() { return functor(FunctorOp::MUL, elem(1, 1), elem(1, 2)); },
+            []() { return mk<ram::True>(); });
+    measureFusion("sum t1[1] * t1[2]", 'i', product);
+}
+
+/** Measure a query with and without batching */
+void measureBatching(const std::string& name, const QueryPattern& pattern) {
+    // warm up
+    evalQuery(RelationRepresentation::BTREE, pattern(), true);
+    auto batched = evalQuery(RelationRepresentation::BTREE, pattern(), true);
+    auto single = evalQuery(RelationRepresentation::BTREE, pattern(), false);
+    std::cout << name << ": tuple at a time " << single.second * 1000 << "ms, batched "
+              << batched.second * 1000 << "ms\n";
+    agreed = agreed && batched.first == single.first;
+}
+
+/** Measure scans evaluated a batch at a time */
+void benchmarkBatching() {
+    measureBatching("filter 1%", selective(-490));
+    measureBatching("filter 50%", selective(0));
+    measureBatching("filter and negation", negation);
+    measureBatching("nested scan", join);
+}
+
+/** Measure a pattern with and without typed evaluators */
+void measureTyping(const std::string& name, char type, const Pattern& pattern) {
+    // warm up
+    evalStatement(type, pattern(), true);
+    auto typed = evalStatement(type, pattern(), true);
+    auto generic = evalStatement(type, pattern(), false);
+    std::cout << name << ": generic " << generic.second * 1000 << "ms, typed " << typed.second * 1000
+              << "ms\n";
+    agreed = agreed && typed.first == generic.first;
+}
+
+/** Measure typed evaluators of numeric expressions */
+void benchmarkTyping() {
+    measureTyping("sum t1[1] * t1[2] + (t1[0] - t1[1])", 'i', total('i', []() { return polynomial('i'); }));
+    measureTyping("fsum t1[1] * t1[2] + (t1[0] - t1[1])", 'f', total('f', []() { return polynomial('f'); }));
+
+    Pattern constraint = count([]() {
+        auto lhs = functor(FunctorOp::MUL, elem(1, 1), mk<ram::SignedConstant>(3));
+        auto rhs = functor(FunctorOp::SUB, elem(1, 2), elem(1, 0));
+        return mk<ram::Constraint>(BinaryConstraintOp::LT, std::move(lhs), std::move(rhs));
+    });
+    measureTyping("count t1[1] * 3 < t1[2] - t1[0]", 'i', constraint);
+
+    Pattern conversion = total('f', []() {
+        auto quotient = functor(FunctorOp::FDIV, functor(FunctorOp::U2F, elem(1, 1)), constant('f', 2));
+        return functor(FunctorOp::FADD, std::move(quotient), functor(FunctorOp::U2F, elem(1, 2)));
+    });
+    measureTyping("fsum float(t1[1]) / 0.5 + float(t1[2])", 'u', conversion);
+}
+
+}  // namespace souffle::interpreter::test
+
+/**
+ * Main program
+ */
+int main(int /* argc */, char** /* argv */) {
+    using namespace souffle::interpreter::test;
+    benchmarkFusion();
+    benchmarkBatching();
+    benchmarkTyping();
+    if (!agreed) {
+        std::cerr << "error: results differ\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,355 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ram_eval.h
+ *
+ * RAM programs evaluated by the Interpreter tests and benchmarks, with
+ * and without its optimisations.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "AggregateOp.h"
+#include "FunctorOps.h"
+#include "Global.h"
+#include "RelationTag.h"
+#include "interpreter/Engine.h"
+#include "ram/Aggregate.h"
+#include "ram/Condition.h"
+#include "ram/Conjunction.h"
+#include "ram/Constraint.h"
+#include "ram/ExistenceCheck.h"
+#include "ram/Expression.h"
+#include "ram/Filter.h"
+#include "ram/FloatConstant.h"
+#include "ram/Insert.h"
+#include "ram/IntrinsicOperator.h"
+#include "ram/Negation.h"
+#include "ram/NestedIntrinsicOperator.h"
+#include "ram/Operation.h"
+#include "ram/Program.h"
+#include "ram/Query.h"
+#include "ram/Relation.h"
+#include "ram/RelationSize.h"
+#include "ram/Scan.h"
+#include "ram/Sequence.h"
+#include "ram/SignedConstant.h"
+#include "ram/Statement.h"
+#include "ram/SubroutineReturn.h"
+#include "ram/TranslationUnit.h"
+#include "ram/True.h"
+#include "ram/TupleElement.h"
+#include "ram/UnsignedConstant.h"
+#include "reports/DebugReport.h"
+#include "reports/ErrorReport.h"
+#include "souffle/BinaryConstraintOps.h"
+#include "souffle/RamTypes.h"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::interpreter::test {
+
+/** Number of tuples of the relation a of a statement */
+constexpr RamDomain N = 20000;
+
+/** Number of scans of the relation a */
+constexpr RamDomain SCANS = 16;
+
+/** Number of tuples of the relation a of a query */
+constexpr RamDomain QUERY_N = 50000;
+
+inline Own<ram::Expression> elem(std::size_t tuple, std::size_t element) {
+    return mk<ram::TupleElement>(tuple, element);
+}
+
+inline Own<ram::Expression> num(RamDomain value) {
+    return mk<ram::SignedConstant>(value);
+}
+
+inline Own<ram::Expression> functor(FunctorOp op, VecOwn<ram::Expression> args) {
+    return mk<ram::IntrinsicOperator>(op, std::move(args));
+}
+
+inline Own<ram::Expression> functor(FunctorOp op, Own<ram::Expression> arg) {
+    VecOwn<ram::Expression> args;
+    args.push_back(std::move(arg));
+    return functor(op, std::move(args));
+}
+
+inline Own<ram::Expression> functor(FunctorOp op, Own<ram::Expression> lhs, Own<ram::Expression> rhs) {
+    VecOwn<ram::Expression> args;
+    args.push_back(std::move(lhs));
+    args.push_back(std::move(rhs));
+    return functor(op, std::move(args));
+}
+
+/** A constant of the given type, which is 'i', 'u', or 'f' */
+inline Own<ram::Expression> constant(char type, RamSigned value) {
+    switch (type) {
+        case 'u': return mk<ram::UnsignedConstant>(static_cast<RamUnsigned>(value));
+        case 'f': return mk<ram::FloatConstant>(static_cast<RamFloat>(value) / 4);
+        default: return mk<ram::SignedConstant>(value);
+    }
+}
+
+/** The variant of a functor for the given type */
+inline FunctorOp typed(FunctorOp op, char type) {
+    static const std::map<FunctorOp, std::pair<FunctorOp, FunctorOp>> variants = {
+            {FunctorOp::ADD, {FunctorOp::UADD, FunctorOp::FADD}},
+            {FunctorOp::SUB, {FunctorOp::USUB, FunctorOp::FSUB}},
+            {FunctorOp::MUL, {FunctorOp::UMUL, FunctorOp::FMUL}},
+            {FunctorOp::DIV, {FunctorOp::UDIV, FunctorOp::FDIV}},
+            {FunctorOp::MAX, {FunctorOp::UMAX, FunctorOp::FMAX}},
+            {FunctorOp::MIN, {FunctorOp::UMIN, FunctorOp::FMIN}},
+            {FunctorOp::BAND, {FunctorOp::UBAND, FunctorOp::BAND}},
+            {FunctorOp::BOR, {FunctorOp::UBOR, FunctorOp::BOR}},
+            {FunctorOp::BXOR, {FunctorOp::UBXOR, FunctorOp::BXOR}},
+            {FunctorOp::MOD, {FunctorOp::UMOD, FunctorOp::MOD}}};
+    switch (type) {
+        case 'u': return variants.at(op).first;
+        case 'f': return variants.at(op).second;
+        default: return op;
+    }
+}
+
+/** The aggregate summing values of the given type */
+inline AggregateOp sum(char type) {
+    switch (type) {
+        case 'u': return AggregateOp::USUM;
+        case 'f': return AggregateOp::FSUM;
+        default: return AggregateOp::SUM;
+    }
+}
+
+/** A scrambled value of the range element t0[0], in [-500, 500) */
+inline Own<ram::Expression> scramble(RamSigned factor) {
+    auto product = functor(FunctorOp::MUL, elem(0, 0), mk<ram::SignedConstant>(factor));
+    auto mod = functor(FunctorOp::MOD, std::move(product), mk<ram::SignedConstant>(1000));
+    return functor(FunctorOp::SUB, std::move(mod), mk<ram::SignedConstant>(500));
+}
+
+/** Convert a signed expression to the given type */
+inline Own<ram::Expression> convert(char type, Own<ram::Expression> expr) {
+    if (type == 'i') {
+        return expr;
+    }
+    return functor(type == 'u' ? FunctorOp::I2U : FunctorOp::I2F, std::move(expr));
+}
+
+/**
+ * Evaluate a statement in a program with the relation a of the given type, which holds N
+ * tuples of scrambled values
+ *
+ * @return the values returned by the statement, and the time its evaluation took in seconds
+ */
+inline std::pair<std::vector<RamDomain>, double> evalStatement(
+        char type, Own<ram::Statement> test, bool fusion) {
+    Global::config().set("jobs", "1");
+    if (fusion) {
+        Global::config().unset("disable-fusion");
+    } else {
+        Global::config().set("disable-fusion");
+    }
+
+    VecOwn<ram::Relation> rels;
+    std::string ty(1, type);
+    rels.push_back(mk<ram::Relation>("a", 3, 0, std::vector<std::string>{"x", "y", "z"},
+            std::vector<std::string>{ty, ty, ty}, RelationRepresentation::BTREE));
+
+    VecOwn<ram::Expression> values;
+    values.push_back(convert(type, elem(0, 0)));
+    values.push_back(convert(type, scramble(7919)));
+    values.push_back(convert(type, scramble(104729)));
+    VecOwn<ram::Expression> range;
+    range.push_back(mk<ram::SignedConstant>(0));
+    range.push_back(mk<ram::SignedConstant>(N));
+    Own<ram::Statement> fill = mk<ram::Query>(mk<ram::NestedIntrinsicOperator>(
+            ram::NestedIntrinsicOp::RANGE, std::move(range), mk<ram::Insert>("a", std::move(values)), 0));
+
+    std::map<std::string, Own<ram::Statement>> subs;
+    subs.insert(std::make_pair("fill", std::move(fill)));
+    subs.insert(std::make_pair("test", std::move(test)));
+    Own<ram::Program> prog = mk<ram::Program>(std::move(rels), mk<ram::Sequence>(), std::move(subs));
+
+    ErrorReport errReport;
+    DebugReport debugReport;
+    ram::TranslationUnit translationUnit(std::move(prog), errReport, debugReport);
+    Own<Engine> interpreter = mk<Engine>(translationUnit);
+
+    std::vector<RamDomain> ret;
+    interpreter->executeSubroutine("fill", {}, ret);
+    auto start = std::chrono::high_resolution_clock::now();
+    interpreter->executeSubroutine("test", {}, ret);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    Global::config().unset("disable-fusion");
+    return {ret, std::chrono::duration<double>(end - start).count()};
+}
+
+/**
+ * A statement aggregating an expression over the tuples t1 of the relation a which satisfy a
+ * condition, for each t0 in range(0, SCANS)
+ */
+using Pattern = std::function<Own<ram::Statement>()>;
+
+inline Pattern aggregate(AggregateOp op, std::function<Own<ram::Expression>()> expr,
+        std::function<Own<ram::Condition>()> cond) {
+    return [=]() -> Own<ram::Statement> {
+        VecOwn<ram::Expression> result;
+        result.push_back(elem(1, 0));
+        auto agg = mk<ram::Aggregate>(
+                mk<ram::SubroutineReturn>(std::move(result)), op, "a", expr(), cond(), 1);
+        VecOwn<ram::Expression> range;
+        range.push_back(mk<ram::SignedConstant>(0));
+        range.push_back(mk<ram::SignedConstant>(SCANS));
+        return mk<ram::Query>(mk<ram::NestedIntrinsicOperator>(
+                ram::NestedIntrinsicOp::RANGE, std::move(range), std::move(agg), 0));
+    };
+}
+
+inline Pattern total(char type, std::function<Own<ram::Expression>()> expr) {
+    return aggregate(sum(type), std::move(expr), []() { return mk<ram::True>(); });
+}
+
+inline Pattern count(std::function<Own<ram::Condition>()> cond) {
+    return aggregate(AggregateOp::SUM, []() { return mk<ram::SignedConstant>(1); }, std::move(cond));
+}
+
+/** (t1[1] * t1[2]) + (t1[0] - t1[1]), in the given type */
+inline Own<ram::Expression> polynomial(char type) {
+    auto product = functor(typed(FunctorOp::MUL, type), elem(1, 1), elem(1, 2));
+    auto difference = functor(typed(FunctorOp::SUB, type), elem(1, 0), elem(1, 1));
+    return functor(typed(FunctorOp::ADD, type), std::move(product), std::move(difference));
+}
+
+inline Own<ram::Condition> less(Own<ram::Expression> lhs, Own<ram::Expression> rhs) {
+    return mk<ram::Constraint>(BinaryConstraintOp::LT, std::move(lhs), std::move(rhs));
+}
+
+/** Insert the elements of the tuple t into the relation b */
+inline Own<ram::Operation> insertInto(const std::string& rel, std::size_t t) {
+    VecOwn<ram::Expression> values;
+    values.push_back(elem(t, 0));
+    values.push_back(elem(t, 1));
+    values.push_back(elem(t, 2));
+    return mk<ram::Insert>(rel, std::move(values));
+}
+
+/**
+ * Evaluate a query in a program with the relation a of the given representation, which holds QUERY_N
+ * tuples of scrambled values, the relation c of every third value of [-500, 500), and the relation b
+ * into which the query inserts
+ *
+ * @return the size of b and the sum of each of its elements, and the time the query took in seconds
+ */
+inline std::pair<std::vector<RamDomain>, double> evalQuery(
+        RelationRepresentation representation, Own<ram::Operation> query, bool batching) {
+    Global::config().set("jobs", "1");
+    if (batching) {
+        Global::config().unset("disable-batching");
+    } else {
+        Global::config().set("disable-batching");
+    }
+
+    VecOwn<ram::Relation> rels;
+    const std::vector<std::string> names{"x", "y", "z"};
+    const std::vector<std::string> types{"i", "i", "i"};
+    rels.push_back(mk<ram::Relation>("a", 3, 0, names, types, representation));
+    rels.push_back(mk<ram::Relation>("b", 3, 0, names, types, RelationRepresentation::BTREE));
+    rels.push_back(mk<ram::Relation>("c", 1, 0, std::vector<std::string>{"x"},
+            std::vector<std::string>{"i"}, RelationRepresentation::BTREE));
+
+    VecOwn<ram::Expression> values;
+    values.push_back(elem(0, 0));
+    values.push_back(scramble(7919));
+    values.push_back(scramble(104729));
+    VecOwn<ram::Expression> range;
+    range.push_back(num(0));
+    range.push_back(num(QUERY_N));
+    VecOwn<ram::Statement> fill;
+    fill.push_back(mk<ram::Query>(mk<ram::NestedIntrinsicOperator>(ram::NestedIntrinsicOp::RANGE,
+            std::move(range), mk<ram::Insert>("a", std::move(values)), 0)));
+    VecOwn<ram::Expression> thirds;
+    thirds.push_back(num(-500));
+    thirds.push_back(num(500));
+    thirds.push_back(num(3));
+    VecOwn<ram::Expression> third;
+    third.push_back(elem(0, 0));
+    fill.push_back(mk<ram::Query>(mk<ram::NestedIntrinsicOperator>(ram::NestedIntrinsicOp::RANGE,
+            std::move(thirds), mk<ram::Insert>("c", std::move(third)), 0)));
+
+    VecOwn<ram::Expression> result;
+    result.push_back(mk<ram::RelationSize>("b"));
+    VecOwn<ram::Statement> check;
+    check.push_back(mk<ram::Query>(mk<ram::SubroutineReturn>(std::move(result))));
+    for (std::size_t i = 0; i < 3; ++i) {
+        VecOwn<ram::Expression> sum;
+        sum.push_back(elem(1, 0));
+        check.push_back(mk<ram::Query>(mk<ram::Aggregate>(mk<ram::SubroutineReturn>(std::move(sum)),
+                AggregateOp::SUM, "b", elem(1, i), mk<ram::True>(), 1)));
+    }
+
+    std::map<std::string, Own<ram::Statement>> subs;
+    subs.insert(std::make_pair("fill", mk<ram::Sequence>(std::move(fill))));
+    subs.insert(std::make_pair("test", mk<ram::Query>(std::move(query))));
+    subs.insert(std::make_pair("check", mk<ram::Sequence>(std::move(check))));
+    Own<ram::Program> prog = mk<ram::Program>(std::move(rels), mk<ram::Sequence>(), std::move(subs));
+
+    ErrorReport errReport;
+    DebugReport debugReport;
+    ram::TranslationUnit translationUnit(std::move(prog), errReport, debugReport);
+    Own<Engine> interpreter = mk<Engine>(translationUnit);
+
+    std::vector<RamDomain> ret;
+    interpreter->executeSubroutine("fill", {}, ret);
+    auto start = std::chrono::high_resolution_clock::now();
+    interpreter->executeSubroutine("test", {}, ret);
+    auto end = std::chrono::high_resolution_clock::now();
+    interpreter->executeSubroutine("check", {}, ret);
+
+    Global::config().unset("disable-batching");
+    return {ret, std::chrono::duration<double>(end - start).count()};
+}
+
+/** A query inserting into the relation b */
+using QueryPattern = std::function<Own<ram::Operation>()>;
+
+/** for t0 in a: if t0[1] < c: insert t0 into b */
+inline QueryPattern selective(RamDomain bound) {
+    return [=]() -> Own<ram::Operation> {
+        return mk<ram::Scan>("a", 0, mk<ram::Filter>(less(elem(0, 1), num(bound)), insertInto("b", 0)));
+    };
+}
+
+/** for t0 in a: if t0[1] < 0 and not (t0[2]) in c: insert t0 into b */
+inline Own<ram::Operation> negation() {
+    VecOwn<ram::Expression> values;
+    values.push_back(elem(0, 2));
+    auto missing = mk<ram::Negation>(mk<ram::ExistenceCheck>("c", std::move(values)));
+    auto cond = mk<ram::Conjunction>(less(elem(0, 1), num(0)), std::move(missing));
+    return mk<ram::Scan>("a", 0, mk<ram::Filter>(std::move(cond), insertInto("b", 0)));
+}
+
+/** for t0 in a: if t0[1] < -495: for t1 in a: if t1[0] < 300 and t1[2] = t0[2]: insert t1 into b */
+inline Own<ram::Operation> join() {
+    auto cond = mk<ram::Conjunction>(less(elem(1, 0), num(300)),
+            mk<ram::Constraint>(BinaryConstraintOp::EQ, elem(1, 2), elem(0, 2)));
+    auto inner = mk<ram::Scan>("a", 1, mk<ram::Filter>(std::move(cond), insertInto("b", 1)));
+    return mk<ram::Scan>("a", 0, mk<ram::Filter>(less(elem(0, 1), num(-495)), std::move(inner)));
+}
+
+}  // namespace souffle::interpreter::test
@@ -0,0 +1,154 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ram_expression_test.cpp
+ *
+ * Tests that the typed evaluators which the Interpreter compiles numeric
+ * expressions to agree with the generic evaluation.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "FunctorOps.h"
+#include "interpreter/tests/ram_eval.h"
+#include "ram/Constraint.h"
+#include "ram/Expression.h"
+#include "ram/SignedConstant.h"
+#include "souffle/BinaryConstraintOps.h"
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::interpreter::test {
+
+/** The negation of an expression of the given type, which is a complement if it is unsigned */
+Own<ram::Expression> negate(char type, Own<ram::Expression> expr) {
+    switch (type) {
+        case 'u': return functor(FunctorOp::UBNOT, std::move(expr));
+        case 'f': return functor(FunctorOp::FNEG, std::move(expr));
+        default: return functor(FunctorOp::NEG, std::move(expr));
+    }
+}
+
+/** Check that a pattern yields the same results with and without typed evaluators */
+bool typingAgrees(char type, const Pattern& pattern) {
+    auto typed = evalStatement(type, pattern(), true);
+    auto generic = evalStatement(type, pattern(), false);
+    return typed.first.size() == static_cast<std::size_t>(SCANS) && typed.first == generic.first;
+}
+
+TEST(Typing, Arithmetic) {
+    for (char type : std::string("iuf")) {
+        EXPECT_TRUE(typingAgrees(type, total(type, [=]() { return polynomial(type); })));
+
+        // (t1[0] * c + t1[1]) / c
+        Pattern quotient = total(type, [=]() {
+            auto product = functor(typed(FunctorOp::MUL, type), elem(1, 0), constant(type, 5));
+            auto lhs = functor(typed(FunctorOp::ADD, type), std::move(product), elem(1, 1));
+            return functor(typed(FunctorOp::DIV, type), std::move(lhs), constant(type, 7));
+        });
+        EXPECT_TRUE(typingAgrees(type, quotient));
+
+        // max and min of more than two arguments
+        for (FunctorOp op : {FunctorOp::MAX, FunctorOp::MIN}) {
+            Pattern extremum = total(type, [=]() {
+                VecOwn<ram::Expression> args;
+                args.push_back(elem(1, 0));
+                args.push_back(functor(typed(FunctorOp::MUL, type), elem(1, 1), constant(type, 2)));
+                args.push_back(elem(1, 2));
+                args.push_back(constant(type, 100));
+                return functor(typed(op, type), std::move(args));
+            });
+            EXPECT_TRUE(typingAgrees(type, extremum));
+        }
+
+        // negation of a product
+        Pattern negation = total(type, [=]() {
+            auto product = functor(typed(FunctorOp::MUL, type), elem(1, 1), elem(1, 2));
+            return negate(type, std::move(product));
+        });
+        EXPECT_TRUE(typingAgrees(type, negation));
+    }
+
+    // remainders of t1[2] - t1[1] by c
+    for (char type : std::string("iu")) {
+        Pattern remainder = total(type, [=]() {
+            auto difference = functor(typed(FunctorOp::SUB, type), elem(1, 2), elem(1, 1));
+            return functor(typed(FunctorOp::MOD, type), std::move(difference), constant(type, 9));
+        });
+        EXPECT_TRUE(typingAgrees(type, remainder));
+    }
+}
+
+TEST(Typing, Conversions) {
+    // float(t1[1]) * 0.75 - float(signed(t1[2]) & 7), in each direction of conversion
+    Pattern fromSigned = total('f', []() {
+        auto product = functor(FunctorOp::FMUL, functor(FunctorOp::I2F, elem(1, 1)), constant('f', 3));
+        auto mask = functor(FunctorOp::BAND, functor(FunctorOp::I2I, elem(1, 2)), mk<ram::SignedConstant>(7));
+        return functor(FunctorOp::FSUB, std::move(product), functor(FunctorOp::I2F, std::move(mask)));
+    });
+    EXPECT_TRUE(typingAgrees('i', fromSigned));
+
+    // signed(t1[1] / 3.0) + signed(unsigned(t1[0]) ^ 5)
+    Pattern toSigned = total('i', []() {
+        auto quotient = functor(FunctorOp::FDIV, elem(1, 1), constant('f', 12));
+        auto mask = functor(FunctorOp::UBXOR, functor(FunctorOp::F2U, elem(1, 0)), constant('u', 5));
+        auto lhs = functor(FunctorOp::F2I, std::move(quotient));
+        return functor(FunctorOp::ADD, std::move(lhs), functor(FunctorOp::U2I, std::move(mask)));
+    });
+    EXPECT_TRUE(typingAgrees('f', toSigned));
+
+    // float(t1[1] | 3) + float(signed(t1[2]))
+    Pattern fromUnsigned = total('f', []() {
+        auto lhs = functor(FunctorOp::U2F, functor(FunctorOp::UBOR, elem(1, 1), constant('u', 3)));
+        auto rhs = functor(FunctorOp::I2F, functor(FunctorOp::U2I, elem(1, 2)));
+        return functor(FunctorOp::FADD, std::move(lhs), std::move(rhs));
+    });
+    EXPECT_TRUE(typingAgrees('u', fromUnsigned));
+}
+
+TEST(Typing, Constraints) {
+    const std::vector<std::pair<BinaryConstraintOp, char>> ops = {{BinaryConstraintOp::EQ, 'i'},
+            {BinaryConstraintOp::NE, 'i'}, {BinaryConstraintOp::FEQ, 'f'}, {BinaryConstraintOp::FNE, 'f'},
+            {BinaryConstraintOp::LT, 'i'}, {BinaryConstraintOp::ULT, 'u'}, {BinaryConstraintOp::FLT, 'f'},
+            {BinaryConstraintOp::GE, 'i'}, {BinaryConstraintOp::UGE, 'u'}, {BinaryConstraintOp::FGE, 'f'}};
+
+    for (const auto& entry : ops) {
+        BinaryConstraintOp op = entry.first;
+        char type = entry.second;
+        // t1[1] * t1[2] op t1[0] + t0[0]
+        Pattern pattern = count([=]() {
+            auto lhs = functor(typed(FunctorOp::MUL, type), elem(1, 1), elem(1, 2));
+            auto rhs = functor(typed(FunctorOp::ADD, type), elem(1, 0), convert(type, elem(0, 0)));
+            return mk<ram::Constraint>(op, std::move(lhs), std::move(rhs));
+        });
+        EXPECT_TRUE(typingAgrees(type, pattern));
+        // t1[1] - t1[2] op c
+        Pattern bound = count([=]() {
+            auto lhs = functor(typed(FunctorOp::SUB, type), elem(1, 1), elem(1, 2));
+            return mk<ram::Constraint>(op, std::move(lhs), constant(type, 10));
+        });
+        EXPECT_TRUE(typingAgrees(type, bound));
+    }
+}
+
+TEST(Typing, Generic) {
+    // functors without a typed evaluator are evaluated generically, within and around typed ones
+    Pattern shift = total('i', []() {
+        auto product = functor(FunctorOp::MUL, elem(1, 1), elem(1, 2));
+        auto shifted = functor(FunctorOp::BSHIFT_L, std::move(product), mk<ram::SignedConstant>(2));
+        return functor(FunctorOp::ADD, std::move(shifted), functor(FunctorOp::NEG, elem(1, 0)));
+    });
+    EXPECT_TRUE(typingAgrees('i', shift));
+}
+
+}  // namespace souffle::interpreter::test
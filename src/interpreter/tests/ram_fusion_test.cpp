@@ -0,0 +1,114 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ram_fusion_test.cpp
+ *
+ * Tests that the fused constraints and functors of the Interpreter agree
+ * with their generic evaluation.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "FunctorOps.h"
+#include "interpreter/tests/ram_eval.h"
+#include "ram/Constraint.h"
+#include "ram/SignedConstant.h"
+#include "ram/True.h"
+#include "souffle/BinaryConstraintOps.h"
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::interpreter::test {
+
+/** Check that a pattern yields the same results with and without fusion */
+bool fusionAgrees(char type, const Pattern& pattern) {
+    auto fused = evalStatement(type, pattern(), true);
+    auto generic = evalStatement(type, pattern(), false);
+    return fused.first.size() == static_cast<std::size_t>(SCANS) && fused.first == generic.first;
+}
+
+TEST(Fusion, Constraints) {
+    const std::vector<std::pair<BinaryConstraintOp, char>> ops = {{BinaryConstraintOp::EQ, 'i'},
+            {BinaryConstraintOp::NE, 'i'}, {BinaryConstraintOp::FEQ, 'f'}, {BinaryConstraintOp::FNE, 'f'},
+            {BinaryConstraintOp::LT, 'i'}, {BinaryConstraintOp::ULT, 'u'}, {BinaryConstraintOp::FLT, 'f'},
+            {BinaryConstraintOp::LE, 'i'}, {BinaryConstraintOp::ULE, 'u'}, {BinaryConstraintOp::FLE, 'f'},
+            {BinaryConstraintOp::GT, 'i'}, {BinaryConstraintOp::UGT, 'u'}, {BinaryConstraintOp::FGT, 'f'},
+            {BinaryConstraintOp::GE, 'i'}, {BinaryConstraintOp::UGE, 'u'}, {BinaryConstraintOp::FGE, 'f'}};
+
+    for (const auto& entry : ops) {
+        BinaryConstraintOp op = entry.first;
+        char type = entry.second;
+        std::vector<Pattern> patterns;
+        // t1[1] op t1[2]
+        patterns.push_back(count([=]() { return mk<ram::Constraint>(op, elem(1, 1), elem(1, 2)); }));
+        // t1[1] + c op t1[2]
+        patterns.push_back(count([=]() {
+            auto lhs = functor(typed(FunctorOp::ADD, type), elem(1, 1), constant(type, 3));
+            return mk<ram::Constraint>(op, std::move(lhs), elem(1, 2));
+        }));
+        // c op t1[2] - c
+        patterns.push_back(count([=]() {
+            auto rhs = functor(typed(FunctorOp::SUB, type), elem(1, 2), constant(type, -5));
+            return mk<ram::Constraint>(op, constant(type, 7), std::move(rhs));
+        }));
+        // c + t1[1] op t1[2] - c
+        patterns.push_back(count([=]() {
+            auto lhs = functor(typed(FunctorOp::ADD, type), constant(type, 11), elem(1, 1));
+            auto rhs = functor(typed(FunctorOp::SUB, type), elem(1, 2), constant(type, 2));
+            return mk<ram::Constraint>(op, std::move(lhs), std::move(rhs));
+        }));
+        for (const auto& pattern : patterns) {
+            EXPECT_TRUE(fusionAgrees(type, pattern));
+        }
+    }
+}
+
+TEST(Fusion, Functors) {
+    const std::vector<std::pair<FunctorOp, std::string>> ops = {{FunctorOp::ADD, "iuf"},
+            {FunctorOp::SUB, "iuf"}, {FunctorOp::MUL, "iuf"}, {FunctorOp::MAX, "iuf"},
+            {FunctorOp::MIN, "iuf"}, {FunctorOp::BAND, "iu"}, {FunctorOp::BOR, "iu"},
+            {FunctorOp::BXOR, "iu"}};
+    auto always = []() { return mk<ram::True>(); };
+
+    for (const auto& entry : ops) {
+        for (char type : entry.second) {
+            FunctorOp op = typed(entry.first, type);
+            std::vector<Pattern> patterns;
+            // t1[1] op t1[2]
+            patterns.push_back(
+                    aggregate(sum(type), [=]() { return functor(op, elem(1, 1), elem(1, 2)); }, always));
+            // (t1[1] - c) op c
+            patterns.push_back(aggregate(sum(type),
+                    [=]() {
+                        auto lhs = functor(typed(FunctorOp::SUB, type), elem(1, 1), constant(type, 9));
+                        return functor(op, std::move(lhs), constant(type, 6));
+                    },
+                    always));
+            for (const auto& pattern : patterns) {
+                EXPECT_TRUE(fusionAgrees(type, pattern));
+            }
+        }
+    }
+}
+
+TEST(Fusion, Generic) {
+    // operands which are not simple terms are compiled to typed evaluators instead
+    Pattern pattern = count([]() {
+        auto lhs = functor(FunctorOp::MOD, elem(1, 1), mk<ram::SignedConstant>(7));
+        auto rhs = functor(FunctorOp::ADD, elem(1, 2), elem(0, 0));
+        return mk<ram::Constraint>(BinaryConstraintOp::LT, std::move(lhs), std::move(rhs));
+    });
+    EXPECT_TRUE(fusionAgrees('i', pattern));
+}
+
+}  // namespace souffle::interpreter::test
@@ -0,0 +1,130 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file spill_manager_test.cpp
+ *
+ * Tests the spilling of interpreter relations under a memory budget.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "AggregateOp.h"
+#include "Global.h"
+#include "RelationTag.h"
+#include "interpreter/Engine.h"
+#include "interpreter/ProgInterface.h"
+#include "interpreter/SpillManager.h"
+#include "ram/Aggregate.h"
+#include "ram/Expression.h"
+#include "ram/Insert.h"
+#include "ram/NestedIntrinsicOperator.h"
+#include "ram/Program.h"
+#include "ram/Query.h"
+#include "ram/Relation.h"
+#include "ram/Sequence.h"
+#include "ram/SignedConstant.h"
+#include "ram/Statement.h"
+#include "ram/SubroutineReturn.h"
+#include "ram/TranslationUnit.h"
+#include "ram/True.h"
+#include "ram/TupleElement.h"
+#include "reports/DebugReport.h"
+#include "reports/ErrorReport.h"
+#include "souffle/RamTypes.h"
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::interpreter::test {
+
+/** Whether parsing the given size is rejected */
+bool rejected(const std::string& size) {
+    try {
+        SpillManager::parseSize(size);
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+TEST(SpillManager, ParseSize) {
+    EXPECT_EQ(0, SpillManager::parseSize("0"));
+    EXPECT_EQ(512, SpillManager::parseSize("512B"));
+    EXPECT_EQ(std::size_t(3) << 10, SpillManager::parseSize("3k"));
+    EXPECT_EQ(std::size_t(512) << 20, SpillManager::parseSize("512M"));
+    EXPECT_EQ(std::size_t(64) << 30, SpillManager::parseSize("64gb"));
+    EXPECT_EQ(std::size_t(2) << 40, SpillManager::parseSize("2T"));
+
+    EXPECT_TRUE(rejected(""));
+    EXPECT_TRUE(rejected("G"));
+    EXPECT_TRUE(rejected("-1"));
+    EXPECT_TRUE(rejected(" 1"));
+    EXPECT_TRUE(rejected("1X"));
+    EXPECT_TRUE(rejected("1 G"));
+    EXPECT_TRUE(rejected("99999999999999999999999"));
+    EXPECT_TRUE(rejected("99999999999T"));
+}
+
+TEST(SpillManager, Interface) {
+    // the relations are spilled during evaluation, and stay resident for the program interface
+    const RamDomain n = 1000;
+    Global::config().set("jobs", "1");
+    Global::config().set("memory-budget", "1");
+
+    VecOwn<ram::Relation> rels;
+    for (const std::string name : {"a", "b"}) {
+        rels.push_back(mk<ram::Relation>(name, 1, 0, std::vector<std::string>{"x"},
+                std::vector<std::string>{"i"}, RelationRepresentation::BTREE));
+    }
+
+    VecOwn<ram::Statement> fill;
+    for (const std::string name : {"a", "b"}) {
+        VecOwn<ram::Expression> range;
+        range.push_back(mk<ram::SignedConstant>(0));
+        range.push_back(mk<ram::SignedConstant>(n));
+        VecOwn<ram::Expression> values;
+        values.push_back(mk<ram::TupleElement>(0, 0));
+        fill.push_back(mk<ram::Query>(mk<ram::NestedIntrinsicOperator>(ram::NestedIntrinsicOp::RANGE,
+                std::move(range), mk<ram::Insert>(name, std::move(values)), 0)));
+    }
+
+    VecOwn<ram::Expression> result;
+    result.push_back(mk<ram::TupleElement>(0, 0));
+    auto count = mk<ram::Query>(mk<ram::Aggregate>(mk<ram::SubroutineReturn>(std::move(result)),
+            AggregateOp::COUNT, "b", mk<ram::SignedConstant>(0), mk<ram::True>(), 0));
+    std::map<std::string, Own<ram::Statement>> subs;
+    subs.insert(std::make_pair("count", std::move(count)));
+
+    Own<ram::Program> prog =
+            mk<ram::Program>(std::move(rels), mk<ram::Sequence>(std::move(fill)), std::move(subs));
+    ErrorReport errReport;
+    DebugReport debugReport;
+    ram::TranslationUnit translationUnit(std::move(prog), errReport, debugReport);
+    Own<Engine> interpreter = mk<Engine>(translationUnit);
+    interpreter->executeMain();
+    Global::config().unset("memory-budget");
+
+    ProgInterface interface(*interpreter);
+    for (int i = 0; i < 3; ++i) {
+        std::vector<RamDomain> ret;
+        interpreter->executeSubroutine("count", {}, ret);
+        ASSERT_TRUE(ret.size() == 1);
+        EXPECT_EQ(n, ret[0]);
+        EXPECT_EQ(n, interface.getRelation("a")->size());
+        EXPECT_EQ(n, interface.getRelation("b")->size());
+    }
+}
+
+}  // namespace souffle::interpreter::test
@@ -0,0 +1,85 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file tuple_arena_test.cpp
+ *
+ * Tests the arena of temporary tuples of the interpreter.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "interpreter/Context.h"
+#include "souffle/RamTypes.h"
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace souffle::interpreter::test {
+
+TEST(TupleArena, Scopes) {
+    Context ctxt;
+    RamDomain* outer = nullptr;
+    RamDomain* first = nullptr;
+    {
+        TupleArena::Scope scope;
+        outer = ctxt.allocateNewTuple(3);
+        outer[0] = 1;
+        outer[2] = 3;
+        {
+            TupleArena::Scope inner;
+            first = ctxt.allocateNewTuple(5);
+            EXPECT_TRUE(first >= outer + 3 || first + 5 <= outer);
+        }
+        // the memory of a released scope is reused
+        {
+            TupleArena::Scope inner;
+            EXPECT_EQ(first, ctxt.allocateNewTuple(5));
+        }
+        EXPECT_EQ(1, outer[0]);
+        EXPECT_EQ(3, outer[2]);
+    }
+    TupleArena::Scope scope;
+    EXPECT_EQ(outer, ctxt.allocateNewTuple(3));
+}
+
+TEST(TupleArena, Blocks) {
+    // tuples beyond a block, and larger than a block, keep their values
+    Context ctxt;
+    TupleArena::Scope scope;
+    std::vector<RamDomain*> tuples;
+    for (std::size_t i = 0; i < 100; ++i) {
+        std::size_t size = i % 10 == 0 ? 10000 : 100;
+        RamDomain* tuple = ctxt.allocateNewTuple(size);
+        tuple[0] = static_cast<RamDomain>(i);
+        tuple[size - 1] = static_cast<RamDomain>(i);
+        tuples.push_back(tuple);
+    }
+    for (std::size_t i = 0; i < tuples.size(); ++i) {
+        std::size_t size = i % 10 == 0 ? 10000 : 100;
+        EXPECT_EQ(static_cast<RamDomain>(i), tuples[i][0]);
+        EXPECT_EQ(static_cast<RamDomain>(i), tuples[i][size - 1]);
+    }
+}
+
+TEST(TupleArena, Threads) {
+    // each thread allocates from its own arena
+    TupleArena::Scope scope;
+    RamDomain* mainTuple = Context().allocateNewTuple(1);
+    RamDomain* threadTuple = nullptr;
+    std::thread thread([&]() {
+        TupleArena::Scope scope;
+        threadTuple = Context().allocateNewTuple(1);
+    });
+    thread.join();
+    EXPECT_TRUE(mainTuple != threadTuple);
+}
+
+}  // namespace souffle::interpreter::test
@@ -74,6 +74,7 @@
 #include "ram/transform/Conditional.h"
 #include "ram/transform/EliminateDuplicates.h"
 #include "ram/transform/ExpandFilter.h"
+#include "ram/transform/GroupAggregate.h"
 #include "ram/transform/HoistAggregate.h"
 #include "ram/transform/HoistConditions.h"
 #include "ram/transform/IfConversion.h"
@@ -89,6 +90,7 @@
 #include "ram/transform/TupleId.h"
 #include "reports/DebugReport.h"
 #include "reports/ErrorReport.h"
+#include "souffle/QueryServer.h"
 #include "souffle/RamTypes.h"
 #include "souffle/profile/Tui.h"
 #include "souffle/provenance/Explain.h"
@@ -235,7 +237,7 @@ int main(int argc, char** argv) {
                 {"no-warn", 'w', "", "", false, "Disable warnings."},
                 {"magic-transform", 'm', "RELATIONS", "", false,
                         "Enable magic set transformation changes on the given relations, use '*' "
-                        "for all."},
+                        "for all, or 'auto' to select relations by a cost model."},
                 {"macro", 'M', "MACROS", "", false, "Set macro definitions for the pre-processor"},
                 {"disable-transformers", 'z', "TRANSFORMERS", "", false,
                         "Disable the given AST transformers."},
@@ -247,10 +249,29 @@ int main(int argc, char** argv) {
                 {"profile-use", 'u', "FILE", "", false,
                         "Use profile log-file <FILE> for profile-guided optimization."},
                 {"profile-frequency", '\2', "", "", false, "Enable the frequency counter in the profiler."},
+                {"profile-sampling", '\12', "USEC", "", false,
+                        "Sample the rules executed by each thread every <USEC> microseconds instead of "
+                        "timing every rule evaluation when profiling."},
+                {"profile-counters", '\13', "", "", false,
+                        "Record the hardware performance counters of each rule when profiling."},
+                {"group-aggregates", '\15', "", "", false,
+                        "Evaluate aggregates over the keys of a full scan once per group of the "
+                        "aggregated relation instead of once per key; the scan is not parallelized."},
                 {"debug-report", 'r', "FILE", "", false, "Write HTML debug report to <FILE>."},
                 {"pragma", 'P', "OPTIONS", "", false, "Set pragma options."},
                 {"provenance", 't', "[ none | explain | explore ]", "", false,
                         "Enable provenance instrumentation and interaction."},
+                {"provenance-storage", '\14', "[ inline | compact ]", "", false,
+                        "Store the provenance annotations of the interpreter within the tuples of all "
+                        "indexes (inline, default) or next to the main index only (compact)."},
+                {"server", '\7', "SOCKET", "", false,
+                        "Keep the program resident after evaluation and serve queries on the Unix "
+                        "domain socket <SOCKET>."},
+                {"memory-budget", '\10', "SIZE", "", false,
+                        "Spill cold relations of the interpreter to disk when relations occupy more than "
+                        "<SIZE> bytes (e.g. 64G)."},
+                {"spill-dir", '\11', "DIR", "", false,
+                        "Directory for relations spilled by --memory-budget (default: $TMPDIR or /tmp)."},
                 {"verbose", 'v', "", "", false, "Verbose output."},
                 {"version", '\3', "", "", false, "Version."},
                 {"show", '\4',
@@ -377,6 +398,33 @@ int main(int argc, char** argv) {
         if (Global::config().has("live-profile") && !Global::config().has("profile")) {
             Global::config().set("profile");
         }
+
+        /* sampling replaces the timers of the profiler */
+        if (Global::config().has("profile-sampling")) {
+            if (!Global::config().has("profile")) {
+                throw std::runtime_error("--profile-sampling requires -p/--profile.");
+            }
+            if (!isNumber(Global::config().get("profile-sampling").c_str()) ||
+                    std::stol(Global::config().get("profile-sampling")) < 1) {
+                throw std::runtime_error("--profile-sampling may only be set to an integer greater than 0.");
+            }
+        }
+
+        if (Global::config().has("provenance-storage") &&
+                !Global::config().has("provenance-storage", "inline") &&
+                !Global::config().has("provenance-storage", "compact")) {
+            throw std::runtime_error("--provenance-storage may only be set to inline or compact.");
+        }
+
+        /* hardware counters are read around the timers of the profiler */
+        if (Global::config().has("profile-counters")) {
+            if (!Global::config().has("profile")) {
+                throw std::runtime_error("--profile-counters requires -p/--profile.");
+            }
+            if (Global::config().has("profile-sampling")) {
+                throw std::runtime_error("--profile-counters cannot be combined with --profile-sampling.");
+            }
+        }
     } catch (std::exception& e) {
         std::cerr << e.what() << std::endl;
         exit(EXIT_FAILURE);
@@ -451,6 +499,17 @@ int main(int argc, char** argv) {
     /* set up additional global options based on pragma declaratives */
     (mk<ast::transform::PragmaChecker>())->apply(*astTranslationUnit);
 
+    /* the memory budget may be given by a pragma, hence it is checked once pragmas are applied */
+    if (Global::config().has("memory-budget")) {
+        try {
+            interpreter::SpillManager::parseSize(Global::config().get("memory-budget"));
+        } catch (const std::invalid_argument& e) {
+            std::cerr << "--memory-budget may only be set to a size such as 512M or 64G: " << e.what()
+                      << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
     /* construct the transformation pipeline */
 
     // Equivalence pipeline
@@ -607,6 +666,10 @@ int main(int argc, char** argv) {
                 mk<CollapseFiltersTransformer>(), mk<TupleIdTransformer>(),
                 mk<LoopTransformer>(
                         mk<TransformerSequence>(mk<HoistAggregateTransformer>(), mk<TupleIdTransformer>())),
+                mk<ConditionalTransformer>(
+                        []() -> bool { return Global::config().has("group-aggregates"); },
+                        mk<TransformerSequence>(mk<GroupAggregateTransformer>(),
+                                mk<IfConversionTransformer>(), mk<TupleIdTransformer>())),
                 mk<ExpandFilterTransformer>(), mk<HoistConditionsTransformer>(),
                 mk<CollapseFiltersTransformer>(), mk<EliminateDuplicatesTransformer>(),
                 mk<ReorderConditionsTransformer>(), mk<LoopTransformer>(mk<ReorderFilterBreak>()),
@@ -656,6 +719,11 @@ int main(int argc, char** argv) {
                     explain(interface, true);
                 }
             }
+            if (Global::config().has("server")) {
+                interpreter::ProgInterface interface(*interpreter);
+                serveQueries(
+                        interface, Global::config().get("server"), std::stoi(Global::config().get("jobs")));
+            }
         } else {
             // ------- compiler -------------
             auto synthesiser = mk<synthesiser::Synthesiser>(*ramTranslationUnit);
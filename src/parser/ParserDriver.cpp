@@ -153,6 +153,20 @@ void ParserDriver::addDirective(Own<ast::Directive> directive) {
                 return;
             }
         }
+    } else if (directive->getType() == ast::DirectiveType::query) {
+        for (const auto& cur : program.getDirectives()) {
+            if (cur->getQualifiedName() == directive->getQualifiedName() &&
+                    cur->getType() == ast::DirectiveType::query &&
+                    cur->getParameter("adornment") == directive->getParameter("adornment")) {
+                Diagnostic err(Diagnostic::Type::ERROR,
+                        DiagnosticMessage("Redefinition of query directive for relation " +
+                                                  toString(directive->getQualifiedName()),
+                                directive->getSrcLoc()),
+                        {DiagnosticMessage("Previous definition", cur->getSrcLoc())});
+                translationUnit->getErrorReport().addDiagnostic(err);
+                return;
+            }
+        }
     }
     program.addDirective(std::move(directive));
 }
@@ -210,8 +224,8 @@ std::set<RelationTag> ParserDriver::addDeprecatedTag(
 
 std::set<RelationTag> ParserDriver::addReprTag(
         RelationTag tag, SrcLocation tagLoc, std::set<RelationTag> tags) {
-    return addTag(tag, {RelationTag::BTREE, RelationTag::BRIE, RelationTag::EQREL}, std::move(tagLoc),
-            std::move(tags));
+    return addTag(tag, {RelationTag::BTREE, RelationTag::BRIE, RelationTag::EQREL, RelationTag::MIN},
+            std::move(tagLoc), std::move(tags));
 }
 
 std::set<RelationTag> ParserDriver::addTag(RelationTag tag, SrcLocation tagLoc, std::set<RelationTag> tags) {
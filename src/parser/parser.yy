@@ -252,6 +252,7 @@
 %token OUTPUT_DECL               "output directives declaration"
 %token PRINTSIZE_DECL            "printsize directives declaration"
 %token LIMITSIZE_DECL            "limitsize directives declaration"
+%token QUERY_DECL                "query directive declaration"
 %token OVERRIDE                  "override rules of super-component"
 %token TYPE                      "type declaration"
 %token COMPONENT                 "component declaration"
@@ -342,6 +343,7 @@
 %type <Mov<VecOwn<ast::Directive>>>            directive_list
 %type <Mov<VecOwn<ast::Directive>>>            directive_head
 %type <ast::DirectiveType>                     directive_head_decl
+%type <Mov<std::string>>                       query_adornment
 %type <Mov<VecOwn<ast::Directive>>>            relation_directive_list
 %type <Mov<std::string>>                       kvp_value
 %type <Mov<VecOwn<ast::Argument>>>             non_empty_arg_list
@@ -528,6 +530,7 @@ relation_tags
   | relation_tags        BRIE_QUALIFIER { $$ = driver.addReprTag(RelationTag::BRIE    , @2, $1); }
   | relation_tags       BTREE_QUALIFIER { $$ = driver.addReprTag(RelationTag::BTREE   , @2, $1); }
   | relation_tags       EQREL_QUALIFIER { $$ = driver.addReprTag(RelationTag::EQREL   , @2, $1); }
+  | relation_tags                   MIN { $$ = driver.addReprTag(RelationTag::MIN     , @2, $1); }
   ;
 
   /* List of variables */
@@ -930,6 +933,27 @@ directive_head
             $$.push_back(std::move(io));
         }
     }
+  | QUERY_DECL identifier LPAREN query_adornment RPAREN {
+        auto query = mk<ast::Directive>(ast::DirectiveType::query, $identifier, @identifier);
+        query->addParameter("adornment", $query_adornment);
+        $$.push_back(std::move(query));
+    }
+  ;
+
+/* Binding pattern of a query: `b` for bound and `f` for free arguments */
+query_adornment
+  :                       IDENT {
+        if ($IDENT != "b" && $IDENT != "f") {
+            driver.error(@IDENT, "binding of a query argument must be either b or f");
+        }
+        $$ = $IDENT;
+    }
+  | query_adornment COMMA IDENT {
+        if ($IDENT != "b" && $IDENT != "f") {
+            driver.error(@IDENT, "binding of a query argument must be either b or f");
+        }
+        $$ = *$1 + $IDENT;
+    }
   ;
 
 directive_head_decl
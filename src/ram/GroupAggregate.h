@@ -0,0 +1,117 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file GroupAggregate.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "AggregateOp.h"
+#include "ram/AbstractAggregate.h"
+#include "ram/Condition.h"
+#include "ram/Expression.h"
+#include "ram/Node.h"
+#include "ram/Operation.h"
+#include "ram/RelationOperation.h"
+#include "ram/utility/NodeMapper.h"
+#include "ram/utility/Utils.h"
+#include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/StreamUtil.h"
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram {
+
+/**
+ * @class GroupAggregate
+ * @brief Aggregation function applied to each group of a relation
+ *
+ * The relation is scanned once in the order of an index starting with the
+ * group columns, so that the tuples of a group are adjacent. The nested
+ * operation is executed once per group; its tuple holds the result of the
+ * aggregate in element 0, followed by the values of the group columns.
+ *
+ * For example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * t0.0=sum t0.2 FOR ALL t0 ∈ data GROUP BY (t0.1)
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * sums up the third column of data for each value of the second column,
+ * which is available to the nested operation as t0.1.
+ *
+ * Groups are formed from the tuples present in the relation; a group whose
+ * tuples are all rejected by the condition behaves like an aggregate over
+ * an empty range, i.e. count and sum produce zero and the other functions
+ * produce no result.
+ */
+class GroupAggregate : public RelationOperation, public AbstractAggregate {
+public:
+    GroupAggregate(Own<Operation> nested, AggregateOp fun, std::string rel, Own<Expression> expression,
+            Own<Condition> condition, std::vector<std::size_t> groupColumns, int ident)
+            : RelationOperation(rel, ident, std::move(nested)),
+              AbstractAggregate(fun, std::move(expression), std::move(condition)),
+              groupColumns(std::move(groupColumns)) {}
+
+    /** @brief Get the columns of the relation forming a group */
+    const std::vector<std::size_t>& getGroupColumns() const {
+        return groupColumns;
+    }
+
+    std::vector<const Node*> getChildNodes() const override {
+        auto res = RelationOperation::getChildNodes();
+        auto children = AbstractAggregate::getChildNodes();
+        res.insert(res.end(), children.begin(), children.end());
+        return res;
+    }
+
+    GroupAggregate* clone() const override {
+        return new GroupAggregate(souffle::clone(getOperation()), function, relation,
+                souffle::clone(expression), souffle::clone(condition), groupColumns, getTupleId());
+    }
+
+    void apply(const NodeMapper& map) override {
+        RelationOperation::apply(map);
+        condition = map(std::move(condition));
+        expression = map(std::move(expression));
+    }
+
+protected:
+    void print(std::ostream& os, int tabpos) const override {
+        os << times(" ", tabpos);
+        os << "t" << getTupleId() << ".0=";
+        AbstractAggregate::print(os, tabpos);
+        os << "FOR ALL t" << getTupleId() << " ∈ " << getRelation() << " GROUP BY (";
+        os << join(groupColumns, ", ", [&](std::ostream& out, std::size_t column) {
+            out << "t" << getTupleId() << "." << column;
+        });
+        os << ")";
+        if (!isTrue(condition.get())) {
+            os << " WHERE " << getCondition();
+        }
+        os << std::endl;
+        RelationOperation::print(os, tabpos + 1);
+    }
+
+    bool equal(const Node& node) const override {
+        const auto& other = asAssert<GroupAggregate>(node);
+        return RelationOperation::equal(other) && AbstractAggregate::equal(node) &&
+               groupColumns == other.groupColumns;
+    }
+
+    /** Columns of the relation forming a group */
+    const std::vector<std::size_t> groupColumns;
+};
+
+}  // namespace souffle::ram
@@ -0,0 +1,67 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file LogMemory.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/Node.h"
+#include "ram/Relation.h"
+#include "ram/RelationStatement.h"
+#include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/StreamUtil.h"
+#include "souffle/utility/StringUtil.h"
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace souffle::ram {
+
+/**
+ * @class LogMemory
+ * @brief Log the memory used by each index of a relation
+ *
+ * The logging message is followed by a description of the index for each
+ * index of the relation.
+ */
+class LogMemory : public RelationStatement {
+public:
+    LogMemory(std::string rel, std::string message) : RelationStatement(rel), message(std::move(message)) {}
+
+    /** @brief Get logging message */
+    const std::string& getMessage() const {
+        return message;
+    }
+
+    LogMemory* clone() const override {
+        return new LogMemory(relation, message);
+    }
+
+protected:
+    void print(std::ostream& os, int tabpos) const override {
+        os << times(" ", tabpos) << "LOGMEMORY " << relation;
+        os << " TEXT "
+           << "\"" << stringify(message) << "\"";
+        os << std::endl;
+    }
+
+    bool equal(const Node& node) const override {
+        const auto& other = asAssert<LogMemory>(node);
+        return RelationStatement::equal(other) && message == other.message;
+    }
+
+    /** Logging message */
+    const std::string message;
+};
+
+}  // namespace souffle::ram
@@ -399,6 +399,8 @@ void IndexAnalysis::run(const TranslationUnit& translationUnit) {
             relationToSearches[exists->getRelation()].insert(getSearchSignature(exists));
         } else if (const auto* provExists = as<ProvenanceExistenceCheck>(node)) {
             relationToSearches[provExists->getRelation()].insert(getSearchSignature(provExists));
+        } else if (const auto* group = as<GroupAggregate>(node)) {
+            relationToSearches[group->getRelation()].insert(getSearchSignature(group));
         } else if (const auto* ramRel = as<Relation>(node)) {
             relationToSearches[ramRel->getName()].insert(getSearchSignature(ramRel));
         }
@@ -486,6 +488,17 @@ template <typename Seq>
 SearchSignature searchSignature(std::size_t arity, Seq const& xs) {
     return searchSignature(arity, xs.begin(), xs.end());
 }
+
+/**
+ * The last attribute of a min relation is never searched: it is placed last in every index so that
+ * tuples with the same key are adjacent, and the retained minimum is replaced in place.
+ */
+SearchSignature restrictToKeys(const Relation& rel, SearchSignature keys) {
+    if (rel.getRepresentation() == RelationRepresentation::MIN && rel.getArity() > 0) {
+        keys[rel.getArity() - 1] = AttributeConstraint::None;
+    }
+    return keys;
+}
 }  // namespace
 
 SearchSignature IndexAnalysis::getSearchSignature(const IndexOperation* search) const {
@@ -506,7 +519,7 @@ SearchSignature IndexAnalysis::getSearchSignature(const IndexOperation* search)
             keys[i] = AttributeConstraint::Inequal;
         }
     }
-    return keys;
+    return restrictToKeys(*rel, keys);
 }
 
 SearchSignature IndexAnalysis::getSearchSignature(const ProvenanceExistenceCheck* provExistCheck) const {
@@ -533,11 +546,20 @@ SearchSignature IndexAnalysis::getSearchSignature(const ProvenanceExistenceCheck
 
 SearchSignature IndexAnalysis::getSearchSignature(const ExistenceCheck* existCheck) const {
     const Relation* rel = &relAnalysis->lookup(existCheck->getRelation());
-    return searchSignature(rel->getArity(), existCheck->getValues());
+    return restrictToKeys(*rel, searchSignature(rel->getArity(), existCheck->getValues()));
+}
+
+SearchSignature IndexAnalysis::getSearchSignature(const GroupAggregate* aggregate) const {
+    const Relation* rel = &relAnalysis->lookup(aggregate->getRelation());
+    SearchSignature keys(rel->getArity());
+    for (std::size_t column : aggregate->getGroupColumns()) {
+        keys[column] = AttributeConstraint::Equal;
+    }
+    return restrictToKeys(*rel, keys);
 }
 
 SearchSignature IndexAnalysis::getSearchSignature(const Relation* ramRel) const {
-    return SearchSignature::getFullSearchSignature(ramRel->getArity());
+    return restrictToKeys(*ramRel, SearchSignature::getFullSearchSignature(ramRel->getArity()));
 }
 
 bool IndexAnalysis::isTotalSignature(const AbstractExistenceCheck* existCheck) const {
@@ -18,6 +18,7 @@
 
 #include "ram/AbstractExistenceCheck.h"
 #include "ram/ExistenceCheck.h"
+#include "ram/GroupAggregate.h"
 #include "ram/IndexOperation.h"
 #include "ram/ProvenanceExistenceCheck.h"
 #include "ram/Relation.h"
@@ -512,6 +513,13 @@ public:
      */
     SearchSignature getSearchSignature(const ExistenceCheck* existCheck) const;
 
+    /**
+     * @Brief Get the index signature for a group aggregate, i.e. equalities on the group columns
+     * @param Group aggregate
+     * @result index signature of group aggregate
+     */
+    SearchSignature getSearchSignature(const GroupAggregate* aggregate) const;
+
     /**
      * @Brief Get the index signature for a provenance existence check
      * @param Provenance-existence check
@@ -26,6 +26,7 @@
 #include "ram/Expression.h"
 #include "ram/False.h"
 #include "ram/Filter.h"
+#include "ram/GroupAggregate.h"
 #include "ram/IfExists.h"
 #include "ram/IndexAggregate.h"
 #include "ram/IndexIfExists.h"
@@ -137,6 +138,11 @@ int LevelAnalysis::getLevel(const Node* node) const {
             return std::max(level, dispatch(indexAggregate.getCondition()));
         }
 
+        // group aggregate
+        int visit_(type_identity<GroupAggregate>, const GroupAggregate& aggregate) override {
+            return std::max(dispatch(aggregate.getExpression()), dispatch(aggregate.getCondition()));
+        }
+
         // unpack record
         int visit_(type_identity<UnpackRecord>, const UnpackRecord& unpack) override {
             return dispatch(unpack.getExpression());
@@ -0,0 +1,109 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file group_aggregate_test.cpp
+ *
+ * Tests the selection of aggregates evaluated per group.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "AggregateOp.h"
+#include "RelationTag.h"
+#include "ram/Expression.h"
+#include "ram/IndexAggregate.h"
+#include "ram/IndexScan.h"
+#include "ram/Insert.h"
+#include "ram/Operation.h"
+#include "ram/Program.h"
+#include "ram/Query.h"
+#include "ram/Relation.h"
+#include "ram/Scan.h"
+#include "ram/SignedConstant.h"
+#include "ram/Statement.h"
+#include "ram/TranslationUnit.h"
+#include "ram/True.h"
+#include "ram/TupleElement.h"
+#include "ram/UndefValue.h"
+#include "ram/transform/GroupAggregate.h"
+#include "reports/DebugReport.h"
+#include "reports/ErrorReport.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram::test {
+
+/**
+ * Check whether the query
+ *
+ *   FOR t0 IN keys [ON INDEX t0.0 = 3]
+ *    t1.0 = min t1.1 SEARCH t1 ∈ data ON INDEX t1.0 = t0.0
+ *     INSERT (t0.0, t1.0) INTO r
+ *
+ * is rewritten to a group aggregate.
+ */
+bool rewritten(const std::string& keys, bool indexed) {
+    VecOwn<Relation> rels;
+    for (const std::string name : {"k", "@delta_k", "@new_k"}) {
+        rels.push_back(mk<Relation>(name, 1, 0, std::vector<std::string>{"x"}, std::vector<std::string>{"i"},
+                RelationRepresentation::BTREE));
+    }
+    for (const std::string name : {"data", "r"}) {
+        rels.push_back(mk<Relation>(name, 2, 0, std::vector<std::string>{"x", "y"},
+                std::vector<std::string>{"i", "i"}, RelationRepresentation::BTREE));
+    }
+
+    VecOwn<Expression> values;
+    values.push_back(mk<TupleElement>(0, 0));
+    values.push_back(mk<TupleElement>(1, 0));
+    RamPattern range;
+    range.first.push_back(mk<TupleElement>(0, 0));
+    range.first.push_back(mk<UndefValue>());
+    range.second.push_back(mk<TupleElement>(0, 0));
+    range.second.push_back(mk<UndefValue>());
+    auto aggregate = mk<IndexAggregate>(mk<Insert>("r", std::move(values)), AggregateOp::MIN, "data",
+            mk<TupleElement>(1, 1), mk<True>(), std::move(range), 1);
+
+    Own<Operation> scan;
+    if (indexed) {
+        RamPattern key;
+        key.first.push_back(mk<SignedConstant>(3));
+        key.second.push_back(mk<SignedConstant>(3));
+        scan = mk<IndexScan>(keys, 0, std::move(key), std::move(aggregate));
+    } else {
+        scan = mk<Scan>(keys, 0, std::move(aggregate));
+    }
+
+    Own<Program> prog = mk<Program>(
+            std::move(rels), mk<Query>(std::move(scan)), std::map<std::string, Own<Statement>>());
+    ErrorReport errReport;
+    DebugReport debugReport;
+    TranslationUnit translationUnit(std::move(prog), errReport, debugReport);
+    return transform::GroupAggregateTransformer().apply(translationUnit);
+}
+
+TEST(GroupAggregate, Scan) {
+    EXPECT_TRUE(rewritten("k", false));
+}
+
+TEST(GroupAggregate, Delta) {
+    EXPECT_FALSE(rewritten("@delta_k", false));
+    EXPECT_FALSE(rewritten("@new_k", false));
+}
+
+TEST(GroupAggregate, IndexScan) {
+    EXPECT_FALSE(rewritten("k", true));
+}
+
+}  // namespace souffle::ram::test
@@ -27,6 +27,7 @@
 #include "ram/ExistenceCheck.h"
 #include "ram/Expression.h"
 #include "ram/Filter.h"
+#include "ram/GroupAggregate.h"
 #include "ram/IfExists.h"
 #include "ram/IndexAggregate.h"
 #include "ram/IndexIfExists.h"
@@ -396,6 +397,41 @@ TEST(RamIndexAggregate, CloneAndEquals) {
     delete c;
 }
 
+TEST(RamGroupAggregate, CloneAndEquals) {
+    Relation edge("edge", 2, 1, {"src", "dest"}, {"i", "i"}, RelationRepresentation::DEFAULT);
+    // t0.0 = COUNT FOR ALL t0 IN edge GROUP BY (t0.0)
+    //  RETURN (t0.1, t0.0)
+    VecOwn<Expression> a_return_args;
+    a_return_args.emplace_back(new TupleElement(0, 1));
+    a_return_args.emplace_back(new TupleElement(0, 0));
+    auto a_return = mk<SubroutineReturn>(std::move(a_return_args));
+    GroupAggregate a(std::move(a_return), AggregateOp::COUNT, "edge", mk<TupleElement>(0, 0), mk<True>(),
+            {0}, 0);
+
+    VecOwn<Expression> b_return_args;
+    b_return_args.emplace_back(new TupleElement(0, 1));
+    b_return_args.emplace_back(new TupleElement(0, 0));
+    auto b_return = mk<SubroutineReturn>(std::move(b_return_args));
+    GroupAggregate b(std::move(b_return), AggregateOp::COUNT, "edge", mk<TupleElement>(0, 0), mk<True>(),
+            {0}, 0);
+    EXPECT_EQ(a, b);
+    EXPECT_NE(&a, &b);
+
+    GroupAggregate* c = a.clone();
+    EXPECT_EQ(a, *c);
+    EXPECT_NE(&a, c);
+    delete c;
+
+    // groups of different columns are not equal
+    VecOwn<Expression> d_return_args;
+    d_return_args.emplace_back(new TupleElement(0, 1));
+    d_return_args.emplace_back(new TupleElement(0, 0));
+    auto d_return = mk<SubroutineReturn>(std::move(d_return_args));
+    GroupAggregate d(std::move(d_return), AggregateOp::COUNT, "edge", mk<TupleElement>(0, 0), mk<True>(),
+            {1}, 0);
+    EXPECT_NE(a, d);
+}
+
 TEST(RamUnpackedRecord, CloneAndEquals) {
     // UNPACK (t0.0, t0.2) INTO t1
     // RETURN number(0)
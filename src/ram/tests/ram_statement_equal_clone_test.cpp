@@ -33,6 +33,7 @@
 #include "ram/Insert.h"
 #include "ram/IntrinsicOperator.h"
 #include "ram/LogRelationTimer.h"
+#include "ram/LogMemory.h"
 #include "ram/LogSize.h"
 #include "ram/LogTimer.h"
 #include "ram/Loop.h"
@@ -434,5 +435,21 @@ TEST(LogSize, CloneAndEquals) {
     EXPECT_NE(&a, c);
     delete c;
 }
+
+TEST(LogMemory, CloneAndEquals) {
+    Relation A("A", 1, 1, {"x"}, {"i"}, RelationRepresentation::DEFAULT);
+    LogMemory a("A", "Log message");
+    LogMemory b("A", "Log message");
+    EXPECT_EQ(a, b);
+    EXPECT_NE(&a, &b);
+
+    LogMemory* c = a.clone();
+    EXPECT_EQ(a, *c);
+    EXPECT_NE(&a, c);
+    delete c;
+
+    LogMemory d("A", "Other message");
+    EXPECT_NE(a, d);
+}
 }  // end namespace test
 }  // namespace souffle::ram
@@ -0,0 +1,221 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file GroupAggregate.cpp
+ *
+ ***********************************************************************/
+
+#include "ram/transform/GroupAggregate.h"
+#include "AggregateOp.h"
+#include "RelationTag.h"
+#include "ram/Condition.h"
+#include "ram/Constraint.h"
+#include "ram/ExistenceCheck.h"
+#include "ram/Expression.h"
+#include "ram/Filter.h"
+#include "ram/GroupAggregate.h"
+#include "ram/IndexAggregate.h"
+#include "ram/IndexScan.h"
+#include "ram/Negation.h"
+#include "ram/Node.h"
+#include "ram/Operation.h"
+#include "ram/Scan.h"
+#include "ram/Sequence.h"
+#include "ram/True.h"
+#include "ram/TupleElement.h"
+#include "ram/UndefValue.h"
+#include "ram/utility/Utils.h"
+#include "ram/utility/Visitor.h"
+#include "souffle/BinaryConstraintOps.h"
+#include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/StringUtil.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram::transform {
+
+bool GroupAggregateTransformer::isGroupable(const Relation& rel) {
+    return (rel.getRepresentation() == RelationRepresentation::DEFAULT ||
+                   rel.getRepresentation() == RelationRepresentation::BTREE) &&
+           rel.getAuxiliaryArity() == 0;
+}
+
+bool GroupAggregateTransformer::isSmall(const std::string& relation) {
+    // delta and new relations of recursive strata only hold the tuples of a single iteration
+    return isPrefix("@delta_", relation) || isPrefix("@new_", relation);
+}
+
+bool GroupAggregateTransformer::isIndependent(const Expression& expression) {
+    bool independent = true;
+    visit(expression, [&](const TupleElement&) { independent = false; });
+    return independent;
+}
+
+Own<Statement> GroupAggregateTransformer::rewriteQuery(const Query& query) {
+    // the full scan of the keys must be the outer-most tuple operation, preceded by filters only;
+    // keys bound by an index are few, and a range query per key is cheaper than a full scan
+    std::vector<const Filter*> outerFilters;
+    const Operation* op = &query.getOperation();
+    while (const auto* filter = as<Filter>(op)) {
+        outerFilters.push_back(filter);
+        op = &filter->getOperation();
+    }
+    const auto* scan = as<Scan>(op);
+    if (scan == nullptr || isSmall(scan->getRelation())) {
+        return nullptr;
+    }
+
+    // the aggregate must follow the scan, possibly after filters on the scanned tuple
+    std::vector<const Filter*> innerFilters;
+    op = &scan->getOperation();
+    while (const auto* filter = as<Filter>(op)) {
+        innerFilters.push_back(filter);
+        op = &filter->getOperation();
+    }
+    const auto* aggregate = as<IndexAggregate>(op);
+    if (aggregate == nullptr) {
+        return nullptr;
+    }
+
+    const Relation& keys = relAnalysis->lookup(scan->getRelation());
+    const Relation& data = relAnalysis->lookup(aggregate->getRelation());
+    if (!isGroupable(data) || keys.getRepresentation() == RelationRepresentation::MIN ||
+            keys.getAuxiliaryArity() != 0) {
+        return nullptr;
+    }
+
+    // the aggregate may only be restricted by equalities to distinct elements of the scanned tuple;
+    // bounds independent of the scanned tuple become part of the condition of the group aggregate
+    const int scanId = scan->getTupleId();
+    const int aggregateId = aggregate->getTupleId();
+    std::vector<std::size_t> groupColumns;
+    std::vector<std::size_t> keyColumns;
+    VecOwn<Condition> conditions;
+    if (!isTrue(&aggregate->getCondition())) {
+        conditions = toConjunctionList(&aggregate->getCondition());
+    }
+    const auto lower = aggregate->getRangePattern().first;
+    const auto upper = aggregate->getRangePattern().second;
+    for (std::size_t i = 0; i < lower.size(); i++) {
+        const std::string& type = data.getAttributeTypes()[i];
+        if (const auto* element = as<TupleElement>(lower[i])) {
+            if (*lower[i] != *upper[i] || element->getTupleId() != scanId ||
+                    contains(keyColumns, element->getElement())) {
+                return nullptr;
+            }
+            groupColumns.push_back(i);
+            keyColumns.push_back(element->getElement());
+            continue;
+        }
+        if (!isUndefValue(lower[i])) {
+            if (!isIndependent(*lower[i])) {
+                return nullptr;
+            }
+            conditions.push_back(mk<Constraint>(getGreaterEqualConstraint(type),
+                    mk<TupleElement>(aggregateId, i), souffle::clone(lower[i])));
+        }
+        if (!isUndefValue(upper[i])) {
+            if (!isIndependent(*upper[i])) {
+                return nullptr;
+            }
+            conditions.push_back(mk<Constraint>(getLessEqualConstraint(type),
+                    mk<TupleElement>(aggregateId, i), souffle::clone(upper[i])));
+        }
+    }
+    if (groupColumns.empty()) {
+        return nullptr;
+    }
+
+    // the aggregate must not depend on the scanned tuple otherwise
+    bool correlated = false;
+    auto checkCorrelation = [&](const TupleElement& element) {
+        if (element.getTupleId() != aggregateId) {
+            correlated = true;
+        }
+    };
+    visit(aggregate->getExpression(), checkCorrelation);
+    visit(aggregate->getCondition(), checkCorrelation);
+    if (correlated) {
+        return nullptr;
+    }
+
+    // search the keys of each group
+    RamPattern pattern;
+    for (std::size_t i = 0; i < keys.getArity(); i++) {
+        pattern.first.push_back(mk<UndefValue>());
+        pattern.second.push_back(mk<UndefValue>());
+    }
+    for (std::size_t k = 0; k < keyColumns.size(); k++) {
+        pattern.first[keyColumns[k]] = mk<TupleElement>(aggregateId, k + 1);
+        pattern.second[keyColumns[k]] = mk<TupleElement>(aggregateId, k + 1);
+    }
+
+    auto wrap = [](const std::vector<const Filter*>& filters, Own<Operation> nested) {
+        for (auto it = filters.rbegin(); it != filters.rend(); ++it) {
+            nested = mk<Filter>(souffle::clone((*it)->getCondition()), std::move(nested),
+                    (*it)->getProfileText());
+        }
+        return nested;
+    };
+
+    auto lookup = mk<IndexScan>(scan->getRelation(), scanId, std::move(pattern),
+            wrap(innerFilters, souffle::clone(aggregate->getOperation())), scan->getProfileText());
+    Own<Operation> group = mk<GroupAggregate>(std::move(lookup), aggregate->getFunction(),
+            aggregate->getRelation(), souffle::clone(aggregate->getExpression()),
+            conditions.empty() ? mk<True>() : toCondition(conditions), groupColumns, aggregateId);
+    auto groupQuery = mk<Query>(wrap(outerFilters, std::move(group)));
+
+    // count and sum also produce a result for keys which do not occur in the aggregated relation
+    switch (aggregate->getFunction()) {
+        case AggregateOp::COUNT:
+        case AggregateOp::SUM:
+        case AggregateOp::USUM:
+        case AggregateOp::FSUM: break;
+        default: return groupQuery;
+    }
+
+    VecOwn<Expression> values;
+    for (std::size_t i = 0; i < data.getArity(); i++) {
+        values.push_back(mk<UndefValue>());
+    }
+    for (std::size_t k = 0; k < groupColumns.size(); k++) {
+        values[groupColumns[k]] = mk<TupleElement>(scanId, keyColumns[k]);
+    }
+    Own<Scan> missing(souffle::clone(scan));
+    missing->rewrite(&missing->getOperation(),
+            mk<Filter>(mk<Negation>(mk<ExistenceCheck>(aggregate->getRelation(), std::move(values))),
+                    souffle::clone(scan->getOperation())));
+    auto missingQuery = mk<Query>(wrap(outerFilters, std::move(missing)));
+
+    return mk<Sequence>(std::move(groupQuery), std::move(missingQuery));
+}
+
+bool GroupAggregateTransformer::groupAggregates(Program& program) {
+    bool changed = false;
+    std::function<Own<Node>(Own<Node>)> queryRewriter = [&](Own<Node> node) -> Own<Node> {
+        if (const auto* query = as<Query>(node)) {
+            if (Own<Statement> statement = rewriteQuery(*query)) {
+                changed = true;
+                return statement;
+            }
+            return node;
+        }
+        node->apply(makeLambdaRamMapper(queryRewriter));
+        return node;
+    };
+    program.apply(makeLambdaRamMapper(queryRewriter));
+    return changed;
+}
+
+}  // namespace souffle::ram::transform
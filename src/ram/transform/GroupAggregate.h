@@ -0,0 +1,106 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file GroupAggregate.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/Expression.h"
+#include "ram/Program.h"
+#include "ram/Query.h"
+#include "ram/Relation.h"
+#include "ram/Statement.h"
+#include "ram/TranslationUnit.h"
+#include "ram/analysis/Relation.h"
+#include "ram/transform/Transformer.h"
+#include <memory>
+#include <string>
+
+namespace souffle::ram::transform {
+
+/**
+ * @class GroupAggregateTransformer
+ * @brief Replaces correlated aggregates over the keys of a scan by a group aggregate
+ *
+ * An aggregate whose range is restricted to the key of an outer scan is
+ * evaluated with a range query for each tuple of the scanned relation.
+ * Instead, the aggregated relation is scanned once in index order and the
+ * scanned relation is searched for the key of each group.
+ *
+ * For example,
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  QUERY
+ *   FOR t0 IN keys
+ *    t1.0=min t1.2 SEARCH t1 ∈ data ON INDEX t1.1 = t0.0
+ *     INSERT (t0.0, t1.0) INTO r
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * will be rewritten to
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  QUERY
+ *   t1.0=min t1.2 FOR ALL t1 ∈ data GROUP BY (t1.1)
+ *    FOR t0 IN keys ON INDEX t0.0 = t1.1
+ *     INSERT (t0.0, t1.0) INTO r
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Count and sum produce a result for keys without any tuple in the
+ * aggregated relation as well. For these, the original query is retained
+ * for the keys that do not occur in the aggregated relation.
+ *
+ * The aggregated relation is scanned as a whole, and the scan of the keys
+ * is no longer parallel. Hence, only full scans of relations which are not
+ * delta or new relations of a recursive stratum are rewritten, and the
+ * transformation is only applied if enabled by the group-aggregates option.
+ *
+ * Tuple identifiers are not renumbered by this transformation.
+ */
+class GroupAggregateTransformer : public Transformer {
+public:
+    std::string getName() const override {
+        return "GroupAggregateTransformer";
+    }
+
+    /**
+     * @brief Rewrite a query computing a correlated aggregate
+     * @param query Query
+     * @result The statement replacing the query, or nullptr if the query cannot be rewritten
+     */
+    Own<Statement> rewriteQuery(const Query& query);
+
+    /**
+     * @brief Apply the transformation to the whole program
+     * @param RAM program
+     * @result A flag indicating whether the RAM program has been changed.
+     */
+    bool groupAggregates(Program& program);
+
+protected:
+    /** @brief Check whether a relation can be scanned in the order of the group columns */
+    static bool isGroupable(const Relation& rel);
+
+    /** @brief Check whether a relation only holds the tuples of a single iteration */
+    static bool isSmall(const std::string& relation);
+
+    /** @brief Check whether an expression is independent of all tuples */
+    static bool isIndependent(const Expression& expression);
+
+    analysis::RelationAnalysis* relAnalysis{nullptr};
+
+    bool transform(TranslationUnit& translationUnit) override {
+        relAnalysis = translationUnit.getAnalysis<analysis::RelationAnalysis>();
+        return groupAggregates(translationUnit.getProgram());
+    }
+};
+
+}  // namespace souffle::ram::transform
@@ -91,7 +91,8 @@ ExpressionPair MakeIndexTransformer::getLowerUpperExpression(
         bool interpreter = !Global::config().has("compile") && !Global::config().has("dl-program") &&
                            !Global::config().has("generate") && !Global::config().has("swig");
         bool provenance = Global::config().has("provenance");
-        bool btree = (rep == RelationRepresentation::BTREE || rep == RelationRepresentation::DEFAULT);
+        bool btree = (rep == RelationRepresentation::BTREE || rep == RelationRepresentation::DEFAULT ||
+                      rep == RelationRepresentation::MIN);
         auto op = binRelOp->getOperator();
 
         // don't index FEQ in interpreter mode
@@ -284,6 +285,12 @@ Own<Condition> MakeIndexTransformer::constructPattern(const std::vector<std::str
         std::tie(lowerExpression, upperExpression) =
                 getLowerUpperExpression(cond.get(), element, identifier, rep);
 
+        // the last attribute of a min relation is not part of any index, hence it remains a filter
+        if (rep == RelationRepresentation::MIN && element + 1 == arity) {
+            addCondition(std::move(cond));
+            continue;
+        }
+
         // we have new bounds if at least one is defined
         if (!isUndefValue(lowerExpression.get()) || !isUndefValue(upperExpression.get())) {
             // if no previous bounds are set then just assign them, consider both bounds to be set (but not
@@ -38,6 +38,7 @@
 #include "ram/False.h"
 #include "ram/Filter.h"
 #include "ram/FloatConstant.h"
+#include "ram/GroupAggregate.h"
 #include "ram/GuardedInsert.h"
 #include "ram/IO.h"
 #include "ram/IfExists.h"
@@ -48,6 +49,7 @@
 #include "ram/Insert.h"
 #include "ram/IntrinsicOperator.h"
 #include "ram/ListStatement.h"
+#include "ram/LogMemory.h"
 #include "ram/LogRelationTimer.h"
 #include "ram/LogSize.h"
 #include "ram/LogTimer.h"
@@ -157,12 +159,14 @@ struct Visitor : public souffle::Visitor<R, NodeType, Params...> {
         SOUFFLE_VISITOR_FORWARD(Aggregate);
         SOUFFLE_VISITOR_FORWARD(ParallelIndexAggregate);
         SOUFFLE_VISITOR_FORWARD(IndexAggregate);
+        SOUFFLE_VISITOR_FORWARD(GroupAggregate);
 
         // Statements
         SOUFFLE_VISITOR_FORWARD(IO);
         SOUFFLE_VISITOR_FORWARD(Query);
         SOUFFLE_VISITOR_FORWARD(Clear);
         SOUFFLE_VISITOR_FORWARD(LogSize);
+        SOUFFLE_VISITOR_FORWARD(LogMemory);
 
         SOUFFLE_VISITOR_FORWARD(Swap);
         SOUFFLE_VISITOR_FORWARD(Extend);
@@ -188,6 +192,7 @@ protected:
     SOUFFLE_VISITOR_LINK(Query, Statement);
     SOUFFLE_VISITOR_LINK(Clear, RelationStatement);
     SOUFFLE_VISITOR_LINK(LogSize, RelationStatement);
+    SOUFFLE_VISITOR_LINK(LogMemory, RelationStatement);
 
     SOUFFLE_VISITOR_LINK(RelationStatement, Statement);
 
@@ -226,6 +231,7 @@ protected:
     SOUFFLE_VISITOR_LINK(ParallelAggregate, Aggregate);
     SOUFFLE_VISITOR_LINK(IndexAggregate, IndexOperation);
     SOUFFLE_VISITOR_LINK(ParallelIndexAggregate, IndexAggregate);
+    SOUFFLE_VISITOR_LINK(GroupAggregate, RelationOperation);
     SOUFFLE_VISITOR_LINK(IndexOperation, RelationOperation);
     SOUFFLE_VISITOR_LINK(TupleOperation, NestedOperation);
     SOUFFLE_VISITOR_LINK(Filter, AbstractConditional);
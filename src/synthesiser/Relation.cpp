@@ -43,6 +43,21 @@ std::string Relation::getTypeAttributeString(const std::vector<std::string>& att
     return type.str();
 }
 
+void Relation::generateIndexMemoryUsage(std::ostream& out, const std::string& structure,
+        const std::vector<std::pair<std::string, std::string>>& additional) const {
+    out << "std::vector<std::pair<std::string, std::size_t>> getIndexMemoryUsage() const {\n";
+    out << "std::vector<std::pair<std::string, std::size_t>> res;\n";
+    for (std::size_t i = 0; i < computedIndices.size(); i++) {
+        out << "res.emplace_back(\"" << structure << computedIndices[i] << "\", ind_" << i
+            << ".getMemoryUsage());\n";
+    }
+    for (const auto& cur : additional) {
+        out << "res.emplace_back(\"" << cur.first << "\", " << cur.second << ");\n";
+    }
+    out << "return res;\n";
+    out << "}\n";
+}
+
 Own<Relation> Relation::getSynthesiserRelation(
         const ram::Relation& ramRel, const ram::analysis::IndexCluster& indexSelection, bool isProvenance) {
     Relation* rel;
@@ -52,7 +67,8 @@ Own<Relation> Relation::getSynthesiserRelation(
         rel = new DirectRelation(ramRel, indexSelection, isProvenance);
     } else if (ramRel.isNullary()) {
         rel = new NullaryRelation(ramRel, indexSelection, isProvenance);
-    } else if (ramRel.getRepresentation() == RelationRepresentation::BTREE) {
+    } else if (ramRel.getRepresentation() == RelationRepresentation::BTREE ||
+               ramRel.getRepresentation() == RelationRepresentation::MIN) {
         rel = new DirectRelation(ramRel, indexSelection, isProvenance);
     } else if (ramRel.getRepresentation() == RelationRepresentation::BRIE) {
         rel = new BrieRelation(ramRel, indexSelection, isProvenance);
@@ -152,6 +168,19 @@ void DirectRelation::computeIndices() {
             ind.push_back(getArity() - relation.getAuxiliaryArity() + 1);
             ind.push_back(getArity() - relation.getAuxiliaryArity());
             masterIndex = 0;
+        } else if (isMin()) {
+            // expand the index to be full with the retained last attribute at the end,
+            // such that the weak comparators and updaters replace it in place
+            for (std::size_t i = 0; i < getArity() - 1; i++) {
+                if (curIndexElems.find(i) == curIndexElems.end()) {
+                    ind.push_back(i);
+                }
+            }
+            if (curIndexElems.find(getArity() - 1) != curIndexElems.end()) {
+                ind.erase(std::find(ind.begin(), ind.end(), getArity() - 1));
+            }
+            ind.push_back(getArity() - 1);
+            masterIndex = 0;
         } else if (ind.size() == getArity()) {
             masterIndex = index_nr;
         }
@@ -172,7 +201,8 @@ std::string DirectRelation::getTypeName() {
     }
 
     std::stringstream res;
-    res << "t_btree_" << getTypeAttributeString(relation.getAttributeTypes(), attributesUsed);
+    res << (isMin() ? "t_btree_min_" : "t_btree_")
+        << getTypeAttributeString(relation.getAttributeTypes(), attributesUsed);
 
     for (auto& ind : getIndices()) {
         res << "__" << join(ind, "_");
@@ -210,6 +240,12 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
             out << "old_t[" << i << "] = new_t[" << i << "];\n";
         }
 
+        out << "}\n";
+        out << "};\n";
+    } else if (isMin()) {
+        out << "struct updater_" << getTypeName() << " {\n";
+        out << "void update(t_tuple& old_t, const t_tuple& new_t) {\n";
+        out << "old_t[" << arity - 1 << "] = new_t[" << arity - 1 << "];\n";
         out << "}\n";
         out << "};\n";
     }
@@ -306,6 +342,14 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
                 << ",std::allocator<t_tuple>,256,typename "
                    "souffle::detail::default_strategy<t_tuple>::type,"
                 << comparator_aux << ",updater_" << getTypeName() << ">;\n";
+        } else if (isMin()) {
+            // a single tuple per key, the key being all but the last attribute
+            std::string comparator_aux = "t_comparator_" + std::to_string(i) + "_aux";
+            genstruct(comparator_aux, ind.size() - 1);
+            out << "using t_ind_" << i << " = btree_set<t_tuple," << comparator
+                << ",std::allocator<t_tuple>,256,typename "
+                   "souffle::detail::default_strategy<t_tuple>::type,"
+                << comparator_aux << ",updater_" << getTypeName() << ">;\n";
         } else {
             if (ind.size() == arity) {
                 out << "using t_ind_" << i << " = btree_set<t_tuple," << comparator << ">;\n";
@@ -504,6 +548,9 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
     }
     out << "}\n";
 
+    // getIndexMemoryUsage method
+    generateIndexMemoryUsage(out, isProvenance ? "provenance" : (isMin() ? "min" : "btree"));
+
     // end struct
     out << "};\n";
 }  // namespace souffle
@@ -840,6 +887,9 @@ void IndirectRelation::generateTypeStruct(std::ostream& out) {
     }
     out << "}\n";
 
+    // getIndexMemoryUsage method, including the table storing the tuples
+    generateIndexMemoryUsage(out, "btree", {{"table", "dataTable.getMemoryUsage()"}});
+
     // end struct
     out << "};\n";
 }
@@ -1114,6 +1164,9 @@ void BrieRelation::generateTypeStruct(std::ostream& out) {
     }
     out << "}\n";
 
+    // getIndexMemoryUsage method
+    generateIndexMemoryUsage(out, "brie");
+
     // orderOut and orderIn methods for reordering tuples according to index orders
     for (std::size_t i = 0; i < numIndexes; i++) {
         auto ind = inds[i];
@@ -1243,6 +1296,16 @@ void EqrelRelation::generateTypeStruct(std::ostream& out) {
     out << "ind_" << masterIndex << ".extend(other.ind_" << masterIndex << ");\n";
     out << "}\n";
 
+    // class-based representation for eqrel IO
+    out << "template <typename F>\n";
+    out << "void forEachClassMember(F&& f) const {\n";
+    out << "ind_" << masterIndex << ".forEachClassMember(std::forward<F>(f));\n";
+    out << "}\n";
+
+    out << "void insertClassMember(RamDomain element, RamDomain representative) {\n";
+    out << "ind_" << masterIndex << ".insertClassMember(element, representative);\n";
+    out << "}\n";
+
     // contains methods
     out << "bool contains(const t_tuple& t) const {\n";
     out << "return ind_" << masterIndex << ".contains(t[0], t[1]);\n";
@@ -1331,6 +1394,9 @@ void EqrelRelation::generateTypeStruct(std::ostream& out) {
     out << "o << \" eqrel index: no hint statistics supported\\n\";\n";
     out << "}\n";
 
+    // getIndexMemoryUsage method
+    generateIndexMemoryUsage(out, "eqrel");
+
     // generate orderIn and orderOut methods which reorder tuples
     // according to index orders
     for (std::size_t i = 0; i < numIndexes; i++) {
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "RelationTag.h"
 #include "ram/Relation.h"
 #include "ram/analysis/Index.h"
 #include <cstddef>
@@ -17,6 +18,7 @@
 #include <set>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace souffle::synthesiser {
@@ -73,6 +75,14 @@ public:
             const ram::analysis::IndexCluster& indexSelection, bool isProvenance);
 
 protected:
+    /**
+     * Generate a method returning the memory used by each index, whose description consists of
+     * the given data structure and the lex-order of the index, followed by the given additional
+     * structures as pairs of description and expression
+     */
+    void generateIndexMemoryUsage(std::ostream& out, const std::string& structure,
+            const std::vector<std::pair<std::string, std::string>>& additional = {}) const;
+
     /** Ram relation referred to by this */
     const ram::Relation& relation;
 
@@ -126,6 +136,12 @@ public:
     void computeIndices() override;
     std::string getTypeName() override;
     void generateTypeStruct(std::ostream& out) override;
+
+private:
+    /** Whether only the least last attribute per key is retained */
+    bool isMin() const {
+        return relation.getRepresentation() == RelationRepresentation::MIN;
+    }
 };
 
 class IndirectRelation : public Relation {
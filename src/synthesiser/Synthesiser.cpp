@@ -36,6 +36,7 @@
 #include "ram/Extend.h"
 #include "ram/False.h"
 #include "ram/Filter.h"
+#include "ram/GroupAggregate.h"
 #include "ram/FloatConstant.h"
 #include "ram/IO.h"
 #include "ram/IfExists.h"
@@ -45,6 +46,7 @@
 #include "ram/Insert.h"
 #include "ram/IntrinsicOperator.h"
 #include "ram/LogRelationTimer.h"
+#include "ram/LogMemory.h"
 #include "ram/LogSize.h"
 #include "ram/LogTimer.h"
 #include "ram/Loop.h"
@@ -246,6 +248,26 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
         std::ostringstream preamble;
         bool preambleIssued = false;
 
+        /** Start a parallel region; when profiling, the work of each thread is recorded for the rule */
+        void emitParallelStart(std::ostream& out) {
+            const bool profileThreads =
+                    Global::config().has("profile") && !Global::config().has("profile-sampling");
+            if (profileThreads) {
+                out << "Logger* ruleLogger = Logger::current();\n";
+            }
+            out << "PARALLEL_START\n";
+            if (profileThreads) {
+                out << "Logger::ThreadTimer threadTimer(ruleLogger);\n";
+            }
+        }
+
+        /** Start a chunk of the loop of a parallel region */
+        void emitParallelChunk(std::ostream& out) {
+            if (Global::config().has("profile") && !Global::config().has("profile-sampling")) {
+                out << "Logger::ThreadTimer::Chunk chunk(threadTimer);\n";
+            }
+        }
+
     public:
         CodeEmitter(Synthesiser& syn) : synthesiser(syn) {
             rec = [&](auto& out, const auto* value) {
@@ -485,12 +507,27 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
         void visit_(type_identity<LogSize>, const LogSize& size, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
-            out << "ProfileEventSingleton::instance().makeQuantityEvent( R\"(";
+            if (Global::config().has("profile-sampling")) {
+                out << "ProfileSampler::instance().makeQuantityEvent( R\"(";
+            } else {
+                out << "ProfileEventSingleton::instance().makeQuantityEvent( R\"(";
+            }
             out << size.getMessage() << ")\",";
             out << synthesiser.getRelationName(synthesiser.lookup(size.getRelation())) << "->size(),iter);";
             PRINT_END_COMMENT(out);
         }
 
+        void visit_(type_identity<LogMemory>, const LogMemory& memory, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+            out << "for (const auto& cur : "
+                << synthesiser.getRelationName(synthesiser.lookup(memory.getRelation()))
+                << "->getIndexMemoryUsage()) {\n";
+            out << "ProfileEventSingleton::instance().makeQuantityEvent(R\"(" << memory.getMessage()
+                << ")\" + cur.first + \";\", cur.second, iter);\n";
+            out << "}\n";
+            PRINT_END_COMMENT(out);
+        }
+
         // -- control flow statements --
 
         void visit_(type_identity<Sequence>, const Sequence& seq, std::ostream& out) override {
@@ -596,8 +633,13 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             const auto* rel = synthesiser.lookup(timer.getRelation());
             auto relName = synthesiser.getRelationName(rel);
 
-            out << "\tLogger logger(R\"_(" << timer.getMessage() << ")_\",iter, [&](){return " << relName
-                << "->size();});\n";
+            if (Global::config().has("profile-sampling")) {
+                out << "\tProfileSampler::Scope scope(R\"_(" << timer.getMessage()
+                    << ")_\",iter, [&](){return " << relName << "->size();});\n";
+            } else {
+                out << "\tLogger logger(R\"_(" << timer.getMessage() << ")_\",iter, [&](){return " << relName
+                    << "->size();});\n";
+            }
             // insert statement to be measured
             dispatch(timer.getStatement(), out);
 
@@ -665,9 +707,10 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             PRINT_BEGIN_COMMENT(out);
 
             out << "auto part = " << relName << "->partition();\n";
-            out << "PARALLEL_START\n";
+            emitParallelStart(out);
             out << preamble.str();
             out << "pfor(auto it = part.begin(); it<part.end();++it){\n";
+            emitParallelChunk(out);
             out << "try{\n";
             out << "for(const auto& env0 : *it) {\n";
 
@@ -740,9 +783,10 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             PRINT_BEGIN_COMMENT(out);
 
             out << "auto part = " << relName << "->partition();\n";
-            out << "PARALLEL_START\n";
+            emitParallelStart(out);
             out << preamble.str();
             out << "pfor(auto it = part.begin(); it<part.end();++it){\n";
+            emitParallelChunk(out);
             out << "try{\n";
             out << "for(const auto& env0 : *it) {\n";
             out << "if( ";
@@ -814,9 +858,10 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                 << "lowerUpperRange_" << keys << "(" << rangeBounds.first.str() << ","
                 << rangeBounds.second.str() << ");\n";
             out << "auto part = range.partition();\n";
-            out << "PARALLEL_START\n";
+            emitParallelStart(out);
             out << preamble.str();
             out << "pfor(auto it = part.begin(); it<part.end(); ++it) { \n";
+            emitParallelChunk(out);
             out << "try{\n";
             out << "for(const auto& env0 : *it) {\n";
 
@@ -889,9 +934,10 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                 << "lowerUpperRange_" << keys << "(" << rangeBounds.first.str() << ","
                 << rangeBounds.second.str() << ");\n";
             out << "auto part = range.partition();\n";
-            out << "PARALLEL_START\n";
+            emitParallelStart(out);
             out << preamble.str();
             out << "pfor(auto it = part.begin(); it<part.end(); ++it) { \n";
+            emitParallelChunk(out);
             out << "try{";
             out << "for(const auto& env0 : *it) {\n";
             out << "if( ";
@@ -1043,13 +1089,19 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                 sharedVariable += ", res1";
             }
 
+            emitParallelStart(out);
+            // operation contexts are thread-local, hence the preamble is issued for each thread
             out << preamble.str();
-            out << "PARALLEL_START\n";
             // check whether there is an index to use
             if (keys.empty()) {
-                out << "#pragma omp for reduction(" << op << ":" << sharedVariable << ")\n";
-                out << "for(const auto& env" << identifier << " : "
-                    << "*" << relName << ") {\n";
+                out << "auto part = " << relName << "->partition();\n";
+                out << "#pragma omp for reduction(" << op << ":" << sharedVariable << ")"
+                    << " reduction(||:shouldRunNested)\n";
+                // iterate over each part
+                out << "for (auto it = part.begin(); it < part.end(); ++it) {\n";
+                emitParallelChunk(out);
+                // iterate over tuples in each part
+                out << "for (const auto& env" << identifier << ": *it) {\n";
             } else {
                 const auto& rangePatternLower = aggregate.getRangePattern().first;
                 const auto& rangePatternUpper = aggregate.getRangePattern().second;
@@ -1060,9 +1112,11 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                     << rangeBounds.second.str() << "," << ctxName << ");\n";
 
                 out << "auto part = range.partition();\n";
-                out << "#pragma omp for reduction(" << op << ":" << sharedVariable << ")\n";
+                out << "#pragma omp for reduction(" << op << ":" << sharedVariable << ")"
+                    << " reduction(||:shouldRunNested)\n";
                 // iterate over each part
                 out << "for (auto it = part.begin(); it < part.end(); ++it) {\n";
+                emitParallelChunk(out);
                 // iterate over tuples in each part
                 out << "for (const auto& env" << identifier << ": *it) {\n";
             }
@@ -1114,11 +1168,8 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
             // end aggregator loop
             out << "}\n";
-
-            // if keys weren't empty then there'll be another loop to close off
-            if (!keys.empty()) {
-                out << "}\n";
-            }
+            // end partition loop
+            out << "}\n";
 
             // start single-threaded section
             out << "#pragma omp single\n{\n";
@@ -1307,6 +1358,152 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             PRINT_END_COMMENT(out);
         }
 
+        void visit_(
+                type_identity<GroupAggregate>, const GroupAggregate& aggregate, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+            // get some properties
+            const auto* rel = synthesiser.lookup(aggregate.getRelation());
+            auto arity = rel->getArity();
+            auto relName = synthesiser.getRelationName(rel);
+            auto ctxName = "READ_OP_CONTEXT(" + synthesiser.getOpContextName(*rel) + ")";
+            auto identifier = aggregate.getTupleId();
+            const auto& groupColumns = aggregate.getGroupColumns();
+
+            // the nested operation sees the result followed by the group columns
+            out << "Tuple<RamDomain," << groupColumns.size() + 1 << "> env" << identifier << ";\n";
+
+            // scan the whole index, whose order starts with the group columns
+            auto keys = isa->getSearchSignature(&aggregate);
+            UndefValue undef;
+            std::vector<Expression*> unbounded(arity, &undef);
+            auto rangeBounds = getPaddedRangeBounds(*rel, unbounded, unbounded);
+            out << "auto range = " << relName << "->"
+                << "lowerUpperRange_" << keys << "(" << rangeBounds.first.str() << ","
+                << rangeBounds.second.str() << "," << ctxName << ");\n";
+
+            // the tuples of a group are adjacent
+            auto sameGroup = [&]() {
+                std::stringstream cond;
+                cond << "it != range.end()";
+                for (std::size_t i = 0; i < groupColumns.size(); i++) {
+                    cond << " && (*it)[" << groupColumns[i] << "] == env" << identifier << "[" << i + 1
+                         << "]";
+                }
+                return cond.str();
+            };
+
+            out << "for (auto it = range.begin(); it != range.end();) {\n";
+            for (std::size_t i = 0; i < groupColumns.size(); i++) {
+                out << "env" << identifier << "[" << i + 1 << "] = (*it)[" << groupColumns[i] << "];\n";
+            }
+
+            // init result
+            std::string init;
+            std::string shouldRunNested = "false";
+            switch (aggregate.getFunction()) {
+                case AggregateOp::MIN: init = "MAX_RAM_SIGNED"; break;
+                case AggregateOp::FMIN: init = "MAX_RAM_FLOAT"; break;
+                case AggregateOp::UMIN: init = "MAX_RAM_UNSIGNED"; break;
+                case AggregateOp::MAX: init = "MIN_RAM_SIGNED"; break;
+                case AggregateOp::FMAX: init = "MIN_RAM_FLOAT"; break;
+                case AggregateOp::UMAX: init = "MIN_RAM_UNSIGNED"; break;
+                case AggregateOp::MEAN: init = "0"; break;
+                case AggregateOp::COUNT:
+                case AggregateOp::FSUM:
+                case AggregateOp::USUM:
+                case AggregateOp::SUM:
+                    init = "0";
+                    shouldRunNested = "true";
+                    break;
+            }
+            out << "bool shouldRunNested = " << shouldRunNested << ";\n";
+
+            std::string type;
+            switch (getTypeAttributeAggregate(aggregate.getFunction())) {
+                case TypeAttribute::Signed: type = "RamSigned"; break;
+                case TypeAttribute::Unsigned: type = "RamUnsigned"; break;
+                case TypeAttribute::Float: type = "RamFloat"; break;
+
+                case TypeAttribute::Symbol:
+                case TypeAttribute::ADT:
+                case TypeAttribute::Record: type = "RamDomain"; break;
+            }
+            out << type << " res0 = " << init << ";\n";
+
+            if (aggregate.getFunction() == AggregateOp::MEAN) {
+                out << "RamUnsigned res1 = 0;\n";
+            }
+
+            // aggregate the tuples of the group, which shadow the environment of the nested operation
+            out << "for (; " << sameGroup() << "; ++it) {\n";
+            out << "const auto& env" << identifier << " = *it;\n";
+
+            // produce condition inside the loop
+            out << "if( ";
+            dispatch(aggregate.getCondition(), out);
+            out << ") {\n";
+
+            out << "shouldRunNested = true;\n";
+
+            // pick function
+            switch (aggregate.getFunction()) {
+                case AggregateOp::FMIN:
+                case AggregateOp::UMIN:
+                case AggregateOp::MIN:
+                    out << "res0 = std::min(res0,ramBitCast<" << type << ">(";
+                    dispatch(aggregate.getExpression(), out);
+                    out << "));\n";
+                    break;
+                case AggregateOp::FMAX:
+                case AggregateOp::UMAX:
+                case AggregateOp::MAX:
+                    out << "res0 = std::max(res0,ramBitCast<" << type << ">(";
+                    dispatch(aggregate.getExpression(), out);
+                    out << "));\n";
+                    break;
+                case AggregateOp::COUNT: out << "++res0\n;"; break;
+                case AggregateOp::FSUM:
+                case AggregateOp::USUM:
+                case AggregateOp::SUM:
+                    out << "res0 += "
+                        << "ramBitCast<" << type << ">(";
+                    dispatch(aggregate.getExpression(), out);
+                    out << ");\n";
+                    break;
+
+                case AggregateOp::MEAN:
+                    out << "res0 += "
+                        << "ramBitCast<RamFloat>(";
+                    dispatch(aggregate.getExpression(), out);
+                    out << ");\n";
+                    out << "++res1;\n";
+                    break;
+            }
+
+            out << "}\n";
+
+            // end group loop
+            out << "}\n";
+
+            if (aggregate.getFunction() == AggregateOp::MEAN) {
+                out << "if (res1 != 0) {\n";
+                out << "res0 = res0 / res1;\n";
+                out << "}\n";
+            }
+
+            // write result into environment tuple
+            out << "env" << identifier << "[0] = ramBitCast(res0);\n";
+
+            out << "if (shouldRunNested) {\n";
+            visit_(type_identity<TupleOperation>(), aggregate, out);
+            out << "}\n";
+
+            // end scan loop
+            out << "}\n";
+
+            PRINT_END_COMMENT(out);
+        }
+
         void visit_(type_identity<ParallelAggregate>, const ParallelAggregate& aggregate,
                 std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
@@ -1410,12 +1607,14 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
             // create a partitioning of the relation to iterate over simeltaneously
             out << "auto part = " << relName << "->partition();\n";
-            out << "PARALLEL_START\n";
+            emitParallelStart(out);
             out << preamble.str();
             // pragma statement
-            out << "#pragma omp for reduction(" << op << ":" << sharedVariable << ")\n";
+            out << "#pragma omp for reduction(" << op << ":" << sharedVariable << ")"
+                << " reduction(||:shouldRunNested)\n";
             // iterate over each part
             out << "for (auto it = part.begin(); it < part.end(); ++it) {\n";
+            emitParallelChunk(out);
             // iterate over tuples in each part
             out << "for (const auto& env" << identifier << ": *it) {\n";
 
@@ -2339,10 +2538,18 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
         os << "#include \"souffle/provenance/Explain.h\"\n";
     }
 
+    if (Global::config().has("server")) {
+        os << "#include \"souffle/QueryServer.h\"\n";
+    }
+
     if (Global::config().has("live-profile")) {
         os << "#include <thread>\n";
         os << "#include \"souffle/profile/Tui.h\"\n";
     }
+
+    if (Global::config().has("profile-sampling")) {
+        os << "#include \"souffle/profile/ProfileSampler.h\"\n";
+    }
     os << "\n";
     // produce external definitions for user-defined functors
     std::map<std::string, std::tuple<TypeAttribute, std::vector<TypeAttribute>, bool>> functors;
@@ -2547,6 +2754,13 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
         os << "ProfileEventSingleton::instance().setOutputFile(profiling_fname);\n";
     }
     os << registerRel.str();
+    for (auto& sub : prog.getSubroutines()) {
+        std::size_t numArgs = 0;
+        visit(*sub.second, [&](const SubroutineArgument& arg) {
+            numArgs = std::max(numArgs, arg.getArgument() + 1);
+        });
+        os << "addSubroutine(\"" << sub.first << "\", " << numArgs << ");\n";
+    }
     os << "}\n";
     // -- destructor --
 
@@ -2591,6 +2805,12 @@ void runFunction(std::string  inputDirectoryArg   = "",
     if (Global::config().has("profile")) {
         os << "ProfileEventSingleton::instance().startTimer();\n";
         os << R"_(ProfileEventSingleton::instance().makeTimeEvent("@time;starttime");)_" << '\n';
+        if (Global::config().has("profile-sampling")) {
+            os << "ProfileSampler::instance().start(" << Global::config().get("profile-sampling") << ");\n";
+        }
+        if (Global::config().has("profile-counters")) {
+            os << "HardwareCounters::instance().enable();\n";
+        }
         os << "{\n"
            << R"_(Logger logger("@runtime;", 0);)_" << '\n';
         // Store count of relations
@@ -2610,6 +2830,9 @@ void runFunction(std::string  inputDirectoryArg   = "",
 
     if (Global::config().has("profile")) {
         os << "}\n";
+        if (Global::config().has("profile-sampling")) {
+            os << "ProfileSampler::instance().stop();\n";
+        }
         os << "ProfileEventSingleton::instance().stopTimer();\n";
         os << "dumpFreqs();\n";
     }
@@ -2887,6 +3110,10 @@ void runFunction(std::string  inputDirectoryArg   = "",
     } else if (Global::config().get("provenance") == "explore") {
         os << "explain(obj, true);\n";
     }
+    if (Global::config().has("server")) {
+        os << "souffle::serveQueries(obj, R\"(" << Global::config().get("server")
+           << ")\", opt.getNumJobs());\n";
+    }
     os << "return 0;\n";
     os << "} catch(std::exception &e) { souffle::SignalHandler::instance()->error(e.what());}\n";
     os << "}\n";
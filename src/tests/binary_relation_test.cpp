@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <iostream>
 #include <random>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -524,6 +525,105 @@ TEST(EqRelTest, IterPartition) {
     EXPECT_EQ(br.size(), values.size());
 }
 
+TEST(EqRelTest, ClassMembers) {
+    EqRel br;
+    br.insert(5, 3);
+    br.insert(3, 1);
+    br.insert(7, 8);
+    br.insert(10, 10);
+
+    // each element is paired with the smallest element of its class
+    std::vector<std::pair<RamDomain, RamDomain>> members;
+    br.forEachClassMember([&](RamDomain element, RamDomain representative) {
+        members.push_back(std::make_pair(element, representative));
+    });
+    std::sort(members.begin(), members.end());
+    std::vector<std::pair<RamDomain, RamDomain>> expected = {
+            {1, 1}, {3, 1}, {5, 1}, {7, 7}, {8, 7}, {10, 10}};
+    EXPECT_EQ(expected, members);
+
+    // the members rebuild the same relation
+    EqRel restored;
+    for (const auto& member : members) {
+        restored.insertClassMember(member.first, member.second);
+    }
+    EXPECT_EQ(br.size(), restored.size());
+    for (auto x : br) {
+        EXPECT_TRUE(restored.contains(x[0], x[1]));
+    }
+}
+
+TEST(EqRelTest, CachedSize) {
+    EqRel br;
+    EXPECT_TRUE(br.empty());
+    br.insert(1, 2);
+    EXPECT_FALSE(br.empty());
+    EXPECT_EQ(4, br.size());
+    EXPECT_EQ(4, br.size());
+
+    // the cached size is invalidated by insertions, with and without an up-to-date partition
+    br.insert(2, 3);
+    EXPECT_EQ(9, br.size());
+    std::size_t count = 0;
+    for (auto x : br) {
+        ++count;
+        testutil::ignore(x);
+    }
+    EXPECT_EQ(count, br.size());
+    br.insert(4, 4);
+    EXPECT_EQ(10, br.size());
+    br.clear();
+    EXPECT_TRUE(br.empty());
+    EXPECT_EQ(0, br.size());
+}
+
+TEST(EqRelTest, IncrementalPartition) {
+    const int N = 200;
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> dist(0, N - 1);
+
+    // reference classes, as the smallest element of the class of each element
+    std::vector<int> classOf(N);
+    for (int i = 0; i < N; ++i) {
+        classOf[i] = i;
+    }
+
+    // interleave insertions with iterations, such that the partition is updated incrementally
+    EqRel br;
+    std::set<int> elements;
+    for (int round = 0; round < 50; ++round) {
+        for (int k = 0; k < 5; ++k) {
+            int x = dist(generator);
+            int y = dist(generator);
+            br.insert(x, y);
+            elements.insert(x);
+            elements.insert(y);
+            int from = std::max(classOf[x], classOf[y]);
+            int to = std::min(classOf[x], classOf[y]);
+            for (auto& c : classOf) {
+                if (c == from) {
+                    c = to;
+                }
+            }
+        }
+
+        std::size_t expected = 0;
+        for (int x : elements) {
+            for (int y : elements) {
+                expected += (classOf[x] == classOf[y]) ? 1 : 0;
+            }
+        }
+        std::size_t count = 0;
+        for (auto x : br) {
+            ++count;
+            EXPECT_EQ(classOf[x[0]], classOf[x[1]]);
+        }
+        EXPECT_EQ(expected, count);
+        EXPECT_EQ(expected, br.size());
+    }
+}
+
 TEST(EqRelTest, Scaling) {
     const int N = 100;
 
@@ -17,11 +17,22 @@
 #include "tests/test.h"
 
 #include "souffle/profile/CellInterface.h"
+#include "souffle/profile/EventBuffer.h"
+#include "souffle/profile/Logger.h"
+#include "souffle/profile/ProfileDatabase.h"
+#include "souffle/profile/ProfileEvent.h"
+#include "souffle/profile/ProfileSampler.h"
 #include "souffle/profile/StringUtils.h"
+#include "souffle/profile/TraceExporter.h"
+#include "souffle/utility/MiscUtil.h"
 #include <chrono>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iosfwd>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace souffle;
@@ -138,3 +149,272 @@ TEST(StringUtil, cleanJsonOutDouble) {
     EXPECT_EQ("NaN", Tools::cleanJsonOut(NAN));
     EXPECT_EQ("1.234567e+02", Tools::cleanJsonOut(123.4567));
 }
+
+TEST(ProfileSampler, SampledRule) {
+    const std::string sampledLabel = "@t-nonrecursive-rule;A;loc;A(x) :- B(x).;";
+    const std::string foldedLabel = "@t-nonrecursive-rule;A;loc;A(x) :- C(x).;";
+    std::size_t size = 0;
+
+    // the interval is never reached, hence only the first rule is sampled
+    ProfileSampler::instance().start(3600000000);
+    {
+        ProfileSampler::Scope scope(sampledLabel, 0, [&]() { return size; });
+        ProfileSampler::instance().sampleNow();
+        size = 42;
+    }
+    {
+        ProfileSampler::Scope scope(foldedLabel, 0, [&]() { return size; });
+        size = 50;
+    }
+    ProfileSampler::instance().stop();
+
+    const auto& db = ProfileEventSingleton::instance().getDB();
+    auto* runtime = as<DurationEntry>(db.lookupEntry(
+            {"program", "relation", "A", "non-recursive-rule", "A(x) :- B(x).", "runtime"}));
+    ASSERT_TRUE(runtime != nullptr);
+    EXPECT_TRUE(runtime->getStart() <= runtime->getEnd());
+    auto* tuples = as<SizeEntry>(db.lookupEntry(
+            {"program", "relation", "A", "non-recursive-rule", "A(x) :- B(x).", "num-tuples"}));
+    ASSERT_TRUE(tuples != nullptr);
+    EXPECT_EQ(tuples->getSize(), 42);
+
+    // folded executions are recorded with a runtime of zero
+    runtime = as<DurationEntry>(db.lookupEntry(
+            {"program", "relation", "A", "non-recursive-rule", "A(x) :- C(x).", "runtime"}));
+    ASSERT_TRUE(runtime != nullptr);
+    EXPECT_EQ(runtime->getStart().count(), runtime->getEnd().count());
+    tuples = as<SizeEntry>(db.lookupEntry(
+            {"program", "relation", "A", "non-recursive-rule", "A(x) :- C(x).", "num-tuples"}));
+    ASSERT_TRUE(tuples != nullptr);
+    EXPECT_EQ(tuples->getSize(), 8);
+}
+
+TEST(ProfileSampler, FoldedIterations) {
+    const std::string label = "@t-recursive-rule;C;0;loc;C(x) :- C(y), D(x, y).;";
+    std::size_t size = 0;
+
+    // iterations which are too short to be sampled still contribute their tuples
+    ProfileSampler::instance().start(1000000);
+    for (std::size_t iteration = 0; iteration < 100; iteration++) {
+        ProfileSampler::Scope scope(label, iteration, [&]() { return size; });
+        size += iteration;
+    }
+    ProfileSampler::instance().stop();
+
+    const auto& db = ProfileEventSingleton::instance().getDB();
+    auto* iterations = as<DirectoryEntry>(db.lookupEntry({"program", "relation", "C", "iteration"}));
+    ASSERT_TRUE(iterations != nullptr);
+    std::size_t total = 0;
+    for (const auto& iteration : iterations->getKeys()) {
+        auto* tuples = as<SizeEntry>(db.lookupEntry({"program", "relation", "C", "iteration", iteration,
+                "recursive-rule", "C(x) :- C(y), D(x, y).", "0", "num-tuples"}));
+        ASSERT_TRUE(tuples != nullptr);
+        total += tuples->getSize();
+    }
+    EXPECT_EQ(total, 4950);
+    EXPECT_LT(iterations->getKeys().size(), 100);
+}
+
+TEST(ProfileSampler, ThreadedRules) {
+    const std::string label = "@t-recursive-rule;E;0;loc;E(x) :- E(y), F(x, y).;";
+    const std::size_t numThreads = 4;
+    const std::size_t numExecutions = 10000;
+
+    // the executions of terminated threads are retained until sampling stops
+    ProfileSampler::instance().start(10);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < numThreads; t++) {
+        threads.emplace_back([&]() {
+            std::size_t size = 0;
+            for (std::size_t i = 0; i < numExecutions; i++) {
+                ProfileSampler::Scope scope(label, i % 50, [&]() { return size; });
+                size++;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ProfileSampler::instance().stop();
+
+    const auto& db = ProfileEventSingleton::instance().getDB();
+    auto* iterations = as<DirectoryEntry>(db.lookupEntry({"program", "relation", "E", "iteration"}));
+    ASSERT_TRUE(iterations != nullptr);
+    std::size_t total = 0;
+    for (const auto& iteration : iterations->getKeys()) {
+        auto* tuples = as<SizeEntry>(db.lookupEntry({"program", "relation", "E", "iteration", iteration,
+                "recursive-rule", "E(x) :- E(y), F(x, y).", "0", "num-tuples"}));
+        ASSERT_TRUE(tuples != nullptr);
+        total += tuples->getSize();
+    }
+    EXPECT_EQ(total, numThreads * numExecutions);
+}
+
+TEST(ProfileEvent, CounterEvents) {
+    auto& events = ProfileEventSingleton::instance();
+    events.makeCounterEvent("@hw-nonrecursive-rule;E;loc;E(x) :- F(x).;", 1000, 2500, 7, 11, 0);
+    events.makeCounterEvent("@hw-recursive-rule;G;1;loc;G(x) :- G(y), H(x, y).;", 300, 600, 1, 2, 4);
+
+    const auto& db = events.getDB();
+    auto* cycles = as<SizeEntry>(db.lookupEntry(
+            {"program", "relation", "E", "non-recursive-rule", "E(x) :- F(x).", "counters", "cycles"}));
+    ASSERT_TRUE(cycles != nullptr);
+    EXPECT_EQ(cycles->getSize(), 1000);
+    auto* branchMisses = as<SizeEntry>(db.lookupEntry({"program", "relation", "E", "non-recursive-rule",
+            "E(x) :- F(x).", "counters", "branch-misses"}));
+    ASSERT_TRUE(branchMisses != nullptr);
+    EXPECT_EQ(branchMisses->getSize(), 11);
+
+    auto* instructions = as<SizeEntry>(db.lookupEntry({"program", "relation", "G", "iteration", "4",
+            "recursive-rule", "G(x) :- G(y), H(x, y).", "1", "counters", "instructions"}));
+    ASSERT_TRUE(instructions != nullptr);
+    EXPECT_EQ(instructions->getSize(), 600);
+    auto* llcMisses = as<SizeEntry>(db.lookupEntry({"program", "relation", "G", "iteration", "4",
+            "recursive-rule", "G(x) :- G(y), H(x, y).", "1", "counters", "llc-misses"}));
+    ASSERT_TRUE(llcMisses != nullptr);
+    EXPECT_EQ(llcMisses->getSize(), 1);
+}
+
+TEST(EventBuffer, RecordsOfThreads) {
+    EventBuffer buffer;
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < 4; t++) {
+        threads.emplace_back([&buffer, t]() {
+            for (uint64_t i = 0; i < 5000; i++) {
+                buffer.record(EventKind::Quantity, "@event;" + std::to_string(i % 3), {t, i});
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    buffer.record(EventKind::Time, "@event;0", {});
+
+    auto records = buffer.take();
+    ASSERT_TRUE(records.size() == 20001);
+    std::vector<uint64_t> next(4, 0);
+    for (std::size_t i = 0; i < records.size(); i++) {
+        EXPECT_EQ(i, records[i].sequence);
+        if (records[i].kind == EventKind::Quantity) {
+            // the records of each thread keep their order
+            uint64_t t = records[i].values[0];
+            EXPECT_EQ(next[t]++, records[i].values[1]);
+            EXPECT_EQ("@event;" + std::to_string(records[i].values[1] % 3), buffer.getText(records[i].text));
+        }
+    }
+    EXPECT_EQ(EventKind::Time, records.back().kind);
+    EXPECT_EQ(buffer.intern("@event;0"), records.back().text);
+    EXPECT_TRUE(buffer.take().empty());
+}
+
+TEST(ProfileEvent, ParallelEvents) {
+    auto& events = ProfileEventSingleton::instance();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&events, t]() {
+            for (int i = 0; i < 2000; i++) {
+                events.makeQuantityEvent("@n-recursive-relation;P" + std::to_string(t) + ";loc;", i, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto& db = events.getDB();
+    for (int t = 0; t < 4; t++) {
+        auto* tuples = as<SizeEntry>(db.lookupEntry(
+                {"program", "relation", "P" + std::to_string(t), "iteration", "1999", "num-tuples"}));
+        ASSERT_TRUE(tuples != nullptr);
+        EXPECT_EQ(tuples->getSize(), 1999);
+        auto* iterations = as<DirectoryEntry>(
+                db.lookupEntry({"program", "relation", "P" + std::to_string(t), "iteration"}));
+        ASSERT_TRUE(iterations != nullptr);
+        EXPECT_EQ(iterations->getKeys().size(), 2000);
+    }
+}
+
+TEST(Logger, ThreadWork) {
+    {
+        Logger logger("@t-nonrecursive-rule;T;loc;T(x) :- U(x).;", 0);
+        EXPECT_TRUE(Logger::current() == &logger);
+        Logger::ThreadTimer threadTimer(Logger::current());
+        for (int i = 0; i < 2; i++) {
+            Logger::ThreadTimer::Chunk chunk(threadTimer);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    EXPECT_TRUE(Logger::current() == nullptr);
+
+    const auto& db = ProfileEventSingleton::instance().getDB();
+    auto* busy = as<SizeEntry>(db.lookupEntry(
+            {"program", "relation", "T", "non-recursive-rule", "T(x) :- U(x).", "thread", "0", "busy"}));
+    ASSERT_TRUE(busy != nullptr);
+    EXPECT_LT(19999, busy->getSize());
+    auto* runtime = as<DurationEntry>(db.lookupEntry(
+            {"program", "relation", "T", "non-recursive-rule", "T(x) :- U(x).", "thread", "0", "runtime"}));
+    ASSERT_TRUE(runtime != nullptr);
+    EXPECT_LT(busy->getSize() - 1, (runtime->getEnd() - runtime->getStart()).count());
+}
+
+TEST(TraceExporter, StreamedLog) {
+    ProfileDatabase db;
+    db.addDurationEntry({"program", "runtime"}, microseconds(0), microseconds(100));
+    db.addDurationEntry({"program", "relation", "A", "runtime"}, microseconds(10), microseconds(20));
+    db.addDurationEntry({"program", "relation", "A", "loadtime"}, microseconds(5), microseconds(9));
+    db.addSizeEntry({"program", "relation", "A", "num-tuples"}, 3);
+    db.addTextEntry({"program", "relation", "A", "source-locator"}, "a.dl [1:1-1:2]");
+    db.addDurationEntry({"program", "relation", "A", "non-recursive-rule", "A(1).", "runtime"},
+            microseconds(11), microseconds(19));
+    db.addDurationEntry({"program", "relation", "B", "iteration", "0", "runtime"}, microseconds(30),
+            microseconds(60));
+    db.addDurationEntry({"program", "relation", "B", "iteration", "0", "recursive-rule", "B(x) :- B(x).",
+                                "1", "runtime"},
+            microseconds(31), microseconds(50));
+    db.addDurationEntry({"program", "relation", "B", "iteration", "0", "recursive-rule", "B(x) :- B(x).",
+                                "1", "thread", "2", "runtime"},
+            microseconds(32), microseconds(48));
+    db.addSizeEntry({"program", "relation", "B", "iteration", "0", "recursive-rule", "B(x) :- B(x).", "1",
+                            "thread", "2", "busy"},
+            12);
+    db.addSizeEntry({"program", "usage", "timepoint", "40", "maxRSS"}, 2048);
+
+    std::stringstream exported;
+    TraceExporter(exported).exportDatabase(db);
+
+    // the log is streamed into the same trace as the database
+    std::stringstream log;
+    db.print(log);
+    std::stringstream streamed;
+    TraceExporter(streamed).exportLog(log);
+    EXPECT_EQ(exported.str(), streamed.str());
+
+    const std::string trace = streamed.str();
+    EXPECT_NE(std::string::npos, trace.find(R"_({"name": "program", "cat": "program", "ph": "X", )_"
+                                            R"_("pid": 1, "tid": 0, "ts": 0, "dur": 100})_"));
+    EXPECT_NE(std::string::npos, trace.find(R"_("name": "A", "cat": "relation", "ph": "X", "pid": 1, )_"
+                                            R"_("tid": 1, "ts": 10, "dur": 10, "args": {"tuples": "3", )_"
+                                            R"_("source": "a.dl [1:1-1:2]"})_"));
+    EXPECT_NE(std::string::npos, trace.find(R"_("name": "load A", "cat": "io")_"));
+    EXPECT_NE(std::string::npos, trace.find(R"_("name": "A(1).", "cat": "rule")_"));
+    EXPECT_NE(std::string::npos, trace.find(R"_("name": "B iteration 0", "cat": "iteration")_"));
+    EXPECT_NE(std::string::npos, trace.find(R"_("name": "B(x) :- B(x).", "cat": "rule", "ph": "X", )_"
+                                            R"_("pid": 1, "tid": 3, "ts": 31, "dur": 19)_"));
+    EXPECT_NE(std::string::npos, trace.find(R"_("name": "B(x) :- B(x).", "cat": "thread", "ph": "X", )_"
+                                            R"_("pid": 1, "tid": 7, "ts": 32, "dur": 16, )_"
+                                            R"_("args": {"relation": "B", "busy": "12"})_"));
+    EXPECT_NE(std::string::npos, trace.find(R"_("args": {"name": "thread 2"})_"));
+    EXPECT_NE(std::string::npos, trace.find(R"_("ph": "C", "pid": 1, "tid": 0, "ts": 40, )_"
+                                            R"_("args": {"maxRSS": 2048})_"));
+}
+
+TEST(TraceExporter, EscapedLog) {
+    // rules are stored escaped in the log
+    std::stringstream log(R"_({"root": {"program": {"relation": {"A": {"non-recursive-rule": {)_"
+                          R"_("A(\"x\").": {"runtime": {"start": 1, "end": 3}}}}}}}})_");
+    std::stringstream trace;
+    TraceExporter(trace).exportLog(log);
+    EXPECT_NE(std::string::npos, trace.str().find(R"_("name": "A(\"x\").", "cat": "rule", "ph": "X", )_"
+                                                  R"_("pid": 1, "tid": 3, "ts": 1, "dur": 2)_"));
+    EXPECT_EQ('}', trace.str().at(trace.str().size() - 2));
+}
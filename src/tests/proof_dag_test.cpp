@@ -0,0 +1,87 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file proof_dag_test.cpp
+ *
+ * Tests the binary format of exported proof DAGs.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/RamTypes.h"
+#include "souffle/provenance/ExplainDag.h"
+#include <cstddef>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace souffle::test {
+
+TEST(ProofDag, RoundTrip) {
+    std::stringstream stream;
+    ProofDagWriter writer(stream);
+    std::size_t edge = writer.addRelation("edge", {"s:symbol", "i:number"}, {});
+    std::size_t path = writer.addRelation("path", {"s:symbol", "i:number"},
+            {{1, "path(x,d) :- edge(x,d)."}, {2, "path(x,d+e) :- edge(x,d), path(y,e)."}});
+    EXPECT_EQ(0, edge);
+    EXPECT_EQ(1, path);
+
+    writer.addSymbol(7, "a");
+    std::size_t fact = writer.addNode(edge, 0, 0, {7, -1}, {});
+    std::size_t first = writer.addNode(path, 1, 1, {7, std::numeric_limits<RamDomain>::min()}, {fact});
+    std::size_t second = writer.addNode(path, 2, 2, {7, std::numeric_limits<RamDomain>::max()}, {fact, first});
+    writer.finish();
+    EXPECT_EQ(3, writer.getNumNodes());
+
+    ProofDag dag = ProofDagReader(stream).read();
+    EXPECT_EQ(2, dag.relations.size());
+    EXPECT_EQ("path", dag.relations[path].name);
+    EXPECT_EQ("i:number", dag.relations[path].types[1]);
+    EXPECT_EQ(2, dag.relations[path].rules.size());
+    EXPECT_EQ("path(x,d) :- edge(x,d).", dag.relations[path].rules[1]);
+    EXPECT_EQ("a", dag.symbols[7]);
+
+    // the shared fact is stored once, and referenced by both derivations
+    ASSERT_TRUE(dag.nodes.size() == 3);
+    EXPECT_EQ(-1, dag.nodes[fact].tuple[1]);
+    EXPECT_TRUE(dag.nodes[fact].children.empty());
+    EXPECT_EQ(std::numeric_limits<RamDomain>::min(), dag.nodes[first].tuple[1]);
+    EXPECT_EQ(std::numeric_limits<RamDomain>::max(), dag.nodes[second].tuple[1]);
+    EXPECT_EQ(2, dag.nodes[second].ruleNum);
+    EXPECT_EQ(2, dag.nodes[second].height);
+    EXPECT_TRUE((dag.nodes[second].children == std::vector<std::size_t>{fact, first}));
+    EXPECT_TRUE((dag.nodes[first].children == std::vector<std::size_t>{fact}));
+}
+
+TEST(ProofDag, Truncated) {
+    std::stringstream stream;
+    ProofDagWriter writer(stream);
+    std::size_t rel = writer.addRelation("r", {"i:number"}, {});
+    writer.addNode(rel, 0, 0, {300}, {});
+    writer.finish();
+    std::string data = stream.str();
+
+    // every proper prefix of the file is rejected
+    for (std::size_t length = 0; length < data.size(); ++length) {
+        std::stringstream prefix(data.substr(0, length));
+        bool rejected = false;
+        try {
+            ProofDagReader(prefix).read();
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        EXPECT_TRUE(rejected);
+    }
+}
+
+}  // namespace souffle::test
@@ -0,0 +1,87 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program for reading a relation block-wise using the OO-interface
+ *
+ ***********************************************************************/
+
+#include "souffle/SouffleInterface.h"
+#include <array>
+#include <string>
+#include <vector>
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt) {
+    std::cerr << "error: " << txt << "\n";
+    exit(1);
+}
+
+/**
+ * Main program
+ */
+int main(int /* argc */, char** /* argv */) {
+    // create an instance of program "block_iteration"
+    if (SouffleProgram* prog = ProgramFactory::newInstance("block_iteration")) {
+        // get input relation "edge"
+        if (Relation* edge = prog->getRelation("edge")) {
+            // load data into relation "edge"
+            std::vector<std::array<std::string, 2>> myData = {
+                    {"A", "B"}, {"B", "C"}, {"C", "D"}, {"D", "E"}, {"E", "F"}, {"F", "A"}};
+            for (auto input : myData) {
+                tuple t(edge);
+                t << input[0] << input[1];
+                edge->insert(t);
+            }
+
+            // run program
+            prog->run();
+
+            // get output relation "path"
+            if (Relation* path = prog->getRelation("path")) {
+                SymbolTable& symTable = path->getSymbolTable();
+                std::size_t total = 0;
+
+                // visit output relation in blocks of at most 4 tuples
+                path->forEachBlock(
+                        [&](const RamDomain* data, std::size_t rows) {
+                            if (rows == 0 || rows > 4) {
+                                error("unexpected block size");
+                            }
+                            for (std::size_t i = 0; i < rows; i++) {
+                                const RamDomain* row = data + i * path->getArity();
+                                std::cout << symTable.decode(row[0]) << "-" << symTable.decode(row[1]) << "\n";
+                            }
+                            total += rows;
+                        },
+                        4);
+
+                if (total != path->size()) {
+                    error("wrong number of tuples");
+                }
+            } else {
+                error("cannot find relation path");
+            }
+
+            // free program analysis
+            delete prog;
+
+        } else {
+            error("cannot find relation edge");
+        }
+    } else {
+        error("cannot find program block_iteration");
+    }
+}
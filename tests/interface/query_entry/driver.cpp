@@ -0,0 +1,86 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program for invoking query entry points declared with `.query`
+ *
+ ***********************************************************************/
+
+#include "souffle/SouffleInterface.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt) {
+    std::cerr << "error: " << txt << "\n";
+    exit(1);
+}
+
+/**
+ * Invoke a query entry point and print the returned tuples in order
+ */
+void query(SouffleProgram* prog, const std::string& name, RamDomain argument) {
+    std::vector<RamDomain> args = {argument};
+    std::vector<RamDomain> ret;
+    prog->executeSubroutine(name, args, ret);
+    if (ret.size() % 2 != 0) {
+        error("unexpected number of values returned by " + name);
+    }
+
+    std::vector<std::pair<RamDomain, RamDomain>> tuples;
+    for (std::size_t i = 0; i < ret.size(); i += 2) {
+        tuples.emplace_back(ret[i], ret[i + 1]);
+    }
+    std::sort(tuples.begin(), tuples.end());
+
+    std::cout << name << "(" << argument << "):";
+    for (const auto& [x, y] : tuples) {
+        std::cout << " (" << x << "," << y << ")";
+    }
+    std::cout << "\n";
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        error("fact directory is missing");
+    }
+
+    // create an instance of program "query_entry"
+    if (SouffleProgram* prog = ProgramFactory::newInstance("query_entry")) {
+        prog->loadAll(argv[1]);
+        prog->run();
+
+        // nodes reachable from a node
+        query(prog, "path_bf", 1);
+        query(prog, "path_bf", 3);
+        query(prog, "path_bf", 11);
+        query(prog, "path_bf", 4);
+
+        // nodes reaching a node
+        query(prog, "path_fb", 4);
+        query(prog, "path_fb", 12);
+
+        delete prog;
+    } else {
+        error("cannot find program query_entry");
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program answering requests of the query server, both directly
+ * and through its socket
+ *
+ ***********************************************************************/
+
+#include "souffle/QueryServer.h"
+#include "souffle/SouffleInterface.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt) {
+    std::cerr << "error: " << txt << "\n";
+    exit(1);
+}
+
+/**
+ * Print a request and its response, with tabs shown as spaces
+ */
+void print(const std::string& request, const std::string& response) {
+    std::string text = "> " + request + "\n" + response;
+    std::replace(text.begin(), text.end(), '\t', ' ');
+    std::cout << text;
+}
+
+/**
+ * Connect to the socket of a running server
+ */
+int connectTo(const std::string& socketPath) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            error("cannot create socket");
+        }
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            return fd;
+        }
+        close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    error("cannot connect to " + socketPath);
+    return -1;
+}
+
+/**
+ * Read a line from a connection
+ */
+std::string readLine(int fd) {
+    std::string line;
+    char c;
+    while (read(fd, &c, 1) == 1) {
+        line += c;
+        if (c == '\n') {
+            break;
+        }
+    }
+    return line;
+}
+
+/**
+ * Send a request through a connection and read its response
+ */
+std::string exchange(int fd, const std::string& request) {
+    const std::string line = request + "\n";
+    if (write(fd, line.data(), line.size()) != static_cast<ssize_t>(line.size())) {
+        error("cannot send request");
+    }
+    std::string response = readLine(fd);
+    if (response.rfind("ok ", 0) == 0) {
+        for (std::size_t rows = std::stoul(response.substr(3)); rows > 0; --rows) {
+            response += readLine(fd);
+        }
+    }
+    return response;
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        error("fact directory is missing");
+    }
+
+    // create an instance of program "query_server"
+    if (SouffleProgram* prog = ProgramFactory::newInstance("query_server")) {
+        prog->loadAll(argv[1]);
+        prog->run();
+
+        const std::string socketPath = "query_server.sock";
+        QueryServer server(*prog, socketPath, 2);
+
+        // requests answered directly
+        const std::size_t symbols = prog->getSymbolTable().size();
+        for (const std::string request : {"size\tpath", "query\tpath\t1\t_", "query\tlabel\t_\tnode11",
+                     "query\tlabel\t_\tnode5", "query\tpath\t1", "query\tmissing\t1",
+                     "subroutine\tpath_bf\t3", "subroutine\tpath_bf", "subroutine\tpath_bf\t3\t4",
+                     "subroutine\tmissing\t1", "size", "unknown", ""}) {
+            print(request, server.processRequest(request));
+        }
+        if (prog->getSymbolTable().size() != symbols) {
+            error("queries must not add symbols");
+        }
+
+        // requests answered through the socket
+        std::thread serving([&]() { server.run(); });
+        int fd = connectTo(socketPath);
+        for (const std::string request : {"size\tpath", "subroutine\tmissing\t1", "query\tlabel\t3\t_"}) {
+            print(request, exchange(fd, request));
+        }
+        exchange(fd, "shutdown");
+        close(fd);
+        serving.join();
+
+        delete prog;
+    } else {
+        error("cannot find program query_server");
+    }
+    return 0;
+}